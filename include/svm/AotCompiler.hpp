@@ -0,0 +1,12 @@
+#pragma once
+
+#include <svm/ByteFile.hpp>
+
+#include <ostream>
+
+namespace svm {
+	// Writes a C++ translation unit with a main function that runs the byte file in the AOT engine.
+	// The byte file is embedded in the unit and prepared again when it starts, and the instructions are compiled as Interpreter
+	// prepares them, so the unit has to be built with the same version of ShitVMCore.
+	void CompileAot(ByteFile&& byteFile, std::ostream& stream);
+}
\ No newline at end of file
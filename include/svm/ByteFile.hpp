@@ -40,9 +40,15 @@ namespace svm {
 		const Structures& GetStructures() const noexcept;
 		void SetStructures(Structures&& newStructures) noexcept;
 		const Functions& GetFunctions() const noexcept;
+		Functions& GetFunctions() noexcept;
 		void SetFunctions(Functions&& newFunctions) noexcept;
 		const Instructions& GetEntryPoint() const noexcept;
 		void SetEntryPoint(Instructions&& newEntryPoint) noexcept;
+
+		// Loads the functions that the entry point can call, and leaves the others not loaded
+		void LoadReachableFunctions() const;
+		// Loads every function, for the passes that need the whole byte file
+		void LoadFunctions() const;
 	};
 
 	std::ostream& operator<<(std::ostream& stream, const ByteFile& byteFile);
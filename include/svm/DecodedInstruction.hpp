@@ -0,0 +1,35 @@
+#pragma once
+
+#include <svm/ByteFile.hpp>
+#include <svm/Function.hpp>
+#include <svm/Instruction.hpp>
+#include <svm/Object.hpp>
+#include <svm/Verifier.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace svm {
+	union DecodedOperand {
+		std::uint64_t Target;
+		std::uint32_t Operand;
+		const svm::Function* Function;
+		const IntObject* Int;
+		const LongObject* Long;
+		const DoubleObject* Double;
+	};
+
+	struct DecodedInstruction final {
+		const void* Handler = nullptr;
+		DecodedOperand Operand = {};
+		svm::OpCode OpCode = OpCode::Nop;
+		std::int32_t Offset = 0;		// The offset of the local variable from the beginning of the stack frame, or the size of the arguments of a call
+	};
+
+	// [trap][instructions...][end]
+	using DecodedInstructions = std::vector<DecodedInstruction>;
+
+	DecodedInstructions DecodeInstructions(const ByteFile& byteFile, const Instructions& instructions);
+	void FuseInstructions(DecodedInstructions& instructions) noexcept;
+	void SpecializeInstructions(DecodedInstructions& instructions, const VerifierResult& result) noexcept;
+}
@@ -3,19 +3,25 @@
 #include <svm/Instruction.hpp>
 
 #include <cstdint>
+#include <functional>
 #include <ostream>
 #include <vector>
 
 namespace svm {
+	// Parses the instructions of a function when they are needed first
+	using InstructionsLoader = std::function<Instructions()>;
+
 	class Function final {
 	private:
 		std::uint16_t m_Arity = 0;
 		bool m_HasResult = false;
-		Instructions m_Instructions;
+		mutable Instructions m_Instructions;
+		mutable InstructionsLoader m_Loader;
 
 	public:
 		Function() noexcept = default;
 		Function(std::uint16_t arity, bool hasResult, Instructions&& instructions) noexcept;
+		Function(std::uint16_t arity, bool hasResult, InstructionsLoader&& loader) noexcept;
 		Function(Function&& function) noexcept;
 		~Function() = default;
 
@@ -29,7 +35,9 @@ namespace svm {
 		void SetArity(std::uint16_t newArity) noexcept;
 		bool HasResult() const noexcept;
 		void SetHasResult(bool newHasResult) noexcept;
-		const Instructions& GetInstructions() const noexcept;
+		bool IsLoaded() const noexcept;
+		void Load() const;
+		const Instructions& GetInstructions() const;
 		void SetInstructions(Instructions&& newInstructions) noexcept;
 	};
 
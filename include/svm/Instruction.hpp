@@ -71,8 +71,86 @@ namespace svm {
 		AGCNew,
 		ALea,
 		Count,
+		TCall,
+
+		// Internal instructions
+		JmpDirect,
+		JeDirect,
+		JneDirect,
+		JaDirect,
+		JaeDirect,
+		JbDirect,
+		JbeDirect,
+		CallDirect,
+		TCallDirect,
+		PushInt,
+		PushLong,
+		PushDouble,
+
+		AddInt,
+		AddLong,
+		AddDouble,
+		SubInt,
+		SubLong,
+		SubDouble,
+		MulInt,
+		MulLong,
+		MulDouble,
+		DivInt,
+		DivLong,
+		DivDouble,
+		CmpInt,
+		CmpLong,
+		CmpDouble,
+		ICmpInt,
+		ICmpLong,
+
+		LoadLoadAddStore,
+		LoadLoadSubStore,
+		CmpJe,
+		CmpJne,
+		CmpJa,
+		CmpJae,
+		CmpJb,
+		CmpJbe,
+		LeaInc,
+		LeaDec,
+
+		// Instructions whose checks were removed by the verifier
+		VerifiedLoadInt,
+		VerifiedLoadLong,
+		VerifiedLoadDouble,
+		VerifiedStoreInt,
+		VerifiedStoreLong,
+		VerifiedStoreDouble,
+		VerifiedLea,
+		VerifiedAddInt,
+		VerifiedAddLong,
+		VerifiedAddDouble,
+		VerifiedSubInt,
+		VerifiedSubLong,
+		VerifiedSubDouble,
+		VerifiedMulInt,
+		VerifiedMulLong,
+		VerifiedMulDouble,
+		VerifiedCmpInt,
+		VerifiedCmpLong,
+		VerifiedCmpDouble,
+		VerifiedICmpInt,
+		VerifiedICmpLong,
+		VerifiedJeInt,
+		VerifiedJneInt,
+		VerifiedJaInt,
+		VerifiedJaeInt,
+		VerifiedJbInt,
+		VerifiedJbeInt,
+		VerifiedCall,
+		VerifiedALeaInt,
+		VerifiedALeaLong,
 	};
 
+	static constexpr OpCode FirstInternalOpCode = OpCode::JmpDirect;
+
 	static constexpr const char* Mnemonics[] = {
 		"nop",
 		"push", "pop", "load", "store", "lea", "flea", "tload", "tstore", "copy", "swap",
@@ -81,7 +159,18 @@ namespace svm {
 		"cmp", "icmp", "jmp", "je", "jne", "ja", "jae", "jb", "jbe", "call", "ret",
 		"tob", "tos", "toi", "tol", "tof", "tod", "top",
 		"null", "new", "delete", "gcnull", "gcnew",
-		"apush", "anew", "agcnew", "alea", "count",
+		"apush", "anew", "agcnew", "alea", "count", "tcall",
+
+		"jmpdirect", "jedirect", "jnedirect", "jadirect", "jaedirect", "jbdirect", "jbedirect", "calldirect", "tcalldirect",
+		"pushint", "pushlong", "pushdouble",
+		"addint", "addlong", "adddouble", "subint", "sublong", "subdouble", "mulint", "mullong", "muldouble", "divint", "divlong", "divdouble",
+		"cmpint", "cmplong", "cmpdouble", "icmpint", "icmplong",
+		"loadloadaddstore", "loadloadsubstore", "cmpje", "cmpjne", "cmpja", "cmpjae", "cmpjb", "cmpjbe", "leainc", "leadec",
+		"verifiedloadint", "verifiedloadlong", "verifiedloaddouble", "verifiedstoreint", "verifiedstorelong", "verifiedstoredouble", "verifiedlea",
+		"verifiedaddint", "verifiedaddlong", "verifiedadddouble", "verifiedsubint", "verifiedsublong", "verifiedsubdouble", "verifiedmulint", "verifiedmullong", "verifiedmuldouble",
+		"verifiedcmpint", "verifiedcmplong", "verifiedcmpdouble", "verifiedicmpint", "verifiedicmplong",
+		"verifiedjeint", "verifiedjneint", "verifiedjaint", "verifiedjaeint", "verifiedjbint", "verifiedjbeint", "verifiedcall",
+		"verifiedaleaint", "verifiedalealong",
 	};
 
 	static constexpr bool HasOperand[] = {
@@ -92,7 +181,38 @@ namespace svm {
 		false/*cmp*/, false/*icmp*/, true/*jmp*/, true/*je*/, true/*jne*/, true/*ja*/, true/*jae*/, true/*jb*/, true/*jbe*/, true/*call*/, false/*ret*/,
 		false/*tob*/, false/*tos*/, false/*toi*/, false/*tol*/, false/*tof*/, false/*tod*/, false/*top*/,
 		false/*null*/, true/*new*/, false/*delete*/, false/*gcnull*/, true/*gcnew*/,
-		true/*apush*/, true/*anew*/, true/*agcnew*/, false/*alea*/, false/*count*/,
+		true/*apush*/, true/*anew*/, true/*agcnew*/, false/*alea*/, false/*count*/, true/*tcall*/,
+
+		true/*jmpdirect*/, true/*jedirect*/, true/*jnedirect*/, true/*jadirect*/, true/*jaedirect*/, true/*jbdirect*/, true/*jbedirect*/, true/*calldirect*/, true/*tcalldirect*/,
+		true/*pushint*/, true/*pushlong*/, true/*pushdouble*/,
+		false/*addint*/, false/*addlong*/, false/*adddouble*/, false/*subint*/, false/*sublong*/, false/*subdouble*/, false/*mulint*/, false/*mullong*/, false/*muldouble*/, false/*divint*/, false/*divlong*/, false/*divdouble*/,
+		false/*cmpint*/, false/*cmplong*/, false/*cmpdouble*/, false/*icmpint*/, false/*icmplong*/,
+		true/*loadloadaddstore*/, true/*loadloadsubstore*/, false/*cmpje*/, false/*cmpjne*/, false/*cmpja*/, false/*cmpjae*/, false/*cmpjb*/, false/*cmpjbe*/, true/*leainc*/, true/*leadec*/,
+		true/*verifiedloadint*/, true/*verifiedloadlong*/, true/*verifiedloaddouble*/, true/*verifiedstoreint*/, true/*verifiedstorelong*/, true/*verifiedstoredouble*/, true/*verifiedlea*/,
+		false/*verifiedaddint*/, false/*verifiedaddlong*/, false/*verifiedadddouble*/, false/*verifiedsubint*/, false/*verifiedsublong*/, false/*verifiedsubdouble*/, false/*verifiedmulint*/, false/*verifiedmullong*/, false/*verifiedmuldouble*/,
+		false/*verifiedcmpint*/, false/*verifiedcmplong*/, false/*verifiedcmpdouble*/, false/*verifiedicmpint*/, false/*verifiedicmplong*/,
+		true/*verifiedjeint*/, true/*verifiedjneint*/, true/*verifiedjaint*/, true/*verifiedjaeint*/, true/*verifiedjbint*/, true/*verifiedjbeint*/, true/*verifiedcall*/,
+		false/*verifiedaleaint*/, false/*verifiedalealong*/,
+	};
+
+	struct SuperInstruction final {
+		OpCode Fused;
+		std::uint8_t Length;
+		OpCode Sequence[4];
+	};
+
+	// Sequences are matched against decoded instructions, longer ones first
+	static constexpr SuperInstruction SuperInstructions[] = {
+		{ OpCode::LoadLoadAddStore, 4, { OpCode::Load, OpCode::Load, OpCode::Add, OpCode::Store } },
+		{ OpCode::LoadLoadSubStore, 4, { OpCode::Load, OpCode::Load, OpCode::Sub, OpCode::Store } },
+		{ OpCode::CmpJe, 2, { OpCode::Cmp, OpCode::JeDirect } },
+		{ OpCode::CmpJne, 2, { OpCode::Cmp, OpCode::JneDirect } },
+		{ OpCode::CmpJa, 2, { OpCode::Cmp, OpCode::JaDirect } },
+		{ OpCode::CmpJae, 2, { OpCode::Cmp, OpCode::JaeDirect } },
+		{ OpCode::CmpJb, 2, { OpCode::Cmp, OpCode::JbDirect } },
+		{ OpCode::CmpJbe, 2, { OpCode::Cmp, OpCode::JbeDirect } },
+		{ OpCode::LeaInc, 2, { OpCode::Lea, OpCode::Inc } },
+		{ OpCode::LeaDec, 2, { OpCode::Lea, OpCode::Dec } },
 	};
 }
 
@@ -101,12 +221,11 @@ namespace svm {
 	public:
 		svm::OpCode OpCode = OpCode::Nop;
 		std::uint32_t Operand = 0;
-		std::uint64_t Offset = 0;
 
 	public:
 		Instruction() noexcept = default;
-		Instruction(svm::OpCode opCode, std::uint64_t offset) noexcept;
-		Instruction(svm::OpCode opCode, std::uint32_t operand, std::uint64_t offset) noexcept;
+		explicit Instruction(svm::OpCode opCode) noexcept;
+		Instruction(svm::OpCode opCode, std::uint32_t operand) noexcept;
 		Instruction(const Instruction& instruction) noexcept;
 		~Instruction() = default;
 
@@ -127,10 +246,11 @@ namespace svm {
 	private:
 		std::vector<std::uint64_t> m_Labels;
 		std::vector<Instruction> m_Instructions;
+		std::vector<std::uint64_t> m_Offsets;
 
 	public:
 		Instructions() noexcept = default;
-		Instructions(std::vector<std::uint64_t> labels, std::vector<Instruction> instructions) noexcept;
+		Instructions(std::vector<std::uint64_t> labels, std::vector<Instruction> instructions);
 		Instructions(Instructions&& instructions) noexcept;
 		~Instructions() = default;
 
@@ -151,6 +271,7 @@ namespace svm {
 
 		std::uint64_t GetLabel(std::uint32_t index) const noexcept;
 		const Instruction& GetInstruction(std::uint64_t offset) const noexcept;
+		std::uint64_t GetOffset(std::uint64_t index) const noexcept;
 	};
 
 	std::ostream& operator<<(std::ostream& stream, const Instructions& instructions);
@@ -1,12 +1,16 @@
 #pragma once
 
 #include <svm/ByteFile.hpp>
+#include <svm/DecodedInstruction.hpp>
 #include <svm/Exception.hpp>
 #include <svm/Function.hpp>
 #include <svm/GarbageCollector.hpp>
 #include <svm/Heap.hpp>
 #include <svm/Instruction.hpp>
 #include <svm/Object.hpp>
+#include <svm/Optimizer.hpp>
+#include <svm/Profiler.hpp>
+#include <svm/RegisterInstruction.hpp>
 #include <svm/Stack.hpp>
 #include <svm/Type.hpp>
 
@@ -15,6 +19,7 @@
 #include <memory>
 #include <optional>
 #include <ostream>
+#include <string>
 #include <variant>
 #include <vector>
 
@@ -23,12 +28,37 @@ namespace svm {
 		svm::Type Type = NoneType;
 		std::size_t StackBegin = 0;
 		std::uint32_t VariableBegin = 0;
+		std::uint32_t ArgumentSize = 0;		// Arguments lie below the stack frame and are removed with it
 		std::uint64_t Caller = 0;
 		const svm::Function* Function = nullptr;
 		const svm::Instructions* Instructions = nullptr;
 	};
 }
 
+namespace svm {
+	enum class InterpreterEngine {
+		Switch,
+		Threaded,
+		Register,
+		Jit,
+		Aot,
+	};
+
+	enum class ExecutionTier : std::uint8_t {
+		Interpreted,
+		Register,
+		Native,
+	};
+
+	struct FunctionProfile final {
+		std::uint64_t CallCount = 0;
+		std::uint64_t BackEdgeCount = 0;
+		ExecutionTier Tier = ExecutionTier::Interpreted;
+		std::optional<RegisterCode> Code;
+		bool IsCompiled = false;
+	};
+}
+
 namespace svm {
 	namespace detail {
 		struct ArrayInfo final {
@@ -40,8 +70,13 @@ namespace svm {
 	}
 
 	class Interpreter final {
+	public:
+		using AotFunction = bool(Interpreter::*)();
+
 	private:
 		ByteFile m_ByteFile;
+		std::vector<Instructions> m_OriginalInstructions;
+		std::vector<InstructionOrigins> m_InstructionOrigins;
 		std::optional<InterpreterException> m_Exception;
 
 		Stack m_Stack;
@@ -52,9 +87,22 @@ namespace svm {
 
 		Heap m_Heap;
 
+		InterpreterEngine m_Engine = InterpreterEngine::Switch;
+		DecodedInstructions m_DecodedEntryPoint;
+		std::vector<DecodedInstructions> m_DecodedFunctions;
+		std::vector<InterpreterException> m_VerifierErrors;
+		FunctionProfile m_EntryPointProfile;
+		std::vector<FunctionProfile> m_FunctionProfiles;
+		ExecutionTier m_CurrentTier = ExecutionTier::Interpreted;
+		std::uint64_t m_RegisterThreshold = 0;
+		std::uint64_t m_NativeThreshold = 0;
+		std::vector<AotFunction> m_AotFunctions;
+
+		NGramProfiler* m_Profiler = nullptr;
+
 	public:
 		Interpreter() noexcept = default;
-		explicit Interpreter(ByteFile&& byteFile) noexcept;
+		explicit Interpreter(ByteFile&& byteFile);
 		Interpreter(Interpreter&& interpreter) noexcept;
 		~Interpreter() = default;
 
@@ -65,12 +113,29 @@ namespace svm {
 
 	public:
 		void Clear() noexcept;
-		void Load(ByteFile&& byteFile) noexcept;
+		void Load(ByteFile&& byteFile);
 		const ByteFile& GetByteFile() const noexcept;
+		const std::vector<InterpreterException>& GetVerifierErrors() const noexcept;
+		// The instructions the engines run after loading, in the order of [entry point][functions...]
+		const DecodedInstructions& GetDecodedInstructions(std::size_t index) const noexcept;
+		// Loads the byte file at path from its cache, which SaveCache wrote for the byte file whose hash is hash.
+		// Returns false and changes nothing if the cache is missing or does not match, and the byte file has to be loaded then.
+		bool LoadCache(const std::string& path, std::uint64_t hash);
+		// Saves the loaded byte file after optimizing it, next to the byte file
+		void SaveCache(std::uint64_t hash) const;
 
 		void AllocateStack(std::size_t size = 1 * 1024 * 1024);
 		void ReallocateStack(std::size_t newSize);
 		void SetGarbageCollector(std::unique_ptr<GarbageCollector>&& gc) noexcept;
+		InterpreterEngine GetEngine() const noexcept;
+		void SetEngine(InterpreterEngine newEngine) noexcept;
+		std::uint64_t GetRegisterThreshold() const noexcept;
+		void SetRegisterThreshold(std::uint64_t newRegisterThreshold) noexcept;
+		std::uint64_t GetNativeThreshold() const noexcept;
+		void SetNativeThreshold(std::uint64_t newNativeThreshold) noexcept;
+		void SetAotFunctions(std::vector<AotFunction>&& newAotFunctions) noexcept;
+		NGramProfiler* GetProfiler() const noexcept;
+		void SetProfiler(NGramProfiler* newProfiler) noexcept;
 
 		bool Interpret();
 		bool HasResult() const noexcept;
@@ -89,9 +154,38 @@ namespace svm {
 		Type* GetLocalVariable(std::uint32_t index) noexcept;
 		std::uint32_t GetLocalVariableCount() const noexcept;
 
+		// Defined by the translation units that svm-aot writes, for the entry point(0) and each function(its index plus 1).
+		// Runs the stack frame from its current instruction, and returns after a call or a return, or false if an exception occurred.
+		template<std::size_t Index>
+		bool InterpretAotFunction();
+
 	private:
 		void PrintPointerTaget(std::ostream& stream, const Object& object) const;
 
+	private: // Engine
+		bool InterpretSwitch();
+		template<bool IsProfiling>
+		bool InterpretSwitch();
+		bool InterpretThreaded();
+		bool InterpretRegister();
+		bool InterpretAot();
+		void InterpretInstruction(const Instruction& inst);
+
+		void DecodeByteFile();
+		void DecodeFunctions();
+		DecodedInstruction* GetDecodedCode() noexcept;
+		OpCode Quicken(OpCode opCode) const noexcept;
+
+		FunctionProfile& GetFunctionProfile() noexcept;
+		void PromoteFunction(FunctionProfile& profile) noexcept;
+		void RecordCall() noexcept;
+		void RecordBackEdge(std::uint64_t target) noexcept;
+
+		const RegisterCode& GetRegisterCode();
+		bool IsRegisterStateMatched(const RegisterState& state, std::size_t maxValueCount) const noexcept;
+		void MaterializeRegisterState(const RegisterExit& exit, std::uint8_t* frame);
+		bool InterpretRegisterCode(const RegisterCode& code, std::size_t entry);
+
 	private:
 		void OccurException(std::uint32_t code) noexcept;
 
@@ -121,6 +215,10 @@ namespace svm {
 
 		void InterpretAPush(std::uint32_t operand) noexcept;
 
+		void InterpretPushInt(const IntObject* constant) noexcept;
+		void InterpretPushLong(const LongObject* constant) noexcept;
+		void InterpretPushDouble(const DoubleObject* constant) noexcept;
+
 	private: // Type-cast
 		template<typename T, typename F>
 		void TypeCast(Type* typePtr) noexcept;
@@ -160,6 +258,11 @@ namespace svm {
 		bool PopTwoSameType(const Type* rhsTypePtr, T& lhs, T& rhs) noexcept;
 		template<typename T>
 		IntObject CompareTwoSameType(T lhs, T rhs) noexcept;
+		template<typename T>
+		bool GuardTwoSameType(Type type, T*& lhs, T*& rhs) noexcept;
+		bool GuardCompare(IntObject& result) noexcept;
+		template<typename F>
+		bool LoadLoadOperationStore(const DecodedInstruction* inst, F operation) noexcept;
 
 	private:
 		void InterpretAdd() noexcept;
@@ -185,9 +288,37 @@ namespace svm {
 		void InterpretCmp() noexcept;
 		void InterpretICmp() noexcept;
 
+		void InterpretAddInt() noexcept;
+		void InterpretAddLong() noexcept;
+		void InterpretAddDouble() noexcept;
+		void InterpretSubInt() noexcept;
+		void InterpretSubLong() noexcept;
+		void InterpretSubDouble() noexcept;
+		void InterpretMulInt() noexcept;
+		void InterpretMulLong() noexcept;
+		void InterpretMulDouble() noexcept;
+		void InterpretDivInt() noexcept;
+		void InterpretDivLong() noexcept;
+		void InterpretDivDouble() noexcept;
+		void InterpretCmpInt() noexcept;
+		void InterpretCmpLong() noexcept;
+		void InterpretCmpDouble() noexcept;
+		void InterpretICmpInt() noexcept;
+		void InterpretICmpLong() noexcept;
+
+		bool InterpretLoadLoadAddStore(const DecodedInstruction* inst) noexcept;
+		bool InterpretLoadLoadSubStore(const DecodedInstruction* inst) noexcept;
+		bool InterpretLeaIncDec(std::uint32_t operand, int delta) noexcept;
+
 	private: // Control
 		template<typename T>
 		void JumpCondition(std::uint32_t operand) noexcept;
+		template<typename T>
+		void JumpConditionDirect(std::uint64_t target) noexcept;
+		template<typename T>
+		void JumpIf(std::uint64_t target) noexcept;
+		template<typename T>
+		bool CompareAndJump(std::uint64_t target) noexcept;
 
 	private:
 		void InterpretJmp(std::uint32_t operand) noexcept;
@@ -199,5 +330,23 @@ namespace svm {
 		void InterpretJbe(std::uint32_t operand) noexcept;
 		void InterpretCall(std::uint32_t operand);
 		void InterpretRet() noexcept;
+		void InterpretTCall(std::uint32_t operand);
+
+		void InterpretJeDirect(std::uint64_t target) noexcept;
+		void InterpretJneDirect(std::uint64_t target) noexcept;
+		void InterpretJaDirect(std::uint64_t target) noexcept;
+		void InterpretJaeDirect(std::uint64_t target) noexcept;
+		void InterpretJbDirect(std::uint64_t target) noexcept;
+		void InterpretJbeDirect(std::uint64_t target) noexcept;
+		void InterpretCallDirect(const Function* function);
+		void InterpretTCallDirect(const Function* function);
+		void InterpretVerifiedCall(const Function* function, std::uint32_t argumentSize);
+
+		bool InterpretCmpJe(std::uint64_t target) noexcept;
+		bool InterpretCmpJne(std::uint64_t target) noexcept;
+		bool InterpretCmpJa(std::uint64_t target) noexcept;
+		bool InterpretCmpJae(std::uint64_t target) noexcept;
+		bool InterpretCmpJb(std::uint64_t target) noexcept;
+		bool InterpretCmpJbe(std::uint64_t target) noexcept;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace svm {
+	struct RegisterCode;
+
+	class JitCode final {
+	private:
+		void* m_Code = nullptr;
+		std::size_t m_Size = 0;
+		std::vector<std::uint32_t> m_Offsets;
+
+	public:
+		JitCode() noexcept = default;
+		JitCode(void* code, std::size_t size, std::vector<std::uint32_t> offsets) noexcept;
+		JitCode(JitCode&& code) noexcept;
+		~JitCode();
+
+	public:
+		JitCode& operator=(JitCode&& code) noexcept;
+		bool operator==(const JitCode&) = delete;
+		bool operator!=(const JitCode&) = delete;
+
+	public:
+		void Clear() noexcept;
+		bool IsEmpty() const noexcept;
+
+		// Runs the native code from the register instruction and returns the index of the exit it left at
+		std::uint64_t Run(std::size_t instruction, std::uint8_t* frame) const noexcept;
+	};
+
+	// Returns an empty code if native code cannot be generated on this platform
+	JitCode CompileRegisterCode(const RegisterCode& code);
+}
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #ifdef _WIN32
 #	define SVM_WINDOWS
+#elif defined(__linux__)
+#	define SVM_LINUX
 #endif
 
 #if defined(_M_IX86) || defined(__i386) || defined(_X86_) || defined(__X86__) || defined(__THW_INTEL__) || defined(__I86__) || defined(__INTEL__) || defined(__386)
@@ -27,6 +29,14 @@
 #	define SVM_CLANG
 #endif
 
+#if defined(SVM_GCC) || defined(SVM_CLANG)
+#	define SVM_COMPUTED_GOTO
+#endif
+
+#if defined(SVM_LINUX) && defined(SVM_X64) && (defined(SVM_GCC) || defined(SVM_CLANG))
+#	define SVM_JIT
+#endif
+
 #if defined(SVM_MSVC) && defined(SVM_PROFILING)
 #	define SVM_NOINLINE_FOR_PROFILING __declspec(noinline)
 #else
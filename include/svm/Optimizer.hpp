@@ -0,0 +1,44 @@
+#pragma once
+
+#include <svm/ByteFile.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace svm {
+	struct InstructionOrigin final {
+		std::size_t Function = 0;	// 0 for the entry point, or the index of the function plus 1, the same as VerifyByteFile
+		std::uint64_t Index = 0;	// The index of the instruction before inlining
+	};
+
+	// The origins of each instruction, from the function that contains it to the innermost inlined function.
+	// Empty if nothing was inlined into the function.
+	using InstructionOrigins = std::vector<std::vector<InstructionOrigin>>;
+
+	// Each pass returns true if it changed the byte file. Passes keep the results and the exceptions of the program,
+	// but instructions may move, so the call stacks of exceptions can differ. Functions that are not loaded are left as they are.
+
+	// Splices small, non-recursive functions into their callers if the callers are verified.
+	// origins gets the origins of the instructions of the entry point and the functions, the same order as VerifyByteFile.
+	bool InlineFunctions(ByteFile& byteFile, std::vector<InstructionOrigins>* origins = nullptr);
+	// Replaces calls that are followed by ret with tail calls if both functions return the same way.
+	// Calls that may see a pointer that lea made into the stack frame or the arguments are left as they are.
+	bool OptimizeTailCalls(ByteFile& byteFile);
+	// Removes instructions that no path from the first instruction reaches, and labels that no jump refers to
+	bool RemoveUnreachableCode(ByteFile& byteFile);
+	// Makes jumps to jmp go to its target directly, replaces jumps to ret with ret, and removes jumps to the next instruction
+	bool ThreadJumps(ByteFile& byteFile);
+	// Replaces operations on constants with their results, and rebuilds the constant pool with the constants in use.
+	// Every function is loaded first, since the indices of the constants change.
+	bool FoldConstants(ByteFile& byteFile);
+	// Removes values that are pushed and popped right away
+	bool RemovePushPop(ByteFile& byteFile);
+	// Removes stores of a local variable that was loaded right before
+	bool RemoveRedundantLoadStore(ByteFile& byteFile);
+	// Moves objects of gcnew that never leave their stack frame from the managed heap to the local variables that hold them
+	bool AllocateOnStack(ByteFile& byteFile);
+
+	// Loads every function, and runs all passes until none of them changes the byte file
+	void OptimizeByteFile(ByteFile& byteFile);
+}
\ No newline at end of file
@@ -5,6 +5,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -12,21 +13,28 @@
 namespace svm {
 	enum class ByteFileVersion : std::uint16_t {
 		v0_4_0 = 3,
+		v0_5_0 = 4,		// Adds the offsets of the functions, so that they can be parsed when they are needed first
 
 		Least = v0_4_0,
-		Latest = v0_4_0,
+		Latest = v0_5_0,
 	};
 
 	enum class ByteCodeVersion : std::uint16_t {
 		v0_4_0 = 3,
+		v0_5_0 = 4,		// Adds tcall
 
 		Least = v0_4_0,
-		Latest = v0_4_0,
+		Latest = v0_5_0,
 	};
 
 	class Parser final {
 	private:
-		std::vector<std::uint8_t> m_File;
+		class Buffer;
+
+	private:
+		std::shared_ptr<const Buffer> m_Buffer;
+		const std::uint8_t* m_Data = nullptr;
+		std::size_t m_Size = 0;
 		std::size_t m_Pos = 0;
 
 		ByteFile m_ByteFile;
@@ -46,13 +54,22 @@ namespace svm {
 	public:
 		void Clear() noexcept;
 		void Load(const std::string& path);
+		void Load(const std::string& path, std::vector<std::uint8_t>&& bytes);
+		bool Map(const std::string& path);
 		bool IsLoaded() const noexcept;
+		// The loaded bytes, which stay valid until the parser loads another file or is cleared
+		const std::uint8_t* GetData() const noexcept;
+		std::size_t GetSize() const noexcept;
+		// The hash of the loaded bytes, so that a file can be recognized by its contents without keeping them
+		std::uint64_t GetHash() const noexcept;
 		void Parse();
 		bool IsParsed() const noexcept;
 
 		ByteFile GetResult();
 
 	private:
+		void SetBuffer(const std::string& path, std::shared_ptr<const Buffer>&& buffer);
+
 		template<typename T>
 		T ReadFile() noexcept;
 		inline auto ReadFile(std::size_t size) noexcept;
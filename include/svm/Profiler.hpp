@@ -0,0 +1,51 @@
+#pragma once
+
+#include <svm/Instruction.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+namespace svm {
+	struct NGram final {
+		std::vector<OpCode> OpCodes;
+		std::uint64_t Count = 0;
+	};
+
+	class NGramProfiler final {
+	public:
+		static constexpr std::size_t MaxLength = 8;
+
+	private:
+		std::size_t m_Length = 0;
+		std::uint64_t m_Window = 0;
+		std::size_t m_WindowSize = 0;
+		const Instruction* m_LastInstruction = nullptr;
+
+		std::uint64_t m_TotalCount = 0;
+		std::unordered_map<std::uint64_t, std::uint64_t> m_Counts;
+
+	public:
+		NGramProfiler() noexcept = default;
+		explicit NGramProfiler(std::size_t length) noexcept;
+		NGramProfiler(NGramProfiler&& profiler) noexcept;
+		~NGramProfiler() = default;
+
+	public:
+		NGramProfiler& operator=(NGramProfiler&& profiler) noexcept;
+		bool operator==(const NGramProfiler&) = delete;
+		bool operator!=(const NGramProfiler&) = delete;
+
+	public:
+		void Clear() noexcept;
+		void Record(const Instruction& instruction);
+
+		std::size_t GetLength() const noexcept;
+		std::uint64_t GetTotalCount() const noexcept;
+		std::vector<NGram> GetMostFrequent(std::size_t count) const;
+	};
+
+	std::ostream& operator<<(std::ostream& stream, const NGram& nGram);
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <svm/ByteFile.hpp>
+#include <svm/Instruction.hpp>
+#include <svm/JitCompiler.hpp>
+#include <svm/Type.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace svm {
+	enum class RegisterOpCode : std::uint8_t {
+		Exit,
+
+		Const,
+		Move,
+		MoveObject,
+
+		AddInt,
+		AddLong,
+		AddDouble,
+		SubInt,
+		SubLong,
+		SubDouble,
+		MulInt,
+		MulLong,
+		MulDouble,
+		IMulInt,
+		IMulLong,
+		DivInt,
+		DivLong,
+		DivDouble,
+		IDivInt,
+		IDivLong,
+		ModInt,
+		ModLong,
+		ModDouble,
+		IModInt,
+		IModLong,
+		NegInt,
+		NegLong,
+		NegDouble,
+		IncInt,
+		IncLong,
+		IncDouble,
+		DecInt,
+		DecLong,
+		DecDouble,
+
+		AndInt,
+		AndLong,
+		OrInt,
+		OrLong,
+		XorInt,
+		XorLong,
+		NotInt,
+		NotLong,
+		ShlInt,
+		ShlLong,
+		ShrInt,
+		ShrLong,
+		SarInt,
+		SarLong,
+
+		CmpInt,
+		CmpLong,
+		CmpDouble,
+		ICmpInt,
+		ICmpLong,
+
+		IntToLong,
+		IntToDouble,
+		LongToInt,
+		LongToDouble,
+		DoubleToInt,
+		DoubleToLong,
+
+		Jmp,
+		JeInt,
+		JeLong,
+		JeDouble,
+		JneInt,
+		JneLong,
+		JneDouble,
+		JaInt,
+		JaLong,
+		JaDouble,
+		JaeInt,
+		JaeLong,
+		JaeDouble,
+		JbInt,
+		JbLong,
+		JbDouble,
+		JbeInt,
+		JbeLong,
+		JbeDouble,
+	};
+
+	// Operands are byte displacements of values from the frame address.
+	// The frame address points to the first byte above the StackFrame of the function.
+	// Jumps keep their targets in Immediate, and backward jumps keep the exits that leave at their targets in Right.
+	struct RegisterInstruction final {
+		RegisterOpCode OpCode = RegisterOpCode::Exit;
+		std::int32_t Destination = 0;
+		std::int32_t Left = 0;
+		std::int32_t Right = 0;
+		std::uint64_t Immediate = 0;
+	};
+
+	struct RegisterValue final {
+		svm::Type Type = NoneType;		// NoneType if the type is known only at run time
+		std::int32_t Source = 0;
+		bool IsLocalVariable = false;
+	};
+
+	struct RegisterState final {
+		std::vector<RegisterValue> Values;
+		std::vector<RegisterValue> LocalVariables;
+	};
+
+	struct RegisterEntry final {
+		std::size_t Instruction = 0;
+		RegisterState State;
+	};
+
+	struct RegisterExit final {
+		std::uint64_t Instruction = 0;
+		RegisterState State;
+	};
+
+	struct RegisterCode final {
+		static constexpr std::uint32_t NoEntry = static_cast<std::uint32_t>(-1);
+
+		std::vector<RegisterInstruction> Instructions;
+		std::vector<RegisterEntry> Entries;
+		std::vector<RegisterExit> Exits;
+		std::vector<std::uint32_t> EntryIndices;
+		std::size_t MaxValueCount = 0;
+
+		JitCode Native;			// Empty unless the code is compiled to native code
+	};
+
+	std::int32_t GetValueSlot(std::size_t index) noexcept;
+	std::int32_t GetArgumentSlot(std::size_t index) noexcept;
+	std::size_t GetFrameOffset(std::size_t stackBegin, std::int32_t slot) noexcept;
+
+	RegisterCode TranslateInstructions(const ByteFile& byteFile, const Instructions& instructions, const std::vector<Type>& argumentTypes);
+	// Moves instructions whose operands do not change in loops out of the loops, and replaces instructions
+	// that compute a value that is already in another slot with moves. Slots are added for the moved instructions.
+	void OptimizeRegisterCode(RegisterCode& code);
+}
\ No newline at end of file
@@ -1,7 +1,5 @@
 #pragma once
 
-#include <svm/detail/ReferenceWrapper.hpp>
-
 #include <cstddef>
 #include <cstdint>
 #include <string>
@@ -46,15 +44,80 @@ namespace svm {
 	class StructureInfo;
 	class Structures;
 
-	class Type final : public detail::ReferenceWrapper<TypeInfo> {
+	enum class TypeTag : std::uint8_t {
+		None,
+		Int,
+		Long,
+		Double,
+		Pointer,
+		GCPointer,
+		Array,
+		Structure,
+	};
+
+	// TypeInfo is aligned to at least 8 bytes, so the lowest 3 bits of the pointer carry the TypeTag.
+	// Type tests can be done by comparing tags without dereferencing the pointer.
+	class Type final {
+	public:
+		static constexpr std::uintptr_t TagMask = 0b111;
+
+	private:
+		std::uintptr_t m_Data = 0;
+
 	public:
-		using detail::ReferenceWrapper<TypeInfo>::ReferenceWrapper;
+		Type() noexcept = default;
+		Type(std::nullptr_t) noexcept {}
+		Type(const TypeInfo& data) noexcept;
+		Type(const Type& type) noexcept
+			: m_Data(type.m_Data) {}
+		~Type() = default;
 
 	public:
-		bool IsFundamentalType() const noexcept;
-		bool IsArray() const noexcept;
-		bool IsStructure() const noexcept;
-		bool IsValidType() const noexcept;
+		Type& operator=(const Type& type) noexcept {
+			m_Data = type.m_Data;
+			return *this;
+		}
+		bool operator==(const Type& type) const noexcept {
+			return m_Data == type.m_Data;
+		}
+		bool operator!=(const Type& type) const noexcept {
+			return m_Data != type.m_Data;
+		}
+		const TypeInfo& operator*() const noexcept {
+			return *GetPointer();
+		}
+		const TypeInfo* operator->() const noexcept {
+			return GetPointer();
+		}
+
+	public:
+		bool IsEmpty() const noexcept {
+			return m_Data == 0;
+		}
+		const TypeInfo& GetReference() const noexcept {
+			return *GetPointer();
+		}
+		const TypeInfo* GetPointer() const noexcept {
+			return reinterpret_cast<const TypeInfo*>(m_Data & ~TagMask);
+		}
+		TypeTag GetTag() const noexcept {
+			return static_cast<TypeTag>(m_Data & TagMask);
+		}
+
+		bool IsFundamentalType() const noexcept {
+			const TypeTag tag = GetTag();
+
+			return tag != TypeTag::None && tag < TypeTag::Array;
+		}
+		bool IsArray() const noexcept {
+			return GetTag() == TypeTag::Array;
+		}
+		bool IsStructure() const noexcept {
+			return GetTag() == TypeTag::Structure;
+		}
+		bool IsValidType() const noexcept {
+			return GetTag() != TypeTag::None;
+		}
 	};
 
 	extern const Type NoneType;
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <svm/ByteFile.hpp>
+#include <svm/Exception.hpp>
+#include <svm/Function.hpp>
+#include <svm/Instruction.hpp>
+#include <svm/Type.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace svm {
+	struct VerifierResult final {
+		// False if the verifier could not follow the instructions. Nothing is proven then.
+		bool IsVerified = false;
+
+		// The type of the operands of each instruction, or NoneType if its checks have to stay.
+		// alea has the type of its index only if the index is known to be less than the count of the array.
+		std::vector<Type> OperandTypes;
+
+		// The offset of the local variable that each instruction refers to from the beginning of its stack frame.
+		// Arguments lie below the stack frame, so their offsets are negative. 0 if the offset is not the same on every path.
+		std::vector<std::ptrdiff_t> LocalVariableOffsets;
+
+		// The types of the arguments of each call in the order of their indices, or empty if the call is not reachable
+		std::vector<std::vector<Type>> ArgumentTypes;
+
+		// The index of the gcnew that each gcnew or load refers to the object of, if the object never leaves the local variable
+		// that takes its pointer right after gcnew. The local variable can hold the object itself then. -1 for the others.
+		std::vector<std::uint64_t> LocalAllocations;
+
+		// Whether each call may see a pointer that lea made into the stack frame or the arguments, so that it cannot be a tail call.
+		// True for the calls that are not reachable.
+		std::vector<bool> IsFrameVisible;
+
+		// Reachable instructions that always raise an exception
+		std::vector<InterpreterException> Errors;
+	};
+
+	VerifierResult VerifyInstructions(const ByteFile& byteFile, const Function* function, const std::vector<Type>& argumentTypes = {});
+	// [entry point][functions...]
+	std::vector<VerifierResult> VerifyByteFile(const ByteFile& byteFile);
+}
\ No newline at end of file
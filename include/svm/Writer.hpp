@@ -0,0 +1,50 @@
+#pragma once
+
+#include <svm/ByteFile.hpp>
+#include <svm/Parser.hpp>
+#include <svm/Structure.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace svm {
+	class Writer final {
+	private:
+		std::vector<std::uint8_t> m_File;
+
+	public:
+		Writer() noexcept = default;
+		Writer(Writer&& writer) noexcept;
+		~Writer() = default;
+
+	public:
+		Writer& operator=(Writer&& writer) noexcept;
+		bool operator==(const Writer&) = delete;
+		bool operator!=(const Writer&) = delete;
+
+	public:
+		void Clear() noexcept;
+		void Write(const ByteFile& byteFile);
+		bool IsWritten() const noexcept;
+		void Save(const std::string& path) const;
+
+		const std::vector<std::uint8_t>& GetResult() const noexcept;
+
+	private:
+		template<typename T>
+		void WriteFile(T value);
+		template<typename T>
+		void WriteFile(std::size_t pos, T value) noexcept;
+
+		void WriteConstantPool(const ConstantPool& constantPool);
+		template<typename T>
+		void WriteConstants(const std::vector<T>& pool);
+		void WriteStructures(const Structures& structures);
+		void WriteFunctions(const Functions& functions, const Instructions& entryPoint);
+		void WriteInstructions(const Instructions& instructions);
+	};
+}
+
+#include "detail/impl/Writer.hpp"
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <svm/Memory.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace svm::detail {
+	// FNV-1a over words instead of bytes, rotated so that the upper bits of each word reach the lower bits as well
+	inline std::uint64_t HashBytes(const std::uint8_t* data, std::size_t size) noexcept {
+		static constexpr std::uint64_t prime = 1099511628211ull;
+		std::uint64_t hash = 14695981039346656037ull;
+
+		std::size_t i = 0;
+		for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+			std::uint64_t word;
+			std::memcpy(&word, data + i, sizeof(word));
+			if (GetEndian() != Endian::Little) {
+				word = ReverseEndian(word);
+			}
+
+			hash = (hash ^ word) * prime;
+			hash = hash << 29 | hash >> 35;
+		}
+		for (; i < size; ++i) {
+			hash = (hash ^ data[i]) * prime;
+		}
+		return (hash ^ size) * prime;
+	}
+}
\ No newline at end of file
@@ -17,6 +17,7 @@
 
 #define SVM_IEC_FUNCTION_OUTOFRANGE				0x00000009
 #define SVM_IEC_FUNCTION_NORETINSTRUCTION		0x0000000A
+#define SVM_IEC_FUNCTION_DIFFERENTRESULT		0x00000017
 
 #define SVM_IEC_POINTER_NULLPOINTER				0x0000000B
 #define SVM_IEC_POINTER_NOTPOINTER				0x0000000C
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace svm::detail {
+	// Calls function(i) once for each i in [0, count), on up to as many threads as the hardware has.
+	// Each thread takes at least MinCountPerThread indices, so that small inputs do not pay for threads.
+	// If calls throw, the exception of the smallest index is thrown again after every thread finished.
+	template<std::size_t MinCountPerThread = 16, typename F>
+	void ParallelFor(std::size_t count, F&& function) {
+		const std::size_t hardwareCount = std::max(std::thread::hardware_concurrency(), 1u);
+		const std::size_t threadCount = std::min(hardwareCount, (count + MinCountPerThread - 1) / MinCountPerThread);
+		if (threadCount <= 1) {
+			for (std::size_t i = 0; i < count; ++i) {
+				function(i);
+			}
+			return;
+		}
+
+		std::atomic<std::size_t> next = 0;
+		std::mutex mutex;
+		std::exception_ptr exception;
+		std::size_t exceptionIndex = count;
+
+		const auto work = [&]() noexcept {
+			for (std::size_t i = next++; i < count; i = next++) {
+				try {
+					function(i);
+				} catch (...) {
+					const std::lock_guard lock(mutex);
+					if (i < exceptionIndex) {
+						exception = std::current_exception();
+						exceptionIndex = i;
+					}
+				}
+			}
+		};
+
+		std::vector<std::thread> threads;
+		threads.reserve(threadCount - 1);
+		for (std::size_t i = 1; i < threadCount; ++i) {
+			try {
+				threads.emplace_back(work);
+			} catch (const std::system_error&) {
+				break;
+			}
+		}
+
+		work();
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+
+		if (exception) {
+			std::rethrow_exception(exception);
+		}
+	}
+}
\ No newline at end of file
@@ -10,15 +10,15 @@
 namespace svm {
 	template<typename T>
 	T Parser::ReadFile() noexcept {
-		T result = reinterpret_cast<T&>(m_File[m_Pos]);
+		T result = reinterpret_cast<const T&>(m_Data[m_Pos]);
 		m_Pos += sizeof(T);
 
 		if (sizeof(T) > 1 && GetEndian() != Endian::Little) return ReverseEndian(result);
 		else return result;
 	}
 	inline auto Parser::ReadFile(std::size_t size) noexcept {
-		const auto begin = m_File.begin() + m_Pos;
-		const auto end = m_File.begin() + m_Pos + size;
+		const auto begin = m_Data + m_Pos;
+		const auto end = m_Data + m_Pos + size;
 		m_Pos += size;
 		return std::make_pair(begin, end);
 	}
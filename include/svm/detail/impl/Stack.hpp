@@ -40,4 +40,34 @@ namespace svm {
 	T* Stack::GetTop() noexcept {
 		return Get<T>(m_Used);
 	}
+
+	inline const Type* Stack::GetTopType() const noexcept {
+		return GetTop<Type>();
+	}
+	inline Type* Stack::GetTopType() noexcept {
+		return GetTop<Type>();
+	}
+
+	inline std::size_t Stack::GetSize() const noexcept {
+		return m_Data.size();
+	}
+	inline std::size_t Stack::GetUsedSize() const noexcept {
+		return m_Used;
+	}
+	inline void Stack::SetUsedSize(std::size_t newUsedSize) noexcept {
+		m_Used = newUsedSize;
+	}
+	inline std::size_t Stack::GetFreeSize() const noexcept {
+		return GetSize() - GetUsedSize();
+	}
+
+	inline bool Stack::Expand(std::size_t delta) noexcept {
+		if (GetFreeSize() < delta) return false;
+
+		m_Used += delta;
+		return true;
+	}
+	inline void Stack::Reduce(std::size_t delta) noexcept {
+		m_Used -= delta;
+	}
 }
\ No newline at end of file
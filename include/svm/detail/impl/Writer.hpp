@@ -0,0 +1,38 @@
+#pragma once
+#include <svm/Writer.hpp>
+
+#include <svm/Memory.hpp>
+#include <svm/Object.hpp>
+
+#include <cstring>
+#include <type_traits>
+
+namespace svm {
+	template<typename T>
+	void Writer::WriteFile(T value) {
+		if (sizeof(T) > 1 && GetEndian() != Endian::Little) {
+			value = ReverseEndian(value);
+		}
+
+		const std::size_t pos = m_File.size();
+		m_File.resize(pos + sizeof(T));
+		std::memcpy(m_File.data() + pos, &value, sizeof(T));
+	}
+	template<typename T>
+	void Writer::WriteFile(std::size_t pos, T value) noexcept {
+		if (sizeof(T) > 1 && GetEndian() != Endian::Little) {
+			value = ReverseEndian(value);
+		}
+
+		std::memcpy(m_File.data() + pos, &value, sizeof(T));
+	}
+
+	template<typename T>
+	void Writer::WriteConstants(const std::vector<T>& pool) {
+		static_assert(std::is_base_of_v<Object, T>);
+		WriteFile(static_cast<std::uint32_t>(pool.size()));
+		for (const T& obj : pool) {
+			WriteFile(obj.Value);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,577 @@
+#include <svm/AotCompiler.hpp>
+
+#include <svm/DecodedInstruction.hpp>
+#include <svm/Function.hpp>
+#include <svm/Instruction.hpp>
+#include <svm/Interpreter.hpp>
+#include <svm/Parser.hpp>
+#include <svm/Writer.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ios>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+	using namespace svm;
+
+	constexpr std::string_view Prelude = R"(#include <svm/Interpreter.hpp>
+#include <svm/Parser.hpp>
+#include <svm/detail/InterpreterExceptionCode.hpp>
+#include <svm/gc/SimpleGarbageCollector.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace {
+	template<typename T>
+	[[maybe_unused]] std::uint32_t Compare(T lhs, T rhs) noexcept {
+		if (lhs > rhs) return 1;
+		else if (lhs == rhs) return 0;
+		else return static_cast<std::uint32_t>(-1);
+	}
+	[[maybe_unused]] double ToDouble(std::uint64_t bits) noexcept {
+		double value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+}
+
+// Instructions that can raise an exception record their index first, as the engines do
+#define SVM_CALL(index, handler)														\
+	m_StackFrame.Caller = index;														\
+	handler;																			\
+	if (m_Exception.has_value()) return false
+
+#define SVM_PUSH(index, t, type, value)													\
+	if (!m_Stack.Expand(sizeof(t))) {													\
+		m_StackFrame.Caller = index;													\
+		OccurException(SVM_IEC_STACK_OVERFLOW);											\
+		return false;																	\
+	}																					\
+	*m_Stack.GetTopType() = type;														\
+	m_Stack.GetTop<t>()->Value = value
+
+#define SVM_LOCAL_VARIABLE(t, offset) m_Stack.Get<t>(m_StackFrame.StackBegin + (offset))
+
+#define SVM_VERIFIED_STORE(t, offset)													\
+	SVM_LOCAL_VARIABLE(t, offset)->Value = m_Stack.GetTop<t>()->Value;					\
+	m_Stack.Reduce(sizeof(t))
+
+#define SVM_VERIFIED_OPERATION(t, o)													\
+	{																					\
+		const auto rhs = m_Stack.GetTop<t>()->Value;									\
+		m_Stack.Reduce(sizeof(t));														\
+		t* const lhs = m_Stack.GetTop<t>();												\
+		lhs->Value = static_cast<decltype(t::Value)>(lhs->Value o rhs);					\
+	}
+
+#define SVM_VERIFIED_COMPARE(t, v)														\
+	{																					\
+		const v rhs = static_cast<v>(m_Stack.GetTop<t>()->Value);						\
+		m_Stack.Reduce(sizeof(t));														\
+		const v lhs = static_cast<v>(m_Stack.GetTop<t>()->Value);						\
+		*m_Stack.GetTopType() = IntType;												\
+		m_Stack.GetTop<IntObject>()->Value = Compare(lhs, rhs);							\
+	}
+
+#define SVM_VERIFIED_JUMP(o, v, target)													\
+	if (m_Stack.GetTop<IntObject>()->Value o static_cast<std::uint32_t>(v)) {			\
+		m_Stack.Reduce(sizeof(IntObject));												\
+		goto target;																	\
+	}
+
+#define SVM_VERIFIED_ALEA(t)															\
+	{																					\
+		const std::uint64_t index = m_Stack.GetTop<t>()->Value;							\
+		m_Stack.Reduce(sizeof(t));														\
+		PointerObject* const pointer = m_Stack.GetTop<PointerObject>();					\
+		Type* const elementType = reinterpret_cast<Type*>(static_cast<ArrayObject*>(pointer->Value) + 1);	\
+		pointer->Value = reinterpret_cast<std::uint8_t*>(elementType) + index * elementType->GetReference().Size;	\
+	}
+)";
+
+	void WriteStringLiteral(std::ostream& stream, std::string_view string) {
+		stream << '"';
+		for (const char c : string) {
+			if (c == '"' || c == '\\') {
+				stream << '\\' << c;
+			} else {
+				stream << c;
+			}
+		}
+		stream << '"';
+	}
+
+	const char* GetHandlerName(OpCode opCode) noexcept {
+		switch (opCode) {
+		case OpCode::Pop: return "InterpretPop";
+		case OpCode::TLoad: return "InterpretTLoad";
+		case OpCode::TStore: return "InterpretTStore";
+		case OpCode::Copy: return "InterpretCopy";
+		case OpCode::Swap: return "InterpretSwap";
+
+		case OpCode::Add: return "InterpretAdd";
+		case OpCode::Sub: return "InterpretSub";
+		case OpCode::Mul: return "InterpretMul";
+		case OpCode::IMul: return "InterpretIMul";
+		case OpCode::Div: return "InterpretDiv";
+		case OpCode::IDiv: return "InterpretIDiv";
+		case OpCode::Mod: return "InterpretMod";
+		case OpCode::IMod: return "InterpretIMod";
+		case OpCode::Neg: return "InterpretNeg";
+
+		case OpCode::And: return "InterpretAnd";
+		case OpCode::Or: return "InterpretOr";
+		case OpCode::Xor: return "InterpretXor";
+		case OpCode::Not: return "InterpretNot";
+		case OpCode::Shl: return "InterpretShl";
+		case OpCode::Sal: return "InterpretSal";
+		case OpCode::Shr: return "InterpretShr";
+		case OpCode::Sar: return "InterpretSar";
+
+		case OpCode::Cmp: return "InterpretCmp";
+		case OpCode::ICmp: return "InterpretICmp";
+
+		case OpCode::ToI: return "InterpretToI";
+		case OpCode::ToL: return "InterpretToL";
+		case OpCode::ToD: return "InterpretToD";
+		case OpCode::ToP: return "InterpretToP";
+
+		case OpCode::Null: return "InterpretNull";
+		case OpCode::Delete: return "InterpretDelete";
+		case OpCode::GCNull: return "InterpretGCNull";
+		case OpCode::ALea: return "InterpretALea";
+		case OpCode::Count: return "InterpretCount";
+
+		case OpCode::AddInt: return "InterpretAddInt";
+		case OpCode::AddLong: return "InterpretAddLong";
+		case OpCode::AddDouble: return "InterpretAddDouble";
+		case OpCode::SubInt: return "InterpretSubInt";
+		case OpCode::SubLong: return "InterpretSubLong";
+		case OpCode::SubDouble: return "InterpretSubDouble";
+		case OpCode::MulInt: return "InterpretMulInt";
+		case OpCode::MulLong: return "InterpretMulLong";
+		case OpCode::MulDouble: return "InterpretMulDouble";
+		case OpCode::DivInt: return "InterpretDivInt";
+		case OpCode::DivLong: return "InterpretDivLong";
+		case OpCode::DivDouble: return "InterpretDivDouble";
+		case OpCode::CmpInt: return "InterpretCmpInt";
+		case OpCode::CmpLong: return "InterpretCmpLong";
+		case OpCode::CmpDouble: return "InterpretCmpDouble";
+		case OpCode::ICmpInt: return "InterpretICmpInt";
+		case OpCode::ICmpLong: return "InterpretICmpLong";
+
+		default: return nullptr;
+		}
+	}
+	const char* GetOperandHandlerName(OpCode opCode) noexcept {
+		switch (opCode) {
+		case OpCode::Push: return "InterpretPush";
+		case OpCode::Load: return "InterpretLoad";
+		case OpCode::Store: return "InterpretStore";
+		case OpCode::Lea: return "InterpretLea";
+		case OpCode::FLea: return "InterpretFLea";
+		case OpCode::APush: return "InterpretAPush";
+
+		case OpCode::Jmp: return "InterpretJmp";
+		case OpCode::Je: return "InterpretJe";
+		case OpCode::Jne: return "InterpretJne";
+		case OpCode::Ja: return "InterpretJa";
+		case OpCode::Jae: return "InterpretJae";
+		case OpCode::Jb: return "InterpretJb";
+		case OpCode::Jbe: return "InterpretJbe";
+		case OpCode::Call: return "InterpretCall";
+		case OpCode::TCall: return "InterpretTCall";
+
+		case OpCode::New: return "InterpretNew";
+		case OpCode::GCNew: return "InterpretGCNew";
+		case OpCode::ANew: return "InterpretANew";
+		case OpCode::AGCNew: return "InterpretAGCNew";
+
+		default: return nullptr;
+		}
+	}
+
+	bool IsCall(OpCode opCode) noexcept {
+		return opCode == OpCode::Call || opCode == OpCode::TCall || opCode == OpCode::CallDirect || opCode == OpCode::TCallDirect ||
+			opCode == OpCode::VerifiedCall;
+	}
+	bool IsConditionalJump(OpCode opCode) noexcept {
+		return opCode >= OpCode::Je && opCode <= OpCode::Jbe;
+	}
+	bool IsDirectConditionalJump(OpCode opCode) noexcept {
+		return opCode >= OpCode::JeDirect && opCode <= OpCode::JbeDirect;
+	}
+	bool IsVerifiedJump(OpCode opCode) noexcept {
+		return opCode >= OpCode::VerifiedJeInt && opCode <= OpCode::VerifiedJbeInt;
+	}
+	bool IsCompareAndJump(OpCode opCode) noexcept {
+		return opCode >= OpCode::CmpJe && opCode <= OpCode::CmpJbe;
+	}
+
+	class AotFunctionCompiler final {
+	private:
+		std::ostream& m_Stream;
+		const ByteFile& m_ByteFile;
+		const DecodedInstructions& m_Instructions;
+		std::size_t m_Count = 0;
+		std::vector<bool> m_IsLabel;
+
+	public:
+		AotFunctionCompiler(std::ostream& stream, const ByteFile& byteFile, const DecodedInstructions& instructions) noexcept
+			: m_Stream(stream), m_ByteFile(byteFile), m_Instructions(instructions), m_Count(instructions.size() - 2) {}
+
+	public:
+		void Compile(std::size_t index) {
+			FindLabels();
+
+			m_Stream << "\ttemplate<>\n"
+					 << "\tbool Interpreter::InterpretAotFunction<" << index << ">() {\n";
+
+			// Frames are entered at their first instruction, and returned to right after their calls
+			bool hasResumption = false;
+			for (std::size_t i = 0; i < m_Count; ++i) {
+				if (!IsCall(GetInstruction(i).OpCode)) continue;
+				if (!hasResumption) {
+					m_Stream << "\t\tswitch (m_StackFrame.Caller) {\n";
+					hasResumption = true;
+				}
+				m_Stream << "\t\tcase " << i + 1 << ": goto I" << i + 1 << ";\n";
+			}
+			if (hasResumption) {
+				m_Stream << "\t\tdefault: break;\n"
+						 << "\t\t}\n\n";
+			}
+
+			for (std::size_t i = 0; i < m_Count; ++i) {
+				CompileInstruction(i);
+			}
+
+			if (m_IsLabel[m_Count]) {
+				m_Stream << "\tI" << m_Count << ":\n";
+			}
+			m_Stream << "\t\tm_StackFrame.Caller = " << m_Count << "u - 1;\n"
+					 << "\t\treturn true;\n"
+					 << "\t}\n";
+		}
+
+	private:
+		const DecodedInstruction& GetInstruction(std::size_t index) const noexcept {
+			return m_Instructions[index + 1];
+		}
+
+		bool IsVerifiedLoadLoad(std::size_t index) const noexcept {
+			const OpCode operation = GetInstruction(index + 2).OpCode;
+			return GetInstruction(index).Offset != 0 && operation >= OpCode::VerifiedAddInt && operation <= OpCode::VerifiedSubDouble;
+		}
+
+		void FindLabels() {
+			m_IsLabel.assign(m_Count + 1, false);
+			for (std::size_t i = 0; i < m_Count; ++i) {
+				const DecodedInstruction& inst = GetInstruction(i);
+				if (inst.OpCode == OpCode::JmpDirect || IsDirectConditionalJump(inst.OpCode) || IsVerifiedJump(inst.OpCode)) {
+					m_IsLabel[static_cast<std::size_t>(inst.Operand.Target)] = true;
+				} else if (IsCall(inst.OpCode)) {
+					m_IsLabel[i + 1] = true;
+				} else if (IsCompareAndJump(inst.OpCode)) {
+					m_IsLabel[static_cast<std::size_t>(GetInstruction(i + 1).Operand.Target)] = true;
+					m_IsLabel[i + 2] = true;
+				} else if ((inst.OpCode == OpCode::LoadLoadAddStore || inst.OpCode == OpCode::LoadLoadSubStore) && !IsVerifiedLoadLoad(i)) {
+					m_IsLabel[i + 4] = true;
+				} else if (inst.OpCode == OpCode::LeaInc || inst.OpCode == OpCode::LeaDec) {
+					m_IsLabel[i + 2] = true;
+				}
+			}
+		}
+
+		void CompileInstruction(std::size_t index) {
+			const DecodedInstruction& inst = GetInstruction(index);
+			const OpCode opCode = inst.OpCode;
+
+			if (m_IsLabel[index]) {
+				m_Stream << "\tI" << index << ":\n";
+			}
+			m_Stream << "\t\t// [" << index << "] " << Mnemonics[static_cast<std::size_t>(opCode)] << '\n';
+
+			if (const char* const handler = GetHandlerName(opCode); handler) {
+				m_Stream << "\t\tSVM_CALL(" << index << ", " << handler << "());\n";
+				return;
+			} else if (const char* const operandHandler = GetOperandHandlerName(opCode); operandHandler) {
+				m_Stream << "\t\tSVM_CALL(" << index << ", " << operandHandler << '(' << inst.Operand.Operand << "u));\n";
+
+				// Jumps that could not be decoded target a label past the end if they do not raise an exception
+				if (opCode == OpCode::Jmp || IsCall(opCode)) {
+					m_Stream << "\t\treturn true;\n";
+				} else if (IsConditionalJump(opCode)) {
+					m_Stream << "\t\tif (m_StackFrame.Caller != " << index << ") return true;\n";
+				}
+				return;
+			}
+
+			switch (opCode) {
+			case OpCode::Inc:
+			case OpCode::Dec:
+				m_Stream << "\t\tSVM_CALL(" << index << ", InterpretIncDec(" << (opCode == OpCode::Inc ? 1 : -1) << "));\n";
+				break;
+
+			case OpCode::Ret:
+				m_Stream << "\t\tSVM_CALL(" << index << ", InterpretRet());\n"
+						 << "\t\treturn true;\n";
+				break;
+
+			case OpCode::JmpDirect:
+				m_Stream << "\t\tgoto I" << inst.Operand.Target << ";\n";
+				break;
+
+			case OpCode::JeDirect:
+			case OpCode::JneDirect:
+			case OpCode::JaDirect:
+			case OpCode::JaeDirect:
+			case OpCode::JbDirect:
+			case OpCode::JbeDirect: {
+				static constexpr const char* handlers[] = {
+					"InterpretJeDirect", "InterpretJneDirect", "InterpretJaDirect", "InterpretJaeDirect", "InterpretJbDirect", "InterpretJbeDirect",
+				};
+				m_Stream << "\t\tSVM_CALL(" << index << ", " << handlers[static_cast<std::size_t>(opCode) - static_cast<std::size_t>(OpCode::JeDirect)]
+						 << '(' << inst.Operand.Target << "u));\n"
+						 << "\t\tif (m_StackFrame.Caller != " << index << ") goto I" << inst.Operand.Target << ";\n";
+				break;
+			}
+
+			case OpCode::CallDirect:
+			case OpCode::TCallDirect:
+			case OpCode::VerifiedCall: {
+				const std::size_t function = static_cast<std::size_t>(inst.Operand.Function - m_ByteFile.GetFunctions().data());
+				m_Stream << "\t\tSVM_CALL(" << index << ", ";
+				if (opCode == OpCode::VerifiedCall) {
+					m_Stream << "InterpretVerifiedCall(&m_ByteFile.GetFunctions()[" << function << "], " << inst.Offset << "u));\n";
+				} else {
+					m_Stream << (opCode == OpCode::CallDirect ? "InterpretCallDirect" : "InterpretTCallDirect")
+							 << "(&m_ByteFile.GetFunctions()[" << function << "]));\n";
+				}
+				m_Stream << "\t\treturn true;\n";
+				break;
+			}
+
+			case OpCode::PushInt:
+				m_Stream << "\t\tSVM_PUSH(" << index << ", IntObject, IntType, " << inst.Operand.Int->Value << "u);\n";
+				break;
+			case OpCode::PushLong:
+				m_Stream << "\t\tSVM_PUSH(" << index << ", LongObject, LongType, " << inst.Operand.Long->Value << "ull);\n";
+				break;
+			case OpCode::PushDouble: {
+				std::uint64_t bits;
+				std::memcpy(&bits, &inst.Operand.Double->Value, sizeof(bits));
+				m_Stream << "\t\tSVM_PUSH(" << index << ", DoubleObject, DoubleType, ToDouble(0x" << std::hex << bits << std::dec << "ull));\n";
+				break;
+			}
+
+			// Superinstructions run only the first instruction of the group when they fall back
+			case OpCode::LoadLoadAddStore:
+			case OpCode::LoadLoadSubStore:
+				// The operation of the group proves the type of the first load, so it does not need the guards if the offset is known
+				if (IsVerifiedLoadLoad(index)) {
+					static constexpr const char* types[][2] = {
+						{ "IntObject", "IntType" }, { "LongObject", "LongType" }, { "DoubleObject", "DoubleType" },
+					};
+					const OpCode operation = GetInstruction(index + 2).OpCode;
+					const auto& [object, type] = types[(static_cast<std::size_t>(operation) - static_cast<std::size_t>(OpCode::VerifiedAddInt)) % 3];
+					m_Stream << "\t\tSVM_PUSH(" << index << ", " << object << ", " << type << ", SVM_LOCAL_VARIABLE(" << object << ", " << inst.Offset << ")->Value);\n";
+					break;
+				}
+
+				m_Stream << "\t\tm_StackFrame.Caller = " << index << ";\n"
+						 << "\t\tif (" << (opCode == OpCode::LoadLoadAddStore ? "InterpretLoadLoadAddStore" : "InterpretLoadLoadSubStore")
+						 << "(GetDecodedCode() + " << index << ")) goto I" << index + 4 << ";\n"
+						 << "\t\tSVM_CALL(" << index << ", InterpretLoad(" << inst.Operand.Operand << "u));\n";
+				break;
+			case OpCode::CmpJe:
+			case OpCode::CmpJne:
+			case OpCode::CmpJa:
+			case OpCode::CmpJae:
+			case OpCode::CmpJb:
+			case OpCode::CmpJbe: {
+				static constexpr const char* handlers[] = {
+					"InterpretCmpJe", "InterpretCmpJne", "InterpretCmpJa", "InterpretCmpJae", "InterpretCmpJb", "InterpretCmpJbe",
+				};
+				const std::uint64_t target = GetInstruction(index + 1).Operand.Target;
+				m_Stream << "\t\tm_StackFrame.Caller = " << index << ";\n"
+						 << "\t\tif (" << handlers[static_cast<std::size_t>(opCode) - static_cast<std::size_t>(OpCode::CmpJe)] << '(' << target << "u)) {\n"
+						 << "\t\t\tif (m_StackFrame.Caller != " << index + 1 << ") goto I" << target << ";\n"
+						 << "\t\t\tgoto I" << index + 2 << ";\n"
+						 << "\t\t}\n"
+						 << "\t\tSVM_CALL(" << index << ", InterpretCmp());\n";
+				break;
+			}
+			case OpCode::LeaInc:
+			case OpCode::LeaDec:
+				m_Stream << "\t\tm_StackFrame.Caller = " << index << ";\n"
+						 << "\t\tif (InterpretLeaIncDec(" << inst.Operand.Operand << "u, " << (opCode == OpCode::LeaInc ? 1 : -1) << ")) goto I" << index + 2 << ";\n"
+						 << "\t\tSVM_CALL(" << index << ", InterpretLea(" << inst.Operand.Operand << "u));\n";
+				break;
+
+			// Verified instructions are written out, so the compiler can keep their values in registers
+			case OpCode::VerifiedLoadInt:
+			case OpCode::VerifiedLoadLong:
+			case OpCode::VerifiedLoadDouble: {
+				static constexpr const char* types[][2] = {
+					{ "IntObject", "IntType" }, { "LongObject", "LongType" }, { "DoubleObject", "DoubleType" },
+				};
+				const auto& [object, type] = types[static_cast<std::size_t>(opCode) - static_cast<std::size_t>(OpCode::VerifiedLoadInt)];
+				m_Stream << "\t\tSVM_PUSH(" << index << ", " << object << ", " << type << ", SVM_LOCAL_VARIABLE(" << object << ", " << inst.Offset << ")->Value);\n";
+				break;
+			}
+			case OpCode::VerifiedStoreInt:
+			case OpCode::VerifiedStoreLong:
+			case OpCode::VerifiedStoreDouble: {
+				static constexpr const char* objects[] = { "IntObject", "LongObject", "DoubleObject" };
+				m_Stream << "\t\tSVM_VERIFIED_STORE(" << objects[static_cast<std::size_t>(opCode) - static_cast<std::size_t>(OpCode::VerifiedStoreInt)]
+						 << ", " << inst.Offset << ");\n";
+				break;
+			}
+			case OpCode::VerifiedLea:
+				m_Stream << "\t\tSVM_PUSH(" << index << ", PointerObject, PointerType, static_cast<void*>(SVM_LOCAL_VARIABLE(Type, " << inst.Offset << ")));\n";
+				break;
+
+			case OpCode::VerifiedAddInt:
+			case OpCode::VerifiedAddLong:
+			case OpCode::VerifiedAddDouble:
+			case OpCode::VerifiedSubInt:
+			case OpCode::VerifiedSubLong:
+			case OpCode::VerifiedSubDouble:
+			case OpCode::VerifiedMulInt:
+			case OpCode::VerifiedMulLong:
+			case OpCode::VerifiedMulDouble: {
+				static constexpr const char* objects[] = { "IntObject", "LongObject", "DoubleObject" };
+				static constexpr char operators[] = { '+', '-', '*' };
+				const std::size_t offset = static_cast<std::size_t>(opCode) - static_cast<std::size_t>(OpCode::VerifiedAddInt);
+				m_Stream << "\t\tSVM_VERIFIED_OPERATION(" << objects[offset % 3] << ", " << operators[offset / 3] << ");\n";
+				break;
+			}
+			case OpCode::VerifiedCmpInt:
+			case OpCode::VerifiedCmpLong:
+			case OpCode::VerifiedCmpDouble:
+			case OpCode::VerifiedICmpInt:
+			case OpCode::VerifiedICmpLong: {
+				static constexpr const char* types[][2] = {
+					{ "IntObject", "std::uint32_t" }, { "LongObject", "std::uint64_t" }, { "DoubleObject", "double" },
+					{ "IntObject", "std::int32_t" }, { "LongObject", "std::int64_t" },
+				};
+				const auto& [object, type] = types[static_cast<std::size_t>(opCode) - static_cast<std::size_t>(OpCode::VerifiedCmpInt)];
+				m_Stream << "\t\tSVM_VERIFIED_COMPARE(" << object << ", " << type << ");\n";
+				break;
+			}
+			case OpCode::VerifiedJeInt:
+			case OpCode::VerifiedJneInt:
+			case OpCode::VerifiedJaInt:
+			case OpCode::VerifiedJaeInt:
+			case OpCode::VerifiedJbInt:
+			case OpCode::VerifiedJbeInt: {
+				static constexpr const char* conditions[][2] = {
+					{ "==", "0" }, { "!=", "0" }, { "==", "1" }, { "!=", "-1" }, { "==", "-1" }, { "!=", "1" },
+				};
+				const auto& [o, v] = conditions[static_cast<std::size_t>(opCode) - static_cast<std::size_t>(OpCode::VerifiedJeInt)];
+				m_Stream << "\t\tSVM_VERIFIED_JUMP(" << o << ", " << v << ", I" << inst.Operand.Target << ");\n";
+				break;
+			}
+			case OpCode::VerifiedALeaInt:
+			case OpCode::VerifiedALeaLong:
+				m_Stream << "\t\tSVM_VERIFIED_ALEA(" << (opCode == OpCode::VerifiedALeaInt ? "IntObject" : "LongObject") << ");\n";
+				break;
+
+			default: break;
+			}
+		}
+	};
+}
+
+namespace svm {
+	void CompileAot(ByteFile&& byteFile, std::ostream& stream) {
+		Writer writer;
+		writer.Write(byteFile);
+		const std::vector<std::uint8_t>& bytes = writer.GetResult();
+		const std::string path(byteFile.GetPath());
+
+		// The interpreter prepares the byte file the same way as the compiled program does when it starts,
+		// so the written bytes are parsed again and the same functions are left not loaded
+		Parser parser;
+		parser.Load(path, std::vector<std::uint8_t>(bytes));
+		parser.Parse();
+
+		const Interpreter interpreter(parser.GetResult());
+		const ByteFile& preparedByteFile = interpreter.GetByteFile();
+		const std::size_t functionCount = preparedByteFile.GetFunctions().size() + 1;
+
+		stream << Prelude << "\nnamespace svm {\n";
+		for (std::size_t i = 0; i < functionCount; ++i) {
+			if (i != 0) {
+				stream << '\n';
+			}
+			AotFunctionCompiler(stream, preparedByteFile, interpreter.GetDecodedInstructions(i)).Compile(i);
+		}
+		stream << "}\n\n";
+
+		stream << "namespace {\n"
+			   << "\tconst std::uint8_t ByteFile[] = {";
+		for (std::size_t i = 0; i < bytes.size(); ++i) {
+			stream << (i % 16 == 0 ? "\n\t\t" : " ") << static_cast<unsigned>(bytes[i]) << ',';
+		}
+		stream << "\n\t};\n"
+			   << "\tconst std::size_t InstructionCounts[] = {";
+		for (std::size_t i = 0; i < functionCount; ++i) {
+			stream << (i % 16 == 0 ? "\n\t\t" : " ") << interpreter.GetDecodedInstructions(i).size() - 2 << ',';
+		}
+		stream << "\n\t};\n"
+			   << "}\n\n";
+
+		stream << "int main() {\n"
+			   << "\ttry {\n"
+			   << "\t\tsvm::Parser parser;\n"
+			   << "\t\tparser.Load(";
+		WriteStringLiteral(stream, path);
+		stream << ", std::vector<std::uint8_t>(std::begin(ByteFile), std::end(ByteFile)));\n"
+			   << "\t\tparser.Parse();\n\n"
+			   << "\t\tsvm::Interpreter interpreter(parser.GetResult());\n"
+			   << "\t\tfor (std::size_t i = 0; i < std::size(InstructionCounts); ++i) {\n"
+			   << "\t\t\tif (interpreter.GetDecodedInstructions(i).size() != InstructionCounts[i] + 2) {\n"
+			   << "\t\t\t\tstd::cout << \"The byte file was compiled with another version of ShitVM.\\n\";\n"
+			   << "\t\t\t\treturn EXIT_FAILURE;\n"
+			   << "\t\t\t}\n"
+			   << "\t\t}\n\n"
+			   << "\t\tinterpreter.SetAotFunctions({";
+		for (std::size_t i = 0; i < functionCount; ++i) {
+			stream << (i % 4 == 0 ? "\n\t\t\t" : " ") << "&svm::Interpreter::InterpretAotFunction<" << i << ">,";
+		}
+		stream << "\n\t\t});\n"
+			   << "\t\tinterpreter.SetEngine(svm::InterpreterEngine::Aot);\n"
+			   << "\t\tinterpreter.AllocateStack(1 * 1024 * 1024);\n"
+			   << "\t\tinterpreter.SetGarbageCollector(std::make_unique<svm::SimpleGarbageCollector>(8 * 1024 * 1024, 32 * 1024 * 1024));\n\n"
+			   << "\t\tif (!interpreter.Interpret()) {\n"
+			   << "\t\t\tstd::cout << \"Occured exception!\\n\"\n"
+			   << "\t\t\t\t\t  << \"Message: \\\"\" << svm::GetInterpreterExceptionMessage(interpreter.GetException().Code) << \"\\\"\\n\";\n"
+			   << "\t\t\treturn EXIT_FAILURE;\n"
+			   << "\t\t} else if (interpreter.HasResult()) {\n"
+			   << "\t\t\tstd::cout << \"Result: \";\n"
+			   << "\t\t\tinterpreter.PrintObject(std::cout, interpreter.GetResult(), true);\n"
+			   << "\t\t\tstd::cout << '\\n';\n"
+			   << "\t\t}\n"
+			   << "\t} catch (const std::exception& e) {\n"
+			   << "\t\tstd::cout << \"Occured exception!\\n\"\n"
+			   << "\t\t\t\t  << \"Message: \\\"\" << e.what() << \"\\\"\\n\";\n"
+			   << "\t\treturn EXIT_FAILURE;\n"
+			   << "\t}\n\n"
+			   << "\treturn EXIT_SUCCESS;\n"
+			   << "}\n";
+	}
+}
\ No newline at end of file
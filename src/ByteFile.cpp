@@ -1,8 +1,12 @@
 #include <svm/ByteFile.hpp>
 
 #include <svm/IO.hpp>
+#include <svm/detail/ParallelFor.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <utility>
+#include <vector>
 
 namespace svm {
 	ByteFile::ByteFile(std::string path, ConstantPool&& constantPool, Structures&& structures, Functions&& functions, Instructions&& entryPoint) noexcept
@@ -54,6 +58,9 @@ namespace svm {
 	const Functions& ByteFile::GetFunctions() const noexcept {
 		return m_Functions;
 	}
+	Functions& ByteFile::GetFunctions() noexcept {
+		return m_Functions;
+	}
 	void ByteFile::SetFunctions(Functions&& newFunctions) noexcept {
 		m_Functions = std::move(newFunctions);
 	}
@@ -64,6 +71,51 @@ namespace svm {
 		m_EntryPoint = std::move(newEntryPoint);
 	}
 
+	void ByteFile::LoadReachableFunctions() const {
+		const std::size_t funcCount = m_Functions.size();
+		std::vector<bool> isReached(funcCount);
+		std::vector<std::uint32_t> reached;
+
+		const auto reach = [&](const std::vector<std::uint32_t>& callees) {
+			for (const std::uint32_t callee : callees) {
+				if (isReached[callee]) continue;
+
+				isReached[callee] = true;
+				reached.push_back(callee);
+			}
+		};
+		const auto findCallees = [funcCount](const Instructions& instructions) {
+			std::vector<std::uint32_t> callees;
+			for (const Instruction& inst : instructions.GetInstructions()) {
+				if ((inst.OpCode != OpCode::Call && inst.OpCode != OpCode::TCall) || inst.Operand >= funcCount) continue;
+
+				callees.push_back(inst.Operand);
+			}
+			return callees;
+		};
+
+		// Calls always name their functions, so the functions that a run can call are known before it starts.
+		// The functions found at each step are parsed in parallel, and their callees are merged in order.
+		reach(findCallees(m_EntryPoint));
+		while (!reached.empty()) {
+			const std::vector<std::uint32_t> functions = std::move(reached);
+			reached.clear();
+
+			std::vector<std::vector<std::uint32_t>> callees(functions.size());
+			detail::ParallelFor(functions.size(), [&](std::size_t i) {
+				callees[i] = findCallees(m_Functions[functions[i]].GetInstructions());
+			});
+			for (const std::vector<std::uint32_t>& functionCallees : callees) {
+				reach(functionCallees);
+			}
+		}
+	}
+	void ByteFile::LoadFunctions() const {
+		detail::ParallelFor(m_Functions.size(), [this](std::size_t i) {
+			m_Functions[i].Load();
+		});
+	}
+
 	std::ostream& operator<<(std::ostream& stream, const ByteFile& byteFile) {
 		const std::string defIndent = detail::MakeTabs(stream);
 
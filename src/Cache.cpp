@@ -0,0 +1,263 @@
+#include <svm/Interpreter.hpp>
+
+#include <svm/Memory.hpp>
+#include <svm/Parser.hpp>
+#include <svm/Version.hpp>
+#include <svm/Writer.hpp>
+#include <svm/detail/Hash.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace svm {
+	namespace {
+		// [prepared byte file][sections][the offset of the sections][checksum][magic]
+		// The checksum is the hash of everything before it, so caches that were corrupted or written partially are never used.
+		// The prepared byte file is a ShitBF file, so its functions are mapped and parsed when they are needed first as usual.
+		// The checksum cannot tell a cache that was written on purpose from a valid one, so the cache keeps only what the
+		// interpreter checks while running anyway. The instructions are verified and decoded again, and only the optimizer is skipped.
+		constexpr std::uint8_t CacheMagic[] = { 's', 'v', 'm', 'c' };
+		constexpr std::uint32_t CacheVersion = 2;
+		constexpr std::size_t CacheTrailerSize = sizeof(std::uint64_t) * 2 + sizeof(CacheMagic);
+		constexpr std::uint32_t OpCodeCount = static_cast<std::uint32_t>(std::size(Mnemonics));
+
+		class CacheWriter final {
+		private:
+			std::vector<std::uint8_t> m_File;
+
+		public:
+			explicit CacheWriter(std::vector<std::uint8_t> file) noexcept
+				: m_File(std::move(file)) {}
+
+		public:
+			template<typename T>
+			void Write(T value) {
+				if (sizeof(T) > 1 && GetEndian() != Endian::Little) {
+					value = ReverseEndian(value);
+				}
+
+				const std::size_t pos = m_File.size();
+				m_File.resize(pos + sizeof(T));
+				std::memcpy(m_File.data() + pos, &value, sizeof(T));
+			}
+			void Write(const Instructions& instructions) {
+				Write(instructions.GetLabelCount());
+				for (const std::uint64_t label : instructions.GetLabels()) {
+					Write(label);
+				}
+
+				Write(instructions.GetInstructionCount());
+				for (const Instruction& inst : instructions.GetInstructions()) {
+					Write(static_cast<std::uint8_t>(inst.OpCode));
+					Write(inst.Operand);
+				}
+			}
+
+			const std::vector<std::uint8_t>& GetResult() const noexcept {
+				return m_File;
+			}
+		};
+
+		class CacheReader final {
+		private:
+			const std::uint8_t* m_Data;
+			std::size_t m_Size;
+			std::size_t m_Pos = 0;
+
+		public:
+			CacheReader(const std::uint8_t* data, std::size_t size) noexcept
+				: m_Data(data), m_Size(size) {}
+
+		public:
+			template<typename T>
+			T Read() {
+				if (m_Size - m_Pos < sizeof(T)) throw std::runtime_error("Failed to read the cache. Invalid format.");
+
+				T result;
+				std::memcpy(&result, m_Data + m_Pos, sizeof(T));
+				m_Pos += sizeof(T);
+
+				if (sizeof(T) > 1 && GetEndian() != Endian::Little) return ReverseEndian(result);
+				else return result;
+			}
+			// Reads a count of elements, which cannot be more than the remaining bytes can hold
+			std::size_t ReadCount(std::size_t elementSize) {
+				const std::uint64_t count = Read<std::uint64_t>();
+				if (count > (m_Size - m_Pos) / elementSize) throw std::runtime_error("Failed to read the cache. Invalid format.");
+				return static_cast<std::size_t>(count);
+			}
+			OpCode ReadOpCode() {
+				const std::uint8_t opCode = Read<std::uint8_t>();
+				if (opCode >= OpCodeCount) throw std::runtime_error("Failed to read the cache. Invalid format.");
+				return static_cast<OpCode>(opCode);
+			}
+			Instructions ReadInstructions() {
+				std::vector<std::uint64_t> labels(Read<std::uint32_t>());
+				if (labels.size() > (m_Size - m_Pos) / sizeof(std::uint64_t)) throw std::runtime_error("Failed to read the cache. Invalid format.");
+				for (std::uint64_t& label : labels) {
+					label = Read<std::uint64_t>();
+				}
+
+				const std::size_t instCount = ReadCount(sizeof(std::uint8_t) + sizeof(std::uint32_t));
+				std::vector<Instruction> insts;
+				insts.reserve(instCount);
+				for (std::size_t i = 0; i < instCount; ++i) {
+					const OpCode opCode = ReadOpCode();
+					insts.emplace_back(opCode, Read<std::uint32_t>());
+				}
+				return { std::move(labels), std::move(insts) };
+			}
+		};
+
+		std::string GetCachePath(std::string_view path) {
+			return std::string(path) + ".svmc";
+		}
+	}
+
+	bool Interpreter::LoadCache(const std::string& path, std::uint64_t hash) {
+		try {
+			Parser parser;
+			parser.Load(GetCachePath(path));
+
+			const std::uint8_t* const data = parser.GetData();
+			const std::size_t size = parser.GetSize();
+			if (size < CacheTrailerSize || !std::equal(std::begin(CacheMagic), std::end(CacheMagic), data + size - sizeof(CacheMagic))) return false;
+
+			CacheReader trailer(data + size - CacheTrailerSize, CacheTrailerSize);
+			const std::uint64_t sectionsOffset = trailer.Read<std::uint64_t>();
+			if (sectionsOffset > size - CacheTrailerSize) return false;
+
+			// Caches of other versions may have other opcodes, and caches of other byte files are just wrong
+			CacheReader reader(data + sectionsOffset, static_cast<std::size_t>(size - CacheTrailerSize - sectionsOffset));
+			if (reader.Read<std::uint32_t>() != CacheVersion ||
+				reader.Read<std::uint16_t>() != SVM_VER_MAJOR || reader.Read<std::uint16_t>() != SVM_VER_MINOR || reader.Read<std::uint16_t>() != SVM_VER_PATCH ||
+				reader.Read<std::uint32_t>() != OpCodeCount || reader.Read<std::uint64_t>() != hash) return false;
+			else if (trailer.Read<std::uint64_t>() != detail::HashBytes(data, size - CacheTrailerSize + sizeof(std::uint64_t))) return false;
+
+			parser.Parse();
+			ByteFile byteFile = parser.GetResult();
+			byteFile.SetPath(path);
+
+			// The same functions as the cold start are loaded, including the ones that were inlined everywhere
+			const Functions& functions = byteFile.GetFunctions();
+			if (reader.ReadCount(sizeof(std::uint8_t)) != functions.size()) return false;
+			for (const Function& function : functions) {
+				if (reader.Read<std::uint8_t>()) {
+					function.Load();
+				}
+			}
+
+			std::vector<Instructions> originalInstructions;
+			std::vector<InstructionOrigins> instructionOrigins;
+			if (reader.Read<std::uint8_t>()) {
+				for (std::size_t i = 0; i <= functions.size(); ++i) {
+					originalInstructions.push_back(reader.ReadInstructions());
+				}
+				for (std::size_t i = 0; i <= functions.size(); ++i) {
+					InstructionOrigins& origins = instructionOrigins.emplace_back(reader.ReadCount(sizeof(std::uint64_t)));
+					if (!origins.empty()) {
+						// The origins are indexed by the prepared instructions and index the original ones, so both must agree with them
+						if (i > 0 && !functions[i - 1].IsLoaded()) return false;
+
+						const Instructions& instructions = i == 0 ? byteFile.GetEntryPoint() : functions[i - 1].GetInstructions();
+						if (origins.size() != instructions.GetInstructionCount()) return false;
+					}
+					for (std::vector<InstructionOrigin>& origin : origins) {
+						origin.resize(reader.ReadCount(sizeof(std::uint64_t) * 2));
+						for (InstructionOrigin& function : origin) {
+							function.Function = static_cast<std::size_t>(reader.Read<std::uint64_t>());
+							function.Index = reader.Read<std::uint64_t>();
+							if (function.Function > functions.size() ||
+								function.Index >= originalInstructions[function.Function].GetInstructionCount()) return false;
+						}
+					}
+				}
+			}
+
+			// Only the optimizer is skipped, and what the verifier proves is never taken from the cache
+			m_ByteFile = std::move(byteFile);
+			m_StackFrame.Instructions = &m_ByteFile.GetEntryPoint();
+			m_OriginalInstructions = std::move(originalInstructions);
+			m_InstructionOrigins = std::move(instructionOrigins);
+
+			DecodeFunctions();
+			return true;
+		} catch (const std::exception&) {
+			return false;
+		}
+	}
+	void Interpreter::SaveCache(std::uint64_t hash) const {
+		Writer writer;
+		writer.Write(m_ByteFile);
+
+		CacheWriter cache(writer.GetResult());
+		const std::uint64_t sectionsOffset = cache.GetResult().size();
+		cache.Write(CacheVersion);
+		cache.Write(static_cast<std::uint16_t>(SVM_VER_MAJOR));
+		cache.Write(static_cast<std::uint16_t>(SVM_VER_MINOR));
+		cache.Write(static_cast<std::uint16_t>(SVM_VER_PATCH));
+		cache.Write(OpCodeCount);
+		cache.Write(hash);
+
+		const Functions& functions = m_ByteFile.GetFunctions();
+		cache.Write(static_cast<std::uint64_t>(functions.size()));
+		for (const Function& function : functions) {
+			cache.Write(static_cast<std::uint8_t>(function.IsLoaded()));
+		}
+
+		cache.Write(static_cast<std::uint8_t>(!m_OriginalInstructions.empty()));
+		if (!m_OriginalInstructions.empty()) {
+			for (const Instructions& instructions : m_OriginalInstructions) {
+				cache.Write(instructions);
+			}
+			for (const InstructionOrigins& origins : m_InstructionOrigins) {
+				cache.Write(static_cast<std::uint64_t>(origins.size()));
+				for (const std::vector<InstructionOrigin>& origin : origins) {
+					cache.Write(static_cast<std::uint64_t>(origin.size()));
+					for (const InstructionOrigin& function : origin) {
+						cache.Write(static_cast<std::uint64_t>(function.Function));
+						cache.Write(function.Index);
+					}
+				}
+			}
+		}
+
+		cache.Write(sectionsOffset);
+		cache.Write(detail::HashBytes(cache.GetResult().data(), cache.GetResult().size()));
+		for (const std::uint8_t magic : CacheMagic) {
+			cache.Write(magic);
+		}
+
+		// Other processes may read or write the cache at the same time, so it is replaced only after it is written completely
+		const std::string path = GetCachePath(m_ByteFile.GetPath());
+		const std::string tempPath = path + '.' + std::to_string(std::random_device()());
+		{
+			std::ofstream stream(tempPath, std::ofstream::binary);
+			const std::vector<std::uint8_t>& file = cache.GetResult();
+			stream.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+			if (!stream.flush()) {
+				stream.close();
+				std::remove(tempPath.c_str());
+				throw std::runtime_error("Failed to save the cache.");
+			}
+		}
+		if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+			std::remove(path.c_str());
+			if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+				std::remove(tempPath.c_str());
+				throw std::runtime_error("Failed to save the cache.");
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include <svm/DecodedInstruction.hpp>
+
+#include <svm/ConstantPool.hpp>
+#include <svm/Type.hpp>
+
+#include <cstddef>
+#include <limits>
+
+namespace svm {
+	DecodedInstructions DecodeInstructions(const ByteFile& byteFile, const Instructions& instructions) {
+		const ConstantPool& constantPool = byteFile.GetConstantPool();
+		const Functions& functions = byteFile.GetFunctions();
+		const std::uint32_t constCount = constantPool.GetAllCount();
+		const std::uint32_t labelCount = instructions.GetLabelCount();
+		const std::uint64_t instCount = instructions.GetInstructionCount();
+
+		DecodedInstructions result(static_cast<std::size_t>(instCount + 2));
+		for (std::uint64_t i = 0; i < instCount; ++i) {
+			const Instruction& inst = instructions.GetInstruction(i);
+			DecodedInstruction& decoded = result[static_cast<std::size_t>(i + 1)];
+
+			decoded.OpCode = inst.OpCode;
+			decoded.Operand.Operand = inst.Operand;
+
+			switch (inst.OpCode) {
+			case OpCode::Jmp:
+			case OpCode::Je:
+			case OpCode::Jne:
+			case OpCode::Ja:
+			case OpCode::Jae:
+			case OpCode::Jb:
+			case OpCode::Jbe:
+				if (inst.Operand < labelCount && instructions.GetLabel(inst.Operand) <= instCount) {
+					decoded.OpCode = static_cast<OpCode>(static_cast<std::uint8_t>(OpCode::JmpDirect) +
+						(static_cast<std::uint8_t>(inst.OpCode) - static_cast<std::uint8_t>(OpCode::Jmp)));
+					decoded.Operand.Target = instructions.GetLabel(inst.Operand);
+				}
+				break;
+
+			case OpCode::Call:
+			case OpCode::TCall:
+				if (inst.Operand < functions.size()) {
+					decoded.OpCode = inst.OpCode == OpCode::Call ? OpCode::CallDirect : OpCode::TCallDirect;
+					decoded.Operand.Function = &functions[inst.Operand];
+				}
+				break;
+
+			case OpCode::Push:
+				if (inst.Operand < constCount) {
+					const Type constType = constantPool.GetConstantType(inst.Operand);
+					if (constType == IntType) {
+						decoded.OpCode = OpCode::PushInt;
+						decoded.Operand.Int = &constantPool.GetConstant<IntObject>(inst.Operand);
+					} else if (constType == LongType) {
+						decoded.OpCode = OpCode::PushLong;
+						decoded.Operand.Long = &constantPool.GetConstant<LongObject>(inst.Operand);
+					} else if (constType == DoubleType) {
+						decoded.OpCode = OpCode::PushDouble;
+						decoded.Operand.Double = &constantPool.GetConstant<DoubleObject>(inst.Operand);
+					}
+				}
+				break;
+
+			default:
+				if (inst.OpCode >= FirstInternalOpCode) {
+					decoded.OpCode = OpCode::Nop;
+				}
+				break;
+			}
+		}
+
+		return result;
+	}
+	void FuseInstructions(DecodedInstructions& instructions) noexcept {
+		// The following instructions of a group stay as they are.
+		// They are executed when the fused handler falls back or a jump lands inside the group.
+		const std::size_t end = instructions.size() - 1;
+		for (std::size_t i = 1; i < end;) {
+			const SuperInstruction* match = nullptr;
+			for (const SuperInstruction& super : SuperInstructions) {
+				if (i + super.Length > end) continue;
+
+				std::uint8_t j = 0;
+				for (; j < super.Length && instructions[i + j].OpCode == super.Sequence[j]; ++j);
+				if (j == super.Length) {
+					match = &super;
+					break;
+				}
+			}
+
+			if (match) {
+				instructions[i].OpCode = match->Fused;
+				i += match->Length;
+			} else {
+				++i;
+			}
+		}
+	}
+	void SpecializeInstructions(DecodedInstructions& instructions, const VerifierResult& result) noexcept {
+		if (!result.IsVerified) return;
+
+		// Heads of superinstructions keep their guards, but the rest of their groups are specialized
+		const std::size_t end = instructions.size() - 1;
+		for (std::size_t i = 1; i < end; ++i) {
+			DecodedInstruction& decoded = instructions[i];
+			const Type type = result.OperandTypes[i - 1];
+
+			// Local variables are accessed relative to the stack frame, so they need fixed offsets
+			const std::ptrdiff_t frameOffset = result.LocalVariableOffsets[i - 1];
+			const bool hasFrameOffset = frameOffset != 0 &&
+				frameOffset >= std::numeric_limits<std::int32_t>::min() && frameOffset <= std::numeric_limits<std::int32_t>::max();
+			if (hasFrameOffset) {
+				decoded.Offset = static_cast<std::int32_t>(frameOffset);
+			}
+
+			if (decoded.OpCode == OpCode::Lea) {
+				if (hasFrameOffset) {
+					decoded.OpCode = OpCode::VerifiedLea;
+				}
+				continue;
+			} else if (decoded.OpCode == OpCode::CallDirect) {
+				// Calls with arguments that are not fundamental objects have to walk them
+				std::size_t argumentSize = 0;
+				for (const Type& argumentType : result.ArgumentTypes[i - 1]) {
+					if (!argumentType.IsFundamentalType()) {
+						argumentSize = 0;
+						break;
+					}
+					argumentSize += argumentType->Size;
+				}
+				if (argumentSize != 0 && argumentSize <= static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max())) {
+					decoded.OpCode = OpCode::VerifiedCall;
+					decoded.Offset = static_cast<std::int32_t>(argumentSize);
+				}
+				continue;
+			}
+
+			// Variants of the same operation are laid out in the order of int, long and double
+			std::uint8_t offset = 0;
+			if (type == IntType) {
+				offset = 0;
+			} else if (type == LongType) {
+				offset = 1;
+			} else if (type == DoubleType) {
+				offset = 2;
+			} else continue;
+
+			switch (decoded.OpCode) {
+			case OpCode::Load:
+				if (hasFrameOffset) {
+					decoded.OpCode = static_cast<OpCode>(static_cast<std::uint8_t>(OpCode::VerifiedLoadInt) + offset);
+				}
+				break;
+			case OpCode::Store:
+				if (hasFrameOffset) {
+					decoded.OpCode = static_cast<OpCode>(static_cast<std::uint8_t>(OpCode::VerifiedStoreInt) + offset);
+				}
+				break;
+			case OpCode::Add: decoded.OpCode = static_cast<OpCode>(static_cast<std::uint8_t>(OpCode::VerifiedAddInt) + offset); break;
+			case OpCode::Sub: decoded.OpCode = static_cast<OpCode>(static_cast<std::uint8_t>(OpCode::VerifiedSubInt) + offset); break;
+			case OpCode::Mul: decoded.OpCode = static_cast<OpCode>(static_cast<std::uint8_t>(OpCode::VerifiedMulInt) + offset); break;
+			case OpCode::Cmp: decoded.OpCode = static_cast<OpCode>(static_cast<std::uint8_t>(OpCode::VerifiedCmpInt) + offset); break;
+			case OpCode::ICmp: decoded.OpCode = offset == 2 ? OpCode::VerifiedCmpDouble : static_cast<OpCode>(static_cast<std::uint8_t>(OpCode::VerifiedICmpInt) + offset); break;
+			case OpCode::ALea:
+				if (offset != 2) {
+					decoded.OpCode = static_cast<OpCode>(static_cast<std::uint8_t>(OpCode::VerifiedALeaInt) + offset);
+				}
+				break;
+
+			case OpCode::JeDirect:
+			case OpCode::JneDirect:
+			case OpCode::JaDirect:
+			case OpCode::JaeDirect:
+			case OpCode::JbDirect:
+			case OpCode::JbeDirect:
+				if (offset == 0) {
+					decoded.OpCode = static_cast<OpCode>(static_cast<std::uint8_t>(OpCode::VerifiedJeInt) +
+						(static_cast<std::uint8_t>(decoded.OpCode) - static_cast<std::uint8_t>(OpCode::JeDirect)));
+				}
+				break;
+
+			default: break;
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -24,6 +24,7 @@ namespace svm {
 
 		case SVM_IEC_FUNCTION_OUTOFRANGE: return "Function does not exist."sv;
 		case SVM_IEC_FUNCTION_NORETINSTRUCTION: return "Function exited without 'ret' instruction."sv;
+		case SVM_IEC_FUNCTION_DIFFERENTRESULT: return "The two functions differ in whether they return a value."sv;
 
 		case SVM_IEC_POINTER_NULLPOINTER: return "Can't dereference null pointer."sv;
 		case SVM_IEC_POINTER_NOTPOINTER: return "Not a pointer."sv;
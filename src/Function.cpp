@@ -7,13 +7,17 @@
 namespace svm {
 	Function::Function(std::uint16_t arity, bool hasResult, Instructions&& instructions) noexcept
 		: m_Arity(arity), m_HasResult(hasResult), m_Instructions(std::move(instructions)) {}
+	Function::Function(std::uint16_t arity, bool hasResult, InstructionsLoader&& loader) noexcept
+		: m_Arity(arity), m_HasResult(hasResult), m_Loader(std::move(loader)) {}
 	Function::Function(Function&& function) noexcept
-		: m_Arity(function.m_Arity), m_HasResult(function.m_HasResult), m_Instructions(std::move(function.m_Instructions)) {}
+		: m_Arity(function.m_Arity), m_HasResult(function.m_HasResult), m_Instructions(std::move(function.m_Instructions)),
+		m_Loader(std::move(function.m_Loader)) {}
 
 	Function& Function::operator=(Function&& function) noexcept {
 		m_Arity = function.m_Arity;
 		m_HasResult = function.m_HasResult;
 		m_Instructions = std::move(function.m_Instructions);
+		m_Loader = std::move(function.m_Loader);
 		return *this;
 	}
 
@@ -29,11 +33,22 @@ namespace svm {
 	void Function::SetHasResult(bool newHasResult) noexcept {
 		m_HasResult = newHasResult;
 	}
-	const Instructions& Function::GetInstructions() const noexcept {
+	bool Function::IsLoaded() const noexcept {
+		return !m_Loader;
+	}
+	void Function::Load() const {
+		if (!m_Loader) return;
+
+		m_Instructions = m_Loader();
+		m_Loader = nullptr;
+	}
+	const Instructions& Function::GetInstructions() const {
+		Load();
 		return m_Instructions;
 	}
 	void Function::SetInstructions(Instructions&& newInstructions) noexcept {
 		m_Instructions = std::move(newInstructions);
+		m_Loader = nullptr;
 	}
 
 	std::ostream& operator<<(std::ostream& stream, const Function& function) {
@@ -41,8 +56,8 @@ namespace svm {
 
 		stream << defIndent << "Function:\n"
 			   << defIndent << "\tArity: " << function.GetArity() << '\n'
-			   << defIndent << "\tHasResult: " << std::boolalpha << function.HasResult() << std::noboolalpha << '\n'
-			   << Indent << Indent << function.GetInstructions() << UnIndent << UnIndent;
+			   << defIndent << "\tHasResult: " << std::boolalpha << function.HasResult() << std::noboolalpha << '\n';
+		stream << Indent << Indent << function.GetInstructions() << UnIndent << UnIndent;
 		return stream;
 	}
 	std::ostream& operator<<(std::ostream& stream, const Functions& functions) {
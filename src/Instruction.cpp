@@ -5,17 +5,18 @@
 #include <utility>
 
 namespace svm {
-	Instruction::Instruction(svm::OpCode opCode, std::uint64_t offset) noexcept
-		: OpCode(opCode), Offset(offset) {}
-	Instruction::Instruction(svm::OpCode opCode, std::uint32_t operand, std::uint64_t offset) noexcept
-		: OpCode(opCode), Operand(operand), Offset(offset) {}
+	static_assert(sizeof(Instruction) == 8);
+
+	Instruction::Instruction(svm::OpCode opCode) noexcept
+		: OpCode(opCode) {}
+	Instruction::Instruction(svm::OpCode opCode, std::uint32_t operand) noexcept
+		: OpCode(opCode), Operand(operand) {}
 	Instruction::Instruction(const Instruction& instruction) noexcept
-		: OpCode(instruction.OpCode), Operand(instruction.Operand), Offset(instruction.Offset) {}
+		: OpCode(instruction.OpCode), Operand(instruction.Operand) {}
 
 	Instruction& Instruction::operator=(const Instruction& instruction) noexcept {
 		OpCode = instruction.OpCode;
 		Operand = instruction.Operand;
-		Offset = instruction.Offset;
 		return *this;
 	}
 	bool Instruction::operator==(const Instruction& instruction) const noexcept {
@@ -30,7 +31,7 @@ namespace svm {
 	}
 
 	std::ostream& operator<<(std::ostream& stream, const Instruction& instruction) {
-		stream << QWord(instruction.Offset) << ": " << Mnemonics[static_cast<std::uint8_t>(instruction.OpCode)];
+		stream << Mnemonics[static_cast<std::uint8_t>(instruction.OpCode)];
 		if (instruction.HasOperand()) {
 			stream << " 0x" << Hex(instruction.Operand);
 		}
@@ -39,14 +40,26 @@ namespace svm {
 }
 
 namespace svm {
-	Instructions::Instructions(std::vector<std::uint64_t> labels, std::vector<Instruction> instructions) noexcept
-		: m_Labels(std::move(labels)), m_Instructions(std::move(instructions)) {}
+	Instructions::Instructions(std::vector<std::uint64_t> labels, std::vector<Instruction> instructions)
+		: m_Labels(std::move(labels)), m_Instructions(std::move(instructions)) {
+		// The file offsets are only needed to report exceptions, so they are kept apart from the instructions.
+		m_Offsets.reserve(m_Instructions.size() + 1);
+
+		std::uint64_t nextOffset = 0;
+		for (const Instruction& inst : m_Instructions) {
+			m_Offsets.push_back(nextOffset);
+			nextOffset += inst.HasOperand() ? 5 : 1;
+		}
+		m_Offsets.push_back(nextOffset);
+	}
 	Instructions::Instructions(Instructions&& instructions) noexcept
-		: m_Labels(std::move(instructions.m_Labels)), m_Instructions(std::move(instructions.m_Instructions)) {}
+		: m_Labels(std::move(instructions.m_Labels)), m_Instructions(std::move(instructions.m_Instructions)),
+		m_Offsets(std::move(instructions.m_Offsets)) {}
 
 	Instructions& Instructions::operator=(Instructions&& instructions) noexcept {
 		m_Labels = std::move(instructions.m_Labels);
 		m_Instructions = std::move(instructions.m_Instructions);
+		m_Offsets = std::move(instructions.m_Offsets);
 		return *this;
 	}
 	const Instruction& Instructions::operator[](std::uint64_t offset) const noexcept {
@@ -56,6 +69,7 @@ namespace svm {
 	void Instructions::Clear() noexcept {
 		m_Labels.clear();
 		m_Instructions.clear();
+		m_Offsets.clear();
 	}
 	bool Instructions::IsEmpty() const noexcept {
 		return m_Labels.empty() && m_Instructions.empty();
@@ -67,6 +81,9 @@ namespace svm {
 	const Instruction& Instructions::GetInstruction(std::uint64_t offset) const noexcept {
 		return m_Instructions[static_cast<std::size_t>(offset)];
 	}
+	std::uint64_t Instructions::GetOffset(std::uint64_t index) const noexcept {
+		return m_Offsets[static_cast<std::size_t>(index)];
+	}
 	std::uint32_t Instructions::GetLabelCount() const noexcept {
 		return static_cast<std::uint32_t>(m_Labels.size());
 	}
@@ -91,10 +108,10 @@ namespace svm {
 		for (std::uint32_t i = 0; i < labelCount; ++i) {
 			const std::uint64_t label = instructions.GetLabel(i);
 			
-			stream << '\n' << defIndent << "\t\t[" << i << "]: " << label << '(' << QWord(instructions.GetInstruction(label).Offset) << ')';
+			stream << '\n' << defIndent << "\t\t[" << i << "]: " << label << '(' << QWord(instructions.GetOffset(label)) << ')';
 		}
 		for (std::uint64_t i = 0; i < instCount; ++i) {
-			stream << '\n' << defIndent << '\t' << instructions.GetInstruction(i);
+			stream << '\n' << defIndent << '\t' << QWord(instructions.GetOffset(i)) << ": " << instructions.GetInstruction(i);
 		}
 
 		return stream;
@@ -1,23 +1,35 @@
 #include <svm/Interpreter.hpp>
 
 #include <svm/Object.hpp>
+#include <svm/Optimizer.hpp>
 #include <svm/detail/InterpreterExceptionCode.hpp>
+#include <svm/detail/ParallelFor.hpp>
 
 #include <utility>
 
 namespace svm {
-	Interpreter::Interpreter(ByteFile&& byteFile) noexcept
+	Interpreter::Interpreter(ByteFile&& byteFile)
 		: m_ByteFile(std::move(byteFile)) {
 		m_StackFrame.Instructions = &m_ByteFile.GetEntryPoint();
+
+		DecodeByteFile();
 	}
 	Interpreter::Interpreter(Interpreter&& interpreter) noexcept
-		: m_ByteFile(std::move(interpreter.m_ByteFile)), m_Exception(std::move(interpreter.m_Exception)),
+		: m_ByteFile(std::move(interpreter.m_ByteFile)), m_OriginalInstructions(std::move(interpreter.m_OriginalInstructions)),
+		m_InstructionOrigins(std::move(interpreter.m_InstructionOrigins)), m_Exception(std::move(interpreter.m_Exception)),
 		m_Stack(std::move(interpreter.m_Stack)), m_StackFrame(interpreter.m_StackFrame), m_Depth(interpreter.m_Depth),
 		m_LocalVariables(std::move(interpreter.m_LocalVariables)),
-		m_Heap(std::move(interpreter.m_Heap)) {}
+		m_Heap(std::move(interpreter.m_Heap)),
+		m_Engine(interpreter.m_Engine), m_DecodedEntryPoint(std::move(interpreter.m_DecodedEntryPoint)),
+		m_DecodedFunctions(std::move(interpreter.m_DecodedFunctions)), m_VerifierErrors(std::move(interpreter.m_VerifierErrors)),
+		m_EntryPointProfile(std::move(interpreter.m_EntryPointProfile)), m_FunctionProfiles(std::move(interpreter.m_FunctionProfiles)),
+		m_CurrentTier(interpreter.m_CurrentTier), m_RegisterThreshold(interpreter.m_RegisterThreshold), m_NativeThreshold(interpreter.m_NativeThreshold),
+		m_AotFunctions(std::move(interpreter.m_AotFunctions)), m_Profiler(interpreter.m_Profiler) {}
 
 	Interpreter& Interpreter::operator=(Interpreter&& interpreter) noexcept {
 		m_ByteFile = std::move(interpreter.m_ByteFile);
+		m_OriginalInstructions = std::move(interpreter.m_OriginalInstructions);
+		m_InstructionOrigins = std::move(interpreter.m_InstructionOrigins);
 		m_Exception = std::move(interpreter.m_Exception);
 
 		m_Stack = std::move(interpreter.m_Stack);
@@ -28,11 +40,26 @@ namespace svm {
 
 		m_Heap = std::move(interpreter.m_Heap);
 
+		m_Engine = interpreter.m_Engine;
+		m_DecodedEntryPoint = std::move(interpreter.m_DecodedEntryPoint);
+		m_DecodedFunctions = std::move(interpreter.m_DecodedFunctions);
+		m_VerifierErrors = std::move(interpreter.m_VerifierErrors);
+		m_EntryPointProfile = std::move(interpreter.m_EntryPointProfile);
+		m_FunctionProfiles = std::move(interpreter.m_FunctionProfiles);
+		m_CurrentTier = interpreter.m_CurrentTier;
+		m_RegisterThreshold = interpreter.m_RegisterThreshold;
+		m_NativeThreshold = interpreter.m_NativeThreshold;
+		m_AotFunctions = std::move(interpreter.m_AotFunctions);
+
+		m_Profiler = interpreter.m_Profiler;
+
 		return *this;
 	}
 
 	void Interpreter::Clear() noexcept {
 		m_ByteFile.Clear();
+		m_OriginalInstructions.clear();
+		m_InstructionOrigins.clear();
 		m_Exception.reset();
 
 		m_Stack.Deallocate();
@@ -42,14 +69,32 @@ namespace svm {
 		m_LocalVariables.clear();
 
 		m_Heap.Deallocate();
+
+		m_DecodedEntryPoint.clear();
+		m_DecodedFunctions.clear();
+		m_VerifierErrors.clear();
+		m_EntryPointProfile = {};
+		m_FunctionProfiles.clear();
+		m_CurrentTier = ExecutionTier::Interpreted;
+		m_AotFunctions.clear();
+
+		m_Profiler = nullptr;
 	}
-	void Interpreter::Load(ByteFile&& byteFile) noexcept {
+	void Interpreter::Load(ByteFile&& byteFile) {
 		m_ByteFile = std::move(byteFile);
 		m_StackFrame.Instructions = &m_ByteFile.GetEntryPoint();
+
+		DecodeByteFile();
 	}
 	const ByteFile& Interpreter::GetByteFile() const noexcept {
 		return m_ByteFile;
 	}
+	const std::vector<InterpreterException>& Interpreter::GetVerifierErrors() const noexcept {
+		return m_VerifierErrors;
+	}
+	const DecodedInstructions& Interpreter::GetDecodedInstructions(std::size_t index) const noexcept {
+		return index == 0 ? m_DecodedEntryPoint : m_DecodedFunctions[index - 1];
+	}
 
 	void Interpreter::AllocateStack(std::size_t size) {
 		m_Stack.Allocate(size);
@@ -60,79 +105,46 @@ namespace svm {
 	void Interpreter::SetGarbageCollector(std::unique_ptr<GarbageCollector>&& gc) noexcept {
 		m_Heap.SetGarbageCollector(std::move(gc));
 	}
+	InterpreterEngine Interpreter::GetEngine() const noexcept {
+		return m_Engine;
+	}
+	void Interpreter::SetEngine(InterpreterEngine newEngine) noexcept {
+		m_Engine = newEngine;
+	}
+	std::uint64_t Interpreter::GetRegisterThreshold() const noexcept {
+		return m_RegisterThreshold;
+	}
+	void Interpreter::SetRegisterThreshold(std::uint64_t newRegisterThreshold) noexcept {
+		m_RegisterThreshold = newRegisterThreshold;
+	}
+	std::uint64_t Interpreter::GetNativeThreshold() const noexcept {
+		return m_NativeThreshold;
+	}
+	void Interpreter::SetNativeThreshold(std::uint64_t newNativeThreshold) noexcept {
+		m_NativeThreshold = newNativeThreshold;
+	}
+	void Interpreter::SetAotFunctions(std::vector<AotFunction>&& newAotFunctions) noexcept {
+		m_AotFunctions = std::move(newAotFunctions);
+	}
+	NGramProfiler* Interpreter::GetProfiler() const noexcept {
+		return m_Profiler;
+	}
+	void Interpreter::SetProfiler(NGramProfiler* newProfiler) noexcept {
+		m_Profiler = newProfiler;
+	}
 
 	bool Interpreter::Interpret() {
-		for (; m_StackFrame.Caller < m_StackFrame.Instructions->GetInstructionCount(); ++m_StackFrame.Caller) {
-			const Instruction& inst = m_StackFrame.Instructions->GetInstruction(m_StackFrame.Caller);
-			switch (inst.OpCode) {
-			case OpCode::Push: InterpretPush(inst.Operand); break;
-			case OpCode::Pop: InterpretPop(); break;
-			case OpCode::Load: InterpretLoad(inst.Operand); break;
-			case OpCode::Store: InterpretStore(inst.Operand); break;
-			case OpCode::Lea: InterpretLea(inst.Operand); break;
-			case OpCode::FLea: InterpretFLea(inst.Operand); break;
-			case OpCode::TLoad: InterpretTLoad(); break;
-			case OpCode::TStore: InterpretTStore(); break;
-			case OpCode::Copy: InterpretCopy(); break;
-			case OpCode::Swap: InterpretSwap(); break;
-
-			case OpCode::Add: InterpretAdd(); break;
-			case OpCode::Sub: InterpretSub(); break;
-			case OpCode::Mul: InterpretMul(); break;
-			case OpCode::IMul: InterpretIMul(); break;
-			case OpCode::Div: InterpretDiv(); break;
-			case OpCode::IDiv: InterpretIDiv(); break;
-			case OpCode::Mod: InterpretMod(); break;
-			case OpCode::IMod: InterpretIMod(); break;
-			case OpCode::Neg: InterpretNeg(); break;
-			case OpCode::Inc: InterpretIncDec(1); break;
-			case OpCode::Dec: InterpretIncDec(-1); break;
-
-			case OpCode::And: InterpretAnd(); break;
-			case OpCode::Or: InterpretOr(); break;
-			case OpCode::Xor: InterpretXor(); break;
-			case OpCode::Not: InterpretNot(); break;
-			case OpCode::Shl: InterpretShl(); break;
-			case OpCode::Sal: InterpretSal(); break;
-			case OpCode::Shr: InterpretShr(); break;
-			case OpCode::Sar: InterpretSar(); break;
-
-			case OpCode::Cmp: InterpretCmp(); break;
-			case OpCode::ICmp: InterpretICmp(); break;
-			case OpCode::Jmp: InterpretJmp(inst.Operand); break;
-			case OpCode::Je: InterpretJe(inst.Operand); break;
-			case OpCode::Jne: InterpretJne(inst.Operand); break;
-			case OpCode::Ja: InterpretJa(inst.Operand); break;
-			case OpCode::Jae: InterpretJae(inst.Operand); break;
-			case OpCode::Jb: InterpretJb(inst.Operand); break;
-			case OpCode::Jbe: InterpretJbe(inst.Operand); break;
-			case OpCode::Call: InterpretCall(inst.Operand); break;
-			case OpCode::Ret: InterpretRet(); break;
-
-			case OpCode::ToI: InterpretToI(); break;
-			case OpCode::ToL: InterpretToL(); break;
-			case OpCode::ToD: InterpretToD(); break;
-
-			case OpCode::Null: InterpretNull(); break;
-			case OpCode::New: InterpretNew(inst.Operand); break;
-			case OpCode::Delete: InterpretDelete(); break;
-			case OpCode::GCNull: InterpretGCNull(); break;
-			case OpCode::GCNew: InterpretGCNew(inst.Operand); break;
-
-			case OpCode::APush: InterpretAPush(inst.Operand); break;
-			case OpCode::ANew: InterpretANew(inst.Operand); break;
-			case OpCode::AGCNew: InterpretAGCNew(inst.Operand); break;
-			case OpCode::ALea: InterpretALea(); break;
-			case OpCode::Count: InterpretCount(); break;
-			}
-
-			if (m_Exception.has_value()) return false;
+		// The entry point is counted as a call so that it can start in a faster tier
+		RecordCall();
+
+		// Opcode traces are recorded by the switch engine only
+		switch (m_Profiler ? InterpreterEngine::Switch : m_Engine) {
+		case InterpreterEngine::Threaded: return InterpretThreaded();
+		case InterpreterEngine::Register:
+		case InterpreterEngine::Jit: return InterpretRegister();
+		case InterpreterEngine::Aot: return InterpretAot();
+		default: return InterpretSwitch();
 		}
-
-		if (m_Depth != 0) {
-			OccurException(SVM_IEC_FUNCTION_NORETINSTRUCTION);
-			return false;
-		} else return true;
 	}
 	bool Interpreter::HasResult() const noexcept {
 		return m_Stack.GetUsedSize();
@@ -223,7 +235,28 @@ namespace svm {
 		if (HasException()) {
 			result[0].Caller = static_cast<std::size_t>(m_Exception->InstructionIndex);
 		}
-		return result;
+		if (m_InstructionOrigins.empty()) return result;
+
+		// Inlined functions have no stack frames, so they are made from the origins of the instructions
+		const Functions& functions = m_ByteFile.GetFunctions();
+		std::vector<StackFrame> expandedResult;
+		for (const StackFrame& frame : result) {
+			const std::size_t index = frame.Function ? static_cast<std::size_t>(frame.Function - functions.data()) + 1 : 0;
+			const InstructionOrigins& origins = m_InstructionOrigins[index];
+			if (frame.Caller >= origins.size()) {
+				expandedResult.push_back(frame);
+				continue;
+			}
+
+			const std::vector<InstructionOrigin>& origin = origins[static_cast<std::size_t>(frame.Caller)];
+			for (auto iter = origin.rbegin(); iter < origin.rend(); ++iter) {
+				StackFrame& inlinedFrame = expandedResult.emplace_back(frame);
+				inlinedFrame.Function = iter->Function ? &functions[iter->Function - 1] : nullptr;
+				inlinedFrame.Instructions = &m_OriginalInstructions[iter->Function];
+				inlinedFrame.Caller = iter->Index;
+			}
+		}
+		return expandedResult;
 	}
 
 	const Type* Interpreter::GetLocalVariable(std::uint32_t index) const noexcept {
@@ -255,12 +288,122 @@ namespace svm {
 	}
 
 	void Interpreter::OccurException(std::uint32_t code) noexcept {
-		InterpreterException& e = m_Exception.emplace();
-		e.Function = m_StackFrame.Function;
-		e.Instructions = m_StackFrame.Instructions;
-		e.InstructionIndex = m_StackFrame.Caller;
+		if (!m_Exception.has_value()) {
+			InterpreterException& e = m_Exception.emplace();
+			e.Function = m_StackFrame.Function;
+			e.Instructions = m_StackFrame.Instructions;
+			e.InstructionIndex = m_StackFrame.Caller;
+
+			// The next dispatch of the threaded engine lands on the trap slot
+			m_StackFrame.Caller = static_cast<std::uint64_t>(-2);
+		}
+
+		m_Exception->Code = code;
+	}
+
+	void Interpreter::DecodeByteFile() {
+		// Functions that no call can reach are never parsed, and are decoded as empty functions
+		m_ByteFile.LoadReachableFunctions();
+
+		// Small functions are spliced into their callers, and the original instructions are kept for the call stacks
+		m_OriginalInstructions.clear();
+		const Instructions& entryPoint = m_ByteFile.GetEntryPoint();
+		m_OriginalInstructions.emplace_back(entryPoint.GetLabels(), entryPoint.GetInstructions());
+		for (const Function& function : m_ByteFile.GetFunctions()) {
+			if (!function.IsLoaded()) {
+				m_OriginalInstructions.emplace_back();
+				continue;
+			}
+
+			const Instructions& instructions = function.GetInstructions();
+			m_OriginalInstructions.emplace_back(instructions.GetLabels(), instructions.GetInstructions());
+		}
+		if (!InlineFunctions(m_ByteFile, &m_InstructionOrigins)) {
+			m_OriginalInstructions.clear();
+			m_InstructionOrigins.clear();
+		}
+
+		// Objects that never leave their stack frame do not need the garbage collector
+		AllocateOnStack(m_ByteFile);
+
+		// Calls followed by ret reuse the stack frame of their caller in every engine
+		OptimizeTailCalls(m_ByteFile);
+
+		DecodeFunctions();
+	}
+	void Interpreter::DecodeFunctions() {
+		const Functions& functions = m_ByteFile.GetFunctions();
+
+		// Instructions proven by the verifier skip their checks in the threaded engine
+		const std::vector<VerifierResult> results = VerifyByteFile(m_ByteFile);
+		m_DecodedEntryPoint = DecodeInstructions(m_ByteFile, m_ByteFile.GetEntryPoint());
+		FuseInstructions(m_DecodedEntryPoint);
+		SpecializeInstructions(m_DecodedEntryPoint, results[0]);
+		m_VerifierErrors = results[0].Errors;
+
+		// Each function is decoded on its own, so they are decoded in parallel
+		const Instructions notLoaded;
+		m_DecodedFunctions.clear();
+		m_DecodedFunctions.resize(functions.size());
+		detail::ParallelFor(functions.size(), [&](std::size_t i) {
+			const Instructions& instructions = functions[i].IsLoaded() ? functions[i].GetInstructions() : notLoaded;
+			DecodedInstructions& decoded = m_DecodedFunctions[i];
+			decoded = DecodeInstructions(m_ByteFile, instructions);
+			FuseInstructions(decoded);
+			SpecializeInstructions(decoded, results[i + 1]);
+		});
+		for (std::size_t i = 0; i < functions.size(); ++i) {
+			const VerifierResult& result = results[i + 1];
+			m_VerifierErrors.insert(m_VerifierErrors.end(), result.Errors.begin(), result.Errors.end());
+		}
+
+		// Register code is translated when each function is promoted and called first
+		m_EntryPointProfile = {};
+		m_FunctionProfiles.clear();
+		m_FunctionProfiles.resize(functions.size());
+	}
+	DecodedInstruction* Interpreter::GetDecodedCode() noexcept {
+		if (m_StackFrame.Function) {
+			const std::size_t index = static_cast<std::size_t>(m_StackFrame.Function - m_ByteFile.GetFunctions().data());
+			return m_DecodedFunctions[index].data() + 1;
+		} else return m_DecodedEntryPoint.data() + 1;
+	}
+
+	FunctionProfile& Interpreter::GetFunctionProfile() noexcept {
+		if (m_StackFrame.Function) {
+			const std::size_t index = static_cast<std::size_t>(m_StackFrame.Function - m_ByteFile.GetFunctions().data());
+			return m_FunctionProfiles[index];
+		} else return m_EntryPointProfile;
+	}
+	void Interpreter::PromoteFunction(FunctionProfile& profile) noexcept {
+		// Only the register and JIT engines have tiers above the interpreter
+		const bool isJit = m_Engine == InterpreterEngine::Jit;
+		if (!isJit && m_Engine != InterpreterEngine::Register) return;
+
+		const std::uint64_t hotness = profile.CallCount + profile.BackEdgeCount;
+		if (isJit && profile.Tier != ExecutionTier::Native && hotness >= m_NativeThreshold) {
+			profile.Tier = ExecutionTier::Native;
+		} else if (profile.Tier == ExecutionTier::Interpreted && hotness >= m_RegisterThreshold) {
+			profile.Tier = ExecutionTier::Register;
+		}
+	}
+	void Interpreter::RecordCall() noexcept {
+		FunctionProfile& profile = GetFunctionProfile();
+		++profile.CallCount;
+		PromoteFunction(profile);
+
+		// A frame runs in the tier its function had when the frame was entered or returned to, or at its last back-edge
+		m_CurrentTier = profile.Tier;
+	}
+	void Interpreter::RecordBackEdge(std::uint64_t target) noexcept {
+		if (target > m_StackFrame.Caller) return;
+
+		FunctionProfile& profile = GetFunctionProfile();
+		++profile.BackEdgeCount;
+		PromoteFunction(profile);
 
-		e.Code = code;
+		// Long-running loops move to the new tier at their next iteration without waiting for the next call
+		m_CurrentTier = profile.Tier;
 	}
 
 	bool Interpreter::IsLocalVariable(std::size_t delta) const noexcept {
@@ -0,0 +1,1184 @@
+#include <svm/JitCompiler.hpp>
+
+#include <svm/Macro.hpp>
+#include <svm/RegisterInstruction.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <initializer_list>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+#ifdef SVM_JIT
+#	include <sys/mman.h>
+#endif
+
+namespace svm {
+	JitCode::JitCode(void* code, std::size_t size, std::vector<std::uint32_t> offsets) noexcept
+		: m_Code(code), m_Size(size), m_Offsets(std::move(offsets)) {}
+	JitCode::JitCode(JitCode&& code) noexcept
+		: m_Code(code.m_Code), m_Size(code.m_Size), m_Offsets(std::move(code.m_Offsets)) {
+		code.m_Code = nullptr;
+		code.m_Size = 0;
+	}
+	JitCode::~JitCode() {
+		Clear();
+	}
+
+	JitCode& JitCode::operator=(JitCode&& code) noexcept {
+		Clear();
+
+		m_Code = code.m_Code;
+		m_Size = code.m_Size;
+		m_Offsets = std::move(code.m_Offsets);
+
+		code.m_Code = nullptr;
+		code.m_Size = 0;
+		return *this;
+	}
+
+	void JitCode::Clear() noexcept {
+#ifdef SVM_JIT
+		if (m_Code) {
+			munmap(m_Code, m_Size);
+		}
+#endif
+		m_Code = nullptr;
+		m_Size = 0;
+		m_Offsets.clear();
+	}
+	bool JitCode::IsEmpty() const noexcept {
+		return m_Code == nullptr;
+	}
+
+	std::uint64_t JitCode::Run(std::size_t instruction, std::uint8_t* frame) const noexcept {
+		using Function = std::uint64_t(*)(std::uint8_t*);
+		return reinterpret_cast<Function>(static_cast<std::uint8_t*>(m_Code) + m_Offsets[instruction])(frame);
+	}
+}
+
+#ifdef SVM_JIT
+namespace {
+	using namespace svm;
+
+	// Native code keeps the frame address in rdi, which is the first argument in the System V calling convention.
+	// rax, rcx, rdx and xmm0-xmm3 are used as scratch registers, and the others hold slots that are allocated to them.
+	enum Register : std::uint8_t {
+		Rax = 0,
+		Rcx = 1,
+		Rdx = 2,
+		Rbx = 3,
+		Rbp = 5,
+		Rsi = 6,
+		R8 = 8,
+		R9 = 9,
+		R10 = 10,
+		R11 = 11,
+		R12 = 12,
+		R13 = 13,
+		R14 = 14,
+		R15 = 15,
+
+		Xmm0 = 0,
+		Xmm1 = 1,
+		Xmm2 = 2,
+		Xmm3 = 3,
+
+		NoRegister = 0xFF,
+	};
+
+	constexpr std::uint8_t RexW = 0x48;
+
+	// Caller-saved registers come first so that short functions do not have to save callee-saved ones
+	constexpr Register AllocatableRegisters[] = { Rsi, R8, R9, R10, R11, Rbx, Rbp, R12, R13, R14, R15 };
+
+	bool IsCalleeSaved(std::uint8_t reg) noexcept {
+		return reg == Rbx || reg == Rbp || reg >= R12;
+	}
+
+	// A slot is either in the frame or in a register
+	struct Location final {
+		std::uint8_t Register = NoRegister;
+		std::int32_t Slot = 0;
+
+		bool IsRegister() const noexcept {
+			return Register != NoRegister;
+		}
+	};
+
+	class Assembler final {
+	private:
+		std::vector<std::uint8_t> m_Code;
+
+	public:
+		std::size_t GetSize() const noexcept {
+			return m_Code.size();
+		}
+		const std::uint8_t* GetCode() const noexcept {
+			return m_Code.data();
+		}
+
+		void Emit(std::initializer_list<std::uint8_t> bytes) {
+			m_Code.insert(m_Code.end(), bytes);
+		}
+		void EmitWide(bool isWide) {
+			if (isWide) {
+				m_Code.push_back(RexW);
+			}
+		}
+		void EmitRex(bool isWide, std::uint8_t reg, std::uint8_t rm) {
+			const std::uint8_t rex = static_cast<std::uint8_t>(0x40 | (isWide ? 0x08 : 0) | ((reg & 8) >> 1) | ((rm & 8) >> 3));
+			if (rex != 0x40) {
+				m_Code.push_back(rex);
+			}
+		}
+		void EmitImmediate32(std::uint32_t immediate) {
+			for (int i = 0; i < 4; ++i) {
+				m_Code.push_back(static_cast<std::uint8_t>(immediate >> (i * 8)));
+			}
+		}
+		void EmitImmediate64(std::uint64_t immediate) {
+			EmitImmediate32(static_cast<std::uint32_t>(immediate));
+			EmitImmediate32(static_cast<std::uint32_t>(immediate >> 32));
+		}
+		// Emits an instruction whose r/m operand is [rdi + displacement]
+		void EmitMemory(std::initializer_list<std::uint8_t> opCode, std::uint8_t reg, std::int32_t displacement) {
+			Emit(opCode);
+			m_Code.push_back(static_cast<std::uint8_t>(0x80 | ((reg & 7) << 3) | 7));
+			EmitImmediate32(static_cast<std::uint32_t>(displacement));
+		}
+		// Emits an instruction whose r/m operand is the location. Legacy prefixes have to be emitted before.
+		void EmitLocation(bool isWide, std::initializer_list<std::uint8_t> opCode, std::uint8_t reg, Location rm) {
+			if (rm.IsRegister()) {
+				EmitRex(isWide, reg, rm.Register);
+				Emit(opCode);
+				m_Code.push_back(static_cast<std::uint8_t>(0xC0 | ((reg & 7) << 3) | (rm.Register & 7)));
+			} else {
+				EmitRex(isWide, reg, 0);
+				EmitMemory(opCode, reg, rm.Slot);
+			}
+		}
+		void EmitPush(std::uint8_t reg) {
+			EmitRex(false, 0, reg);
+			m_Code.push_back(static_cast<std::uint8_t>(0x50 | (reg & 7)));
+		}
+		void EmitPop(std::uint8_t reg) {
+			EmitRex(false, 0, reg);
+			m_Code.push_back(static_cast<std::uint8_t>(0x58 | (reg & 7)));
+		}
+
+		std::size_t EmitShortJump(std::uint8_t opCode) {
+			Emit({ opCode, 0 });
+			return m_Code.size();
+		}
+		void BindShortJump(std::size_t jump) noexcept {
+			m_Code[jump - 1] = static_cast<std::uint8_t>(m_Code.size() - jump);
+		}
+		std::size_t EmitJump(std::initializer_list<std::uint8_t> opCode) {
+			Emit(opCode);
+			EmitImmediate32(0);
+			return m_Code.size();
+		}
+		void BindJump(std::size_t jump, std::size_t target) noexcept {
+			const std::uint32_t displacement = static_cast<std::uint32_t>(static_cast<std::int32_t>(target - jump));
+			std::memcpy(m_Code.data() + jump - 4, &displacement, sizeof(displacement));
+		}
+	};
+
+	// The range of instructions in which a slot lives in a register. Jumps never cross the boundary of a range,
+	// so the slot is loaded when the range is entered by falling through its start and stored when it is left by falling through its end.
+	struct LiveRange final {
+		std::int32_t Slot = 0;
+		std::size_t Start = 0;
+		std::size_t End = 0;
+		std::uint64_t Weight = 0;
+		bool IsWritten = false;
+		bool IsLoaded = true;
+		bool IsExcluded = false;
+		std::uint8_t Register = NoRegister;
+
+		bool Contains(std::size_t index) const noexcept {
+			return Start <= index && index <= End;
+		}
+	};
+
+	bool IsConditionalJump(RegisterOpCode opCode) noexcept {
+		return RegisterOpCode::JeInt <= opCode && opCode <= RegisterOpCode::JbeDouble;
+	}
+	bool IsUnary(RegisterOpCode opCode) noexcept {
+		switch (opCode) {
+		case RegisterOpCode::Move:
+		case RegisterOpCode::NegInt:
+		case RegisterOpCode::NegLong:
+		case RegisterOpCode::NegDouble:
+		case RegisterOpCode::NotInt:
+		case RegisterOpCode::NotLong:
+			return true;
+
+		default:
+			return RegisterOpCode::IntToLong <= opCode && opCode <= RegisterOpCode::DoubleToLong;
+		}
+	}
+	bool IsIncrement(RegisterOpCode opCode) noexcept {
+		return RegisterOpCode::IncInt <= opCode && opCode <= RegisterOpCode::DecDouble;
+	}
+	bool IsIntegerCompare(RegisterOpCode opCode) noexcept {
+		return opCode == RegisterOpCode::CmpInt || opCode == RegisterOpCode::CmpLong || opCode == RegisterOpCode::ICmpInt || opCode == RegisterOpCode::ICmpLong;
+	}
+	bool CanExit(RegisterOpCode opCode) noexcept {
+		return opCode == RegisterOpCode::Exit || (RegisterOpCode::DivInt <= opCode && opCode <= RegisterOpCode::IModLong);
+	}
+	// Instructions that do nothing but write their destinations
+	bool IsRemovable(RegisterOpCode opCode) noexcept {
+		return opCode != RegisterOpCode::Jmp && !IsConditionalJump(opCode) && !CanExit(opCode);
+	}
+
+	bool IsPowerOfTwo(std::uint64_t value) noexcept {
+		return value != 0 && (value & (value - 1)) == 0;
+	}
+	bool IsImmediate(bool isWide, std::uint64_t value) noexcept {
+		return !isWide || static_cast<std::int64_t>(value) == static_cast<std::int32_t>(value);
+	}
+	// Whether the instruction takes the constant as its right operand as an immediate
+	bool IsFoldable(RegisterOpCode opCode, std::uint64_t constant) noexcept {
+		switch (opCode) {
+		case RegisterOpCode::AddInt:
+		case RegisterOpCode::SubInt:
+		case RegisterOpCode::MulInt:
+		case RegisterOpCode::IMulInt:
+		case RegisterOpCode::AndInt:
+		case RegisterOpCode::OrInt:
+		case RegisterOpCode::XorInt:
+		case RegisterOpCode::ShlInt:
+		case RegisterOpCode::ShlLong:
+		case RegisterOpCode::ShrInt:
+		case RegisterOpCode::ShrLong:
+		case RegisterOpCode::SarInt:
+		case RegisterOpCode::SarLong:
+		case RegisterOpCode::CmpInt:
+		case RegisterOpCode::ICmpInt:
+			return true;
+
+		case RegisterOpCode::AddLong:
+		case RegisterOpCode::SubLong:
+		case RegisterOpCode::AndLong:
+		case RegisterOpCode::OrLong:
+		case RegisterOpCode::XorLong:
+		case RegisterOpCode::CmpLong:
+		case RegisterOpCode::ICmpLong:
+			return IsImmediate(true, constant);
+
+		case RegisterOpCode::MulLong:
+		case RegisterOpCode::IMulLong:
+			return IsPowerOfTwo(constant) || IsImmediate(true, constant);
+
+		case RegisterOpCode::DivInt:
+		case RegisterOpCode::ModInt:
+			return IsPowerOfTwo(static_cast<std::uint32_t>(constant));
+		case RegisterOpCode::DivLong:
+			return IsPowerOfTwo(constant);
+		case RegisterOpCode::ModLong:
+			return IsPowerOfTwo(constant) && IsImmediate(true, constant - 1);
+
+		default:
+			return false;
+		}
+	}
+	std::uint8_t Log2(std::uint64_t value) noexcept {
+		std::uint8_t result = 0;
+		while (value >>= 1) {
+			++result;
+		}
+		return result;
+	}
+
+	class Compiler final {
+	private:
+		const RegisterCode& m_Code;
+		Assembler m_Assembler;
+		std::vector<std::uint32_t> m_Offsets;
+		std::vector<std::size_t> m_Labels;
+		std::vector<std::pair<std::size_t, std::uint64_t>> m_Jumps;
+		std::vector<std::size_t> m_EpilogueJumps;
+
+		std::vector<bool> m_IsLabel;
+		std::vector<std::optional<std::uint64_t>> m_Constants;
+		std::vector<bool> m_IsFused;
+		std::vector<bool> m_IsDead;
+		std::vector<LiveRange> m_Ranges;
+		std::unordered_map<std::int32_t, std::size_t> m_RangeIndices;
+		std::vector<std::uint8_t> m_SavedRegisters;
+
+		std::size_t m_Index = 0;
+
+	public:
+		explicit Compiler(const RegisterCode& code) noexcept
+			: m_Code(code) {}
+
+	public:
+		JitCode Compile() {
+			const std::vector<RegisterInstruction>& insts = m_Code.Instructions;
+			m_Offsets.resize(insts.size());
+			m_Labels.resize(insts.size());
+
+			FindLabels();
+			FindConstants();
+			FindFusions();
+			RemoveDeadInstructions();
+			BuildLiveRanges();
+			AllocateRegisters();
+
+			for (m_Index = 0; m_Index < insts.size(); ++m_Index) {
+				const RegisterInstruction& inst = insts[m_Index];
+
+				// Jumps to the instruction skip the loads because the range already holds the slots at their sources
+				for (const LiveRange& range : m_Ranges) {
+					if (range.Register != NoRegister && range.IsLoaded && range.Start == m_Index) {
+						m_Assembler.EmitLocation(true, { 0x8B }, range.Register, { NoRegister, range.Slot });
+					}
+				}
+				m_Labels[m_Index] = m_Assembler.GetSize();
+				m_Offsets[m_Index] = static_cast<std::uint32_t>(m_Labels[m_Index]);
+
+				if (!m_IsDead[m_Index] || m_IsFused[m_Index]) {
+					CompileInstruction(inst);
+				}
+
+				if (inst.OpCode != RegisterOpCode::Exit && inst.OpCode != RegisterOpCode::Jmp) {
+					for (const LiveRange& range : m_Ranges) {
+						if (range.Register != NoRegister && range.IsWritten && range.End == m_Index) {
+							m_Assembler.EmitLocation(true, { 0x89 }, range.Register, { NoRegister, range.Slot });
+						}
+					}
+				}
+			}
+
+			if (std::any_of(m_Ranges.begin(), m_Ranges.end(), [](const LiveRange& range) { return range.Register != NoRegister; })) {
+				CompileEntries();
+			}
+			if (!m_SavedRegisters.empty()) {
+				CompileEpilogue();
+			}
+			for (const auto& [jump, target] : m_Jumps) {
+				m_Assembler.BindJump(jump, m_Labels[static_cast<std::size_t>(target)]);
+			}
+
+			const std::size_t size = m_Assembler.GetSize();
+			void* const code = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (code == MAP_FAILED) return {};
+
+			std::memcpy(code, m_Assembler.GetCode(), size);
+			if (mprotect(code, size, PROT_READ | PROT_EXEC) != 0) {
+				munmap(code, size);
+				return {};
+			}
+			return { code, size, std::move(m_Offsets) };
+		}
+
+	private:
+		void FindLabels() {
+			const std::vector<RegisterInstruction>& insts = m_Code.Instructions;
+			m_IsLabel.assign(insts.size(), false);
+			for (const RegisterInstruction& inst : insts) {
+				if (inst.OpCode == RegisterOpCode::Jmp || IsConditionalJump(inst.OpCode)) {
+					m_IsLabel[static_cast<std::size_t>(inst.Immediate)] = true;
+				}
+			}
+			for (const RegisterEntry& entry : m_Code.Entries) {
+				m_IsLabel[entry.Instruction] = true;
+			}
+		}
+		void FindConstants() {
+			const std::vector<RegisterInstruction>& insts = m_Code.Instructions;
+			m_Constants.resize(insts.size());
+
+			// Constants are followed only in blocks
+			std::unordered_map<std::int32_t, std::uint64_t> constants;
+			for (std::size_t i = 0; i < insts.size(); ++i) {
+				const RegisterInstruction& inst = insts[i];
+				if (m_IsLabel[i]) {
+					constants.clear();
+				}
+
+				const auto find = [&constants](std::int32_t slot) -> std::optional<std::uint64_t> {
+					const auto iter = constants.find(slot);
+					if (iter == constants.end()) return std::nullopt;
+					else return iter->second;
+				};
+				const RegisterOpCode opCode = inst.OpCode;
+				std::optional<std::uint64_t> value;
+				if (opCode == RegisterOpCode::Exit || opCode == RegisterOpCode::Jmp || IsConditionalJump(opCode)) continue;
+				else if (opCode == RegisterOpCode::Const) {
+					value = inst.Immediate;
+				} else if (opCode == RegisterOpCode::Move) {
+					value = find(inst.Left);
+				} else if (!IsIncrement(opCode) && !IsUnary(opCode) && opCode != RegisterOpCode::MoveObject) {
+					m_Constants[i] = find(inst.Right);
+				}
+
+				if (value) {
+					constants[inst.Destination] = *value;
+				} else {
+					constants.erase(inst.Destination);
+				}
+			}
+		}
+		void FindFusions() {
+			// Conditional jumps right after comparisons jump on the flags of the comparisons
+			const std::vector<RegisterInstruction>& insts = m_Code.Instructions;
+			m_IsFused.assign(insts.size(), false);
+			for (std::size_t i = 0; i + 1 < insts.size(); ++i) {
+				const RegisterInstruction& jump = insts[i + 1];
+				m_IsFused[i] = IsIntegerCompare(insts[i].OpCode) && !m_IsLabel[i + 1] && IsConditionalJump(jump.OpCode) &&
+					(static_cast<std::uint8_t>(jump.OpCode) - static_cast<std::uint8_t>(RegisterOpCode::JeInt)) % 3 == 0 && jump.Left == insts[i].Destination;
+			}
+		}
+		void RemoveDeadInstructions() {
+			const std::vector<RegisterInstruction>& insts = m_Code.Instructions;
+			m_IsDead.assign(insts.size(), false);
+
+			std::unordered_map<std::int32_t, std::size_t> slotIndices;
+			for (std::size_t i = 0; i < insts.size(); ++i) {
+				ForEachSlot(i, [&slotIndices](std::int32_t slot, bool) {
+					slotIndices.emplace(slot, slotIndices.size());
+				});
+			}
+
+			// Exits read the slots that their states refer to
+			std::vector<std::vector<bool>> exitUses(m_Code.Exits.size());
+			const auto getExitUses = [&](std::uint64_t exit) -> const std::vector<bool>& {
+				std::vector<bool>& uses = exitUses[static_cast<std::size_t>(exit)];
+				if (uses.empty()) {
+					uses.assign(slotIndices.size(), false);
+					const RegisterState& state = m_Code.Exits[static_cast<std::size_t>(exit)].State;
+					for (const std::vector<RegisterValue>* const values : { &state.Values, &state.LocalVariables }) {
+						for (const RegisterValue& value : *values) {
+							if (const auto iter = slotIndices.find(value.Source); iter != slotIndices.end()) {
+								uses[iter->second] = true;
+							}
+						}
+					}
+				}
+				return uses;
+			};
+
+			// Removing instructions can make the instructions that they read from dead
+			std::vector<std::vector<bool>> liveIns(insts.size() + 1, std::vector<bool>(slotIndices.size()));
+			std::vector<std::vector<bool>> liveOuts(insts.size(), std::vector<bool>(slotIndices.size()));
+			bool isRemoved = true;
+			while (isRemoved) {
+				bool isChanged = true;
+				while (isChanged) {
+					isChanged = false;
+					for (std::size_t i = insts.size(); i-- > 0;) {
+						const RegisterInstruction& inst = insts[i];
+						std::vector<bool> live(slotIndices.size());
+						const auto merge = [&live](const std::vector<bool>& in) {
+							for (std::size_t j = 0; j < live.size(); ++j) {
+								live[j] = live[j] || in[j];
+							}
+						};
+						if (inst.OpCode != RegisterOpCode::Exit && inst.OpCode != RegisterOpCode::Jmp) {
+							merge(liveIns[i + 1]);
+						}
+						if (inst.OpCode == RegisterOpCode::Jmp || IsConditionalJump(inst.OpCode)) {
+							merge(liveIns[static_cast<std::size_t>(inst.Immediate)]);
+						}
+						liveOuts[i] = live;
+
+						ForEachSlot(i, [&](std::int32_t slot, bool isWritten) {
+							if (isWritten) {
+								live[slotIndices[slot]] = false;
+							}
+						});
+						ForEachSlot(i, [&](std::int32_t slot, bool isWritten) {
+							if (!isWritten) {
+								live[slotIndices[slot]] = true;
+							}
+						});
+						if (CanExit(inst.OpCode)) {
+							merge(getExitUses(inst.Immediate));
+						}
+
+						if (live != liveIns[i]) {
+							liveIns[i] = std::move(live);
+							isChanged = true;
+						}
+					}
+				}
+
+				isRemoved = false;
+				for (std::size_t i = 0; i < insts.size(); ++i) {
+					const RegisterInstruction& inst = insts[i];
+					if (!m_IsDead[i] && IsRemovable(inst.OpCode) && !liveOuts[i][slotIndices[inst.Destination]]) {
+						m_IsDead[i] = true;
+						isRemoved = true;
+					}
+				}
+			}
+		}
+		void BuildLiveRanges() {
+			const std::vector<RegisterInstruction>& insts = m_Code.Instructions;
+
+			// Slots used in loops are weighted by the depth of the loops
+			std::vector<int> depthChanges(insts.size() + 1);
+			for (std::size_t i = 0; i < insts.size(); ++i) {
+				const RegisterInstruction& inst = insts[i];
+				if ((inst.OpCode == RegisterOpCode::Jmp || IsConditionalJump(inst.OpCode)) && inst.Immediate <= i) {
+					++depthChanges[static_cast<std::size_t>(inst.Immediate)];
+					--depthChanges[i + 1];
+				}
+			}
+
+			int depth = 0;
+			for (std::size_t i = 0; i < insts.size(); ++i) {
+				depth += depthChanges[i];
+				const std::uint64_t weight = static_cast<std::uint64_t>(1) << std::min(depth * 3, 30);
+				ForEachSlot(i, [&](std::int32_t slot, bool isWritten) {
+					const auto [iter, isInserted] = m_RangeIndices.emplace(slot, m_Ranges.size());
+					if (isInserted) {
+						// Slots that are written first need not be loaded
+						m_Ranges.push_back({ slot, i, i });
+						m_Ranges.back().IsLoaded = !isWritten || CanExit(insts[i].OpCode);
+					}
+
+					LiveRange& range = m_Ranges[iter->second];
+					range.End = i;
+					range.Weight += weight;
+					range.IsWritten |= isWritten;
+
+					// Objects that are not fundamental are copied with their types in the frame
+					range.IsExcluded |= insts[i].OpCode == RegisterOpCode::MoveObject;
+				});
+			}
+
+			// Ranges are extended until no jump enters or leaves them
+			bool isChanged = true;
+			while (isChanged) {
+				isChanged = false;
+				for (std::size_t i = 0; i < insts.size(); ++i) {
+					const RegisterInstruction& inst = insts[i];
+					if (inst.OpCode != RegisterOpCode::Jmp && !IsConditionalJump(inst.OpCode)) continue;
+
+					const std::size_t target = static_cast<std::size_t>(inst.Immediate);
+					for (LiveRange& range : m_Ranges) {
+						if (range.Contains(i) != range.Contains(target)) {
+							range.IsLoaded |= std::min(i, target) < range.Start;
+							range.Start = std::min({ range.Start, i, target });
+							range.End = std::max({ range.End, i, target });
+							isChanged = true;
+						}
+					}
+				}
+			}
+		}
+		void AllocateRegisters() {
+			std::vector<std::size_t> order(m_Ranges.size());
+			for (std::size_t i = 0; i < order.size(); ++i) {
+				order[i] = i;
+			}
+			std::sort(order.begin(), order.end(), [this](std::size_t lhs, std::size_t rhs) {
+				return m_Ranges[lhs].Start < m_Ranges[rhs].Start;
+			});
+
+			// Linear scan. A range that runs out of registers takes the one of the lightest active range,
+			// which is then kept in the frame from its start to its end.
+			std::vector<std::size_t> active;
+			for (const std::size_t index : order) {
+				LiveRange& range = m_Ranges[index];
+				if (range.IsExcluded) continue;
+
+				active.erase(std::remove_if(active.begin(), active.end(), [&](std::size_t i) {
+					return m_Ranges[i].End < range.Start;
+				}), active.end());
+
+				for (const Register reg : AllocatableRegisters) {
+					if (std::none_of(active.begin(), active.end(), [&](std::size_t i) { return m_Ranges[i].Register == reg; })) {
+						range.Register = reg;
+						break;
+					}
+				}
+				if (range.Register == NoRegister) {
+					const auto lightest = std::min_element(active.begin(), active.end(), [this](std::size_t lhs, std::size_t rhs) {
+						return m_Ranges[lhs].Weight < m_Ranges[rhs].Weight;
+					});
+					if (m_Ranges[*lightest].Weight >= range.Weight) continue;
+
+					range.Register = m_Ranges[*lightest].Register;
+					m_Ranges[*lightest].Register = NoRegister;
+					active.erase(lightest);
+				}
+				active.push_back(index);
+			}
+
+			for (const Register reg : AllocatableRegisters) {
+				if (IsCalleeSaved(reg) && std::any_of(m_Ranges.begin(), m_Ranges.end(), [reg](const LiveRange& range) { return range.Register == reg; })) {
+					m_SavedRegisters.push_back(reg);
+				}
+			}
+		}
+		void CompileEntries() {
+			// Native code is entered at the beginning of blocks, where the slots of the ranges that contain them are loaded
+			for (const RegisterEntry& entry : m_Code.Entries) {
+				m_Offsets[entry.Instruction] = static_cast<std::uint32_t>(m_Assembler.GetSize());
+				for (const std::uint8_t reg : m_SavedRegisters) {
+					m_Assembler.EmitPush(reg);
+				}
+				if (m_SavedRegisters.size() % 2) {
+					m_Assembler.EmitPush(Rax);											// Keeps the stack aligned to 16 bytes
+				}
+				for (const LiveRange& range : m_Ranges) {
+					if (range.Register != NoRegister && range.Contains(entry.Instruction)) {
+						m_Assembler.EmitLocation(true, { 0x8B }, range.Register, { NoRegister, range.Slot });
+					}
+				}
+				m_Jumps.emplace_back(m_Assembler.EmitJump({ 0xE9 }), entry.Instruction);
+			}
+		}
+		void CompileEpilogue() {
+			const std::size_t epilogue = m_Assembler.GetSize();
+			if (m_SavedRegisters.size() % 2) {
+				m_Assembler.EmitPop(Rcx);
+			}
+			for (auto iter = m_SavedRegisters.rbegin(); iter != m_SavedRegisters.rend(); ++iter) {
+				m_Assembler.EmitPop(*iter);
+			}
+			m_Assembler.Emit({ 0xC3 });													// ret
+
+			for (const std::size_t jump : m_EpilogueJumps) {
+				m_Assembler.BindJump(jump, epilogue);
+			}
+		}
+
+		Location GetLocation(std::int32_t slot) const noexcept {
+			const auto iter = m_RangeIndices.find(slot);
+			return { iter == m_RangeIndices.end() ? static_cast<std::uint8_t>(NoRegister) : m_Ranges[iter->second].Register, slot };
+		}
+		// Calls the function with each slot that the instruction reads or writes, reads first.
+		// Constants that are taken as immediates and comparisons that jumps use the flags of are not read.
+		template<typename F>
+		void ForEachSlot(std::size_t index, F&& function) const {
+			const RegisterInstruction& inst = m_Code.Instructions[index];
+			const RegisterOpCode opCode = inst.OpCode;
+			if (opCode == RegisterOpCode::Exit || opCode == RegisterOpCode::Jmp) return;
+			else if (IsConditionalJump(opCode)) {
+				if (index == 0 || !m_IsFused[index - 1]) {
+					function(inst.Left, false);
+				}
+				return;
+			} else if (m_IsDead[index] && !m_IsFused[index]) return;
+
+			if (opCode == RegisterOpCode::Const) {
+				function(inst.Destination, true);
+			} else if (IsIncrement(opCode)) {
+				function(inst.Destination, false);
+				function(inst.Destination, true);
+			} else if (IsUnary(opCode) || opCode == RegisterOpCode::MoveObject) {
+				function(inst.Left, false);
+				function(inst.Destination, true);
+			} else {
+				function(inst.Left, false);
+				if (!IsFolded(index)) {
+					function(inst.Right, false);
+				}
+				if (!m_IsDead[index]) {
+					function(inst.Destination, true);
+				}
+			}
+		}
+		bool IsFolded(std::size_t index) const noexcept {
+			const std::optional<std::uint64_t>& constant = m_Constants[index];
+			return constant && IsFoldable(m_Code.Instructions[index].OpCode, *constant);
+		}
+		std::optional<std::uint64_t> GetConstant(bool isWide) const noexcept {
+			const std::optional<std::uint64_t>& constant = m_Constants[m_Index];
+			if (!constant) return std::nullopt;
+			else if (isWide) return constant;
+			else return static_cast<std::uint32_t>(*constant);
+		}
+		std::optional<std::uint64_t> GetFoldedConstant(bool isWide) const noexcept {
+			if (!IsFolded(m_Index)) return std::nullopt;
+			else return GetConstant(isWide);
+		}
+		// Stores the ranges that contain the current instruction for the code that runs outside
+		void EmitSpill(bool isCallerSavedOnly) {
+			for (const LiveRange& range : m_Ranges) {
+				if (range.Register != NoRegister && range.IsWritten && range.Contains(m_Index) && !(isCallerSavedOnly && IsCalleeSaved(range.Register))) {
+					m_Assembler.EmitLocation(true, { 0x89 }, range.Register, { NoRegister, range.Slot });
+				}
+			}
+		}
+		void EmitReload() {
+			for (const LiveRange& range : m_Ranges) {
+				if (range.Register != NoRegister && range.Contains(m_Index) && !IsCalleeSaved(range.Register)) {
+					m_Assembler.EmitLocation(true, { 0x8B }, range.Register, { NoRegister, range.Slot });
+				}
+			}
+		}
+
+	private:
+		void CompileInstruction(const RegisterInstruction& inst) {
+			Assembler& a = m_Assembler;
+			switch (inst.OpCode) {
+			case RegisterOpCode::Exit:
+				EmitExit(inst.Immediate);
+				break;
+
+			case RegisterOpCode::Const: {
+				const Location destination = GetLocation(inst.Destination);
+				if (destination.IsRegister() && inst.Immediate <= 0xFFFFFFFF) {
+					a.EmitRex(false, 0, destination.Register);
+					a.Emit({ static_cast<std::uint8_t>(0xB8 | (destination.Register & 7)) });		// mov r32, immediate
+					a.EmitImmediate32(static_cast<std::uint32_t>(inst.Immediate));
+				} else if (static_cast<std::int64_t>(inst.Immediate) == static_cast<std::int32_t>(inst.Immediate)) {
+					a.EmitLocation(true, { 0xC7 }, 0, destination);
+					a.EmitImmediate32(static_cast<std::uint32_t>(inst.Immediate));
+				} else {
+					EmitLoadImmediate(inst.Immediate);
+					EmitStore(true, Rax, inst.Destination);
+				}
+				break;
+			}
+			case RegisterOpCode::Move:
+				if (const Location destination = GetLocation(inst.Destination); destination.IsRegister()) {
+					EmitLoad(true, destination.Register, inst.Left);
+				} else if (const Location source = GetLocation(inst.Left); source.IsRegister()) {
+					EmitStore(true, source.Register, inst.Destination);
+				} else {
+					EmitLoad(true, Rax, inst.Left);
+					EmitStore(true, Rax, inst.Destination);
+				}
+				break;
+			case RegisterOpCode::MoveObject:
+				a.EmitMemory({ 0x0F, 0x10 }, Xmm0, inst.Left - static_cast<std::int32_t>(sizeof(Type)));
+				a.EmitMemory({ 0x0F, 0x11 }, Xmm0, inst.Destination - static_cast<std::int32_t>(sizeof(Type)));
+				break;
+
+			case RegisterOpCode::AddInt: EmitBinary(false, 0x03, inst); break;
+			case RegisterOpCode::AddLong: EmitBinary(true, 0x03, inst); break;
+			case RegisterOpCode::AddDouble: EmitBinaryDouble(0x58, inst); break;
+			case RegisterOpCode::SubInt: EmitBinary(false, 0x2B, inst); break;
+			case RegisterOpCode::SubLong: EmitBinary(true, 0x2B, inst); break;
+			case RegisterOpCode::SubDouble: EmitBinaryDouble(0x5C, inst); break;
+			case RegisterOpCode::MulInt:
+			case RegisterOpCode::IMulInt: EmitMultiply(false, inst); break;
+			case RegisterOpCode::MulLong:
+			case RegisterOpCode::IMulLong: EmitMultiply(true, inst); break;
+			case RegisterOpCode::MulDouble: EmitBinaryDouble(0x59, inst); break;
+			case RegisterOpCode::DivInt: EmitDivision(false, false, Rax, inst); break;
+			case RegisterOpCode::DivLong: EmitDivision(true, false, Rax, inst); break;
+			case RegisterOpCode::DivDouble:
+				EmitDoubleDivisorCheck(inst);
+				EmitLoadDouble(Xmm0, inst.Left);
+				a.Emit({ 0xF2, 0x0F, 0x5E, 0xC1 });							// divsd xmm0, xmm1
+				EmitStoreDouble(Xmm0, inst.Destination);
+				break;
+			case RegisterOpCode::IDivInt: EmitDivision(false, true, Rax, inst); break;
+			case RegisterOpCode::IDivLong: EmitDivision(true, true, Rax, inst); break;
+			case RegisterOpCode::ModInt: EmitDivision(false, false, Rdx, inst); break;
+			case RegisterOpCode::ModLong: EmitDivision(true, false, Rdx, inst); break;
+			case RegisterOpCode::ModDouble:
+				EmitDoubleDivisorCheck(inst);
+				EmitLoadDouble(Xmm0, inst.Left);
+				EmitSpill(true);
+				a.Emit({ 0x57 });												// push rdi
+				EmitLoadImmediate(reinterpret_cast<std::uint64_t>(static_cast<double(*)(double, double)>(std::fmod)));
+				a.Emit({ 0xFF, 0xD0 });										// call rax
+				a.Emit({ 0x5F });												// pop rdi
+				EmitReload();
+				EmitStoreDouble(Xmm0, inst.Destination);
+				break;
+			case RegisterOpCode::IModInt: EmitDivision(false, true, Rdx, inst); break;
+			case RegisterOpCode::IModLong: EmitDivision(true, true, Rdx, inst); break;
+			case RegisterOpCode::NegInt: EmitUnary(false, 3, inst); break;
+			case RegisterOpCode::NegLong: EmitUnary(true, 3, inst); break;
+			case RegisterOpCode::NegDouble:
+				EmitLoad(true, Rax, inst.Left);
+				a.Emit({ RexW, 0x0F, 0xBA, 0xF8, 0x3F });						// btc rax, 63
+				EmitStore(true, Rax, inst.Destination);
+				break;
+			case RegisterOpCode::IncInt: EmitIncrement(false, 0, inst); break;
+			case RegisterOpCode::IncLong: EmitIncrement(true, 0, inst); break;
+			case RegisterOpCode::IncDouble: EmitIncrementDouble(0x58, inst); break;
+			case RegisterOpCode::DecInt: EmitIncrement(false, 5, inst); break;
+			case RegisterOpCode::DecLong: EmitIncrement(true, 5, inst); break;
+			case RegisterOpCode::DecDouble: EmitIncrementDouble(0x5C, inst); break;
+
+			case RegisterOpCode::AndInt: EmitBinary(false, 0x23, inst); break;
+			case RegisterOpCode::AndLong: EmitBinary(true, 0x23, inst); break;
+			case RegisterOpCode::OrInt: EmitBinary(false, 0x0B, inst); break;
+			case RegisterOpCode::OrLong: EmitBinary(true, 0x0B, inst); break;
+			case RegisterOpCode::XorInt: EmitBinary(false, 0x33, inst); break;
+			case RegisterOpCode::XorLong: EmitBinary(true, 0x33, inst); break;
+			case RegisterOpCode::NotInt: EmitUnary(false, 2, inst); break;
+			case RegisterOpCode::NotLong: EmitUnary(true, 2, inst); break;
+			case RegisterOpCode::ShlInt: EmitShift(false, 4, inst); break;
+			case RegisterOpCode::ShlLong: EmitShift(true, 4, inst); break;
+			case RegisterOpCode::ShrInt: EmitShift(false, 5, inst); break;
+			case RegisterOpCode::ShrLong: EmitShift(true, 5, inst); break;
+			case RegisterOpCode::SarInt: EmitShift(false, 7, inst); break;
+			case RegisterOpCode::SarLong: EmitShift(true, 7, inst); break;
+
+			case RegisterOpCode::CmpInt: EmitCompare(false, false, inst); break;
+			case RegisterOpCode::CmpLong: EmitCompare(true, false, inst); break;
+			case RegisterOpCode::ICmpInt: EmitCompare(false, true, inst); break;
+			case RegisterOpCode::ICmpLong: EmitCompare(true, true, inst); break;
+			case RegisterOpCode::CmpDouble: {
+				EmitLoadDouble(Xmm0, inst.Left);
+				EmitDoubleOperation(0x66, 0x2E, Xmm0, inst.Right);				// ucomisd xmm0, right
+				a.Emit({ 0xB8 });												// mov eax, -1
+				a.EmitImmediate32(static_cast<std::uint32_t>(-1));
+				const std::size_t unordered = a.EmitShortJump(0x7A);			// jp
+				a.Emit({ 0xB9 });												// mov ecx, 1
+				a.EmitImmediate32(1);
+				a.Emit({ 0x0F, 0x47, 0xC1 });									// cmova eax, ecx
+				a.Emit({ 0xB9 });												// mov ecx, 0
+				a.EmitImmediate32(0);
+				a.Emit({ 0x0F, 0x44, 0xC1 });									// cmove eax, ecx
+				a.BindShortJump(unordered);
+				EmitStore(false, Rax, inst.Destination);
+				break;
+			}
+
+			case RegisterOpCode::IntToLong:
+				EmitLoad(false, Rax, inst.Left);
+				EmitStore(true, Rax, inst.Destination);
+				break;
+			case RegisterOpCode::IntToDouble:
+				EmitLoad(false, Rax, inst.Left);
+				a.Emit({ 0xF2, RexW, 0x0F, 0x2A, 0xC0 });						// cvtsi2sd xmm0, rax
+				EmitStoreDouble(Xmm0, inst.Destination);
+				break;
+			case RegisterOpCode::LongToInt:
+				EmitLoad(false, Rax, inst.Left);
+				EmitStore(false, Rax, inst.Destination);
+				break;
+			case RegisterOpCode::LongToDouble: {
+				// Unsigned integers that do not fit in signed ones are halved with the lowest bit kept for rounding
+				EmitLoad(true, Rax, inst.Left);
+				a.Emit({ RexW, 0x85, 0xC0 });									// test rax, rax
+				const std::size_t large = a.EmitShortJump(0x78);				// js
+				a.Emit({ 0xF2, RexW, 0x0F, 0x2A, 0xC0 });						// cvtsi2sd xmm0, rax
+				const std::size_t done = a.EmitShortJump(0xEB);				// jmp
+				a.BindShortJump(large);
+				a.Emit({ RexW, 0x89, 0xC1 });									// mov rcx, rax
+				a.Emit({ RexW, 0xD1, 0xE9 });									// shr rcx, 1
+				a.Emit({ RexW, 0x83, 0xE0, 0x01 });							// and rax, 1
+				a.Emit({ RexW, 0x09, 0xC1 });									// or rcx, rax
+				a.Emit({ 0xF2, RexW, 0x0F, 0x2A, 0xC1 });						// cvtsi2sd xmm0, rcx
+				a.Emit({ 0xF2, 0x0F, 0x58, 0xC0 });							// addsd xmm0, xmm0
+				a.BindShortJump(done);
+				EmitStoreDouble(Xmm0, inst.Destination);
+				break;
+			}
+			case RegisterOpCode::DoubleToInt:
+				EmitLoadDouble(Xmm0, inst.Left);
+				a.Emit({ 0xF2, RexW, 0x0F, 0x2C, 0xC0 });						// cvttsd2si rax, xmm0
+				EmitStore(false, Rax, inst.Destination);
+				break;
+			case RegisterOpCode::DoubleToLong: {
+				// Doubles that do not fit in signed integers are converted after subtracting 2^63
+				EmitLoadDouble(Xmm0, inst.Left);
+				EmitLoadDouble(Xmm1, 9223372036854775808.0);
+				a.Emit({ 0x66, 0x0F, 0x2F, 0xC1 });							// comisd xmm0, xmm1
+				const std::size_t large = a.EmitShortJump(0x73);				// jae
+				a.Emit({ 0xF2, RexW, 0x0F, 0x2C, 0xC0 });						// cvttsd2si rax, xmm0
+				const std::size_t done = a.EmitShortJump(0xEB);				// jmp
+				a.BindShortJump(large);
+				a.Emit({ 0xF2, 0x0F, 0x5C, 0xC1 });							// subsd xmm0, xmm1
+				a.Emit({ 0xF2, RexW, 0x0F, 0x2C, 0xC0 });						// cvttsd2si rax, xmm0
+				a.Emit({ RexW, 0x0F, 0xBA, 0xF8, 0x3F });						// btc rax, 63
+				a.BindShortJump(done);
+				EmitStore(true, Rax, inst.Destination);
+				break;
+			}
+
+			case RegisterOpCode::Jmp:
+				m_Jumps.emplace_back(a.EmitJump({ 0xE9 }), inst.Immediate);
+				break;
+			case RegisterOpCode::JeInt: EmitJump(false, 0x00, true, inst); break;
+			case RegisterOpCode::JeLong: EmitJump(true, 0x00, true, inst); break;
+			case RegisterOpCode::JeDouble: EmitJumpDouble(0, true, inst); break;
+			case RegisterOpCode::JneInt: EmitJump(false, 0x00, false, inst); break;
+			case RegisterOpCode::JneLong: EmitJump(true, 0x00, false, inst); break;
+			case RegisterOpCode::JneDouble: EmitJumpDouble(0, false, inst); break;
+			case RegisterOpCode::JaInt: EmitJump(false, 0x01, true, inst); break;
+			case RegisterOpCode::JaLong: EmitJump(true, 0x01, true, inst); break;
+			case RegisterOpCode::JaDouble: EmitJumpDouble(1, true, inst); break;
+			case RegisterOpCode::JaeInt: EmitJump(false, 0xFF, false, inst); break;
+			case RegisterOpCode::JaeLong: EmitJump(true, 0xFF, false, inst); break;
+			case RegisterOpCode::JaeDouble: EmitJumpDouble(-1, false, inst); break;
+			case RegisterOpCode::JbInt: EmitJump(false, 0xFF, true, inst); break;
+			case RegisterOpCode::JbLong: EmitJump(true, 0xFF, true, inst); break;
+			case RegisterOpCode::JbDouble: EmitJumpDouble(-1, true, inst); break;
+			case RegisterOpCode::JbeInt: EmitJump(false, 0x01, false, inst); break;
+			case RegisterOpCode::JbeLong: EmitJump(true, 0x01, false, inst); break;
+			case RegisterOpCode::JbeDouble: EmitJumpDouble(1, false, inst); break;
+			}
+		}
+
+		void EmitExit(std::uint64_t exit) {
+			EmitSpill(false);
+			m_Assembler.Emit({ 0xB8 });											// mov eax, exit
+			m_Assembler.EmitImmediate32(static_cast<std::uint32_t>(exit));
+			if (m_SavedRegisters.empty()) {
+				m_Assembler.Emit({ 0xC3 });										// ret
+			} else {
+				m_EpilogueJumps.push_back(m_Assembler.EmitJump({ 0xE9 }));
+			}
+		}
+		void EmitLoad(bool isWide, std::uint8_t reg, std::int32_t slot) {
+			const Location source = GetLocation(slot);
+			if (source.Register == reg) return;
+
+			m_Assembler.EmitLocation(isWide, { 0x8B }, reg, source);
+		}
+		void EmitStore(bool isWide, std::uint8_t reg, std::int32_t slot) {
+			const Location destination = GetLocation(slot);
+			if (destination.Register == reg) return;
+
+			m_Assembler.EmitLocation(isWide, { 0x89 }, reg, destination);
+		}
+		void EmitLoadImmediate(std::uint64_t immediate) {
+			m_Assembler.Emit({ RexW, 0xB8 });									// mov rax, immediate
+			m_Assembler.EmitImmediate64(immediate);
+		}
+		void EmitLoadDouble(Register reg, double value) {
+			std::uint64_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			EmitLoadImmediate(bits);
+			m_Assembler.Emit({ 0x66, RexW, 0x0F, 0x6E, static_cast<std::uint8_t>(0xC0 | (reg << 3)) });	// movq reg, rax
+		}
+		void EmitLoadDouble(Register reg, std::int32_t slot) {
+			if (const Location source = GetLocation(slot); source.IsRegister()) {
+				m_Assembler.Emit({ 0x66 });
+				m_Assembler.EmitLocation(true, { 0x0F, 0x6E }, reg, source);	// movq reg, r64
+			} else {
+				m_Assembler.EmitMemory({ 0xF2, 0x0F, 0x10 }, reg, slot);
+			}
+		}
+		void EmitStoreDouble(Register reg, std::int32_t slot) {
+			if (const Location destination = GetLocation(slot); destination.IsRegister()) {
+				m_Assembler.Emit({ 0x66 });
+				m_Assembler.EmitLocation(true, { 0x0F, 0x7E }, reg, destination);	// movq r64, reg
+			} else {
+				m_Assembler.EmitMemory({ 0xF2, 0x0F, 0x11 }, reg, slot);
+			}
+		}
+		// Emits an SSE instruction whose source operand is the slot
+		void EmitDoubleOperation(std::uint8_t prefix, std::uint8_t opCode, Register reg, std::int32_t slot) {
+			if (GetLocation(slot).IsRegister()) {
+				EmitLoadDouble(Xmm3, slot);
+				m_Assembler.Emit({ prefix, 0x0F, opCode, static_cast<std::uint8_t>(0xC0 | (reg << 3) | Xmm3) });
+			} else {
+				m_Assembler.EmitMemory({ prefix, 0x0F, opCode }, reg, slot);
+			}
+		}
+		// Emits an instruction of the group 1 such as add and cmp with an immediate operand
+		void EmitImmediate(bool isWide, std::uint8_t extension, Location location, std::uint64_t immediate) {
+			const std::int32_t value = static_cast<std::int32_t>(immediate);
+			if (value == static_cast<std::int8_t>(value)) {
+				m_Assembler.EmitLocation(isWide, { 0x83 }, extension, location);
+				m_Assembler.Emit({ static_cast<std::uint8_t>(value) });
+			} else {
+				m_Assembler.EmitLocation(isWide, { 0x81 }, extension, location);
+				m_Assembler.EmitImmediate32(static_cast<std::uint32_t>(value));
+			}
+		}
+		// Returns the register that the result is computed in, which is the destination itself if it is the left operand
+		std::uint8_t EmitLoadLeft(bool isWide, const RegisterInstruction& inst) {
+			if (const Location destination = GetLocation(inst.Destination); destination.IsRegister() && inst.Destination == inst.Left) return destination.Register;
+
+			EmitLoad(isWide, Rax, inst.Left);
+			return Rax;
+		}
+
+		void EmitBinary(bool isWide, std::uint8_t opCode, const RegisterInstruction& inst) {
+			const std::uint8_t result = EmitLoadLeft(isWide, inst);
+			if (const std::optional<std::uint64_t> constant = GetFoldedConstant(isWide); constant) {
+				EmitImmediate(isWide, opCode >> 3, { result }, *constant);
+			} else {
+				m_Assembler.EmitLocation(isWide, { opCode }, result, GetLocation(inst.Right));
+			}
+			EmitStore(isWide, result, inst.Destination);
+		}
+		void EmitBinaryDouble(std::uint8_t opCode, const RegisterInstruction& inst) {
+			EmitLoadDouble(Xmm0, inst.Left);
+			EmitDoubleOperation(0xF2, opCode, Xmm0, inst.Right);
+			EmitStoreDouble(Xmm0, inst.Destination);
+		}
+		void EmitMultiply(bool isWide, const RegisterInstruction& inst) {
+			// The lower half of a product does not depend on signedness
+			const std::uint8_t result = EmitLoadLeft(isWide, inst);
+			const std::optional<std::uint64_t> constant = GetFoldedConstant(isWide);
+			if (constant && IsPowerOfTwo(*constant)) {
+				if (*constant != 1) {
+					m_Assembler.EmitLocation(isWide, { 0xC1 }, 4, { result });		// shl result, log2(constant)
+					m_Assembler.Emit({ Log2(*constant) });
+				}
+			} else if (constant) {
+				m_Assembler.EmitLocation(isWide, { 0x69 }, result, { result });		// imul result, result, constant
+				m_Assembler.EmitImmediate32(static_cast<std::uint32_t>(*constant));
+			} else {
+				m_Assembler.EmitLocation(isWide, { 0x0F, 0xAF }, result, GetLocation(inst.Right));
+			}
+			EmitStore(isWide, result, inst.Destination);
+		}
+		void EmitDivision(bool isWide, bool isSigned, Register result, const RegisterInstruction& inst) {
+			Assembler& a = m_Assembler;
+			if (const std::optional<std::uint64_t> constant = GetFoldedConstant(isWide); constant) {
+				// Unsigned division by a power of two is a shift, and its remainder is a mask
+				const std::uint8_t reg = EmitLoadLeft(isWide, inst);
+				if (result == Rdx) {
+					EmitImmediate(isWide, 4, { reg }, *constant - 1);
+				} else if (*constant != 1) {
+					a.EmitLocation(isWide, { 0xC1 }, 5, { reg });						// shr reg, log2(constant)
+					a.Emit({ Log2(*constant) });
+				}
+				EmitStore(isWide, reg, inst.Destination);
+				return;
+			}
+
+			EmitLoad(isWide, Rcx, inst.Right);
+			if (const std::optional<std::uint64_t> constant = GetConstant(isWide); !constant || *constant == 0) {
+				a.EmitWide(isWide);
+				a.Emit({ 0x85, 0xC9 });											// test ecx, ecx
+				const std::size_t nonZero = a.EmitShortJump(0x75);				// jnz
+				EmitExit(inst.Immediate);
+				a.BindShortJump(nonZero);
+			}
+
+			EmitLoad(isWide, Rax, inst.Left);
+			if (isSigned) {
+				a.EmitWide(isWide);
+				a.Emit({ 0x99 });												// cdq or cqo
+				a.EmitWide(isWide);
+				a.Emit({ 0xF7, 0xF9 });											// idiv ecx
+			} else {
+				a.Emit({ 0x31, 0xD2 });											// xor edx, edx
+				a.EmitWide(isWide);
+				a.Emit({ 0xF7, 0xF1 });											// div ecx
+			}
+			EmitStore(isWide, result, inst.Destination);
+		}
+		void EmitDoubleDivisorCheck(const RegisterInstruction& inst) {
+			Assembler& a = m_Assembler;
+			EmitLoadDouble(Xmm1, inst.Right);
+			a.Emit({ 0x66, 0x0F, 0x57, 0xD2 });									// xorpd xmm2, xmm2
+			a.Emit({ 0x66, 0x0F, 0x2E, 0xCA });									// ucomisd xmm1, xmm2
+			const std::size_t unordered = a.EmitShortJump(0x7A);				// jp
+			const std::size_t nonZero = a.EmitShortJump(0x75);					// jne
+			EmitExit(inst.Immediate);
+			a.BindShortJump(unordered);
+			a.BindShortJump(nonZero);
+		}
+		void EmitUnary(bool isWide, std::uint8_t extension, const RegisterInstruction& inst) {
+			const std::uint8_t result = EmitLoadLeft(isWide, inst);
+			m_Assembler.EmitLocation(isWide, { 0xF7 }, extension, { result });
+			EmitStore(isWide, result, inst.Destination);
+		}
+		void EmitIncrement(bool isWide, std::uint8_t extension, const RegisterInstruction& inst) {
+			m_Assembler.EmitLocation(isWide, { 0x83 }, extension, GetLocation(inst.Destination));
+			m_Assembler.Emit({ 0x01 });
+		}
+		void EmitIncrementDouble(std::uint8_t opCode, const RegisterInstruction& inst) {
+			EmitLoadDouble(Xmm0, inst.Destination);
+			EmitLoadDouble(Xmm1, 1.0);
+			m_Assembler.Emit({ 0xF2, 0x0F, opCode, 0xC1 });
+			EmitStoreDouble(Xmm0, inst.Destination);
+		}
+		void EmitShift(bool isWide, std::uint8_t extension, const RegisterInstruction& inst) {
+			if (const std::optional<std::uint64_t> constant = GetFoldedConstant(false); constant) {
+				// The count is masked as the shift with cl does
+				const std::uint8_t result = EmitLoadLeft(isWide, inst);
+				m_Assembler.EmitLocation(isWide, { 0xC1 }, extension, { result });
+				m_Assembler.Emit({ static_cast<std::uint8_t>(*constant & (isWide ? 63 : 31)) });
+				EmitStore(isWide, result, inst.Destination);
+				return;
+			}
+
+			EmitLoad(false, Rcx, inst.Right);
+			const std::uint8_t result = EmitLoadLeft(isWide, inst);
+			m_Assembler.EmitLocation(isWide, { 0xD3 }, extension, { result });
+			EmitStore(isWide, result, inst.Destination);
+		}
+		void EmitCompare(bool isWide, bool isSigned, const RegisterInstruction& inst) {
+			Assembler& a = m_Assembler;
+			const Location left = GetLocation(inst.Left);
+			if (const std::optional<std::uint64_t> constant = GetFoldedConstant(isWide); constant) {
+				EmitImmediate(isWide, 7, left, *constant);						// cmp left, constant
+			} else if (left.IsRegister()) {
+				a.EmitLocation(isWide, { 0x3B }, left.Register, GetLocation(inst.Right));
+			} else {
+				EmitLoad(isWide, Rax, inst.Left);
+				a.EmitLocation(isWide, { 0x3B }, Rax, GetLocation(inst.Right));	// cmp eax, right
+			}
+
+			// Fused jumps need only the flags if the result is not read after them
+			if (m_IsDead[m_Index]) return;
+
+			// The result is made without changing the flags so that the next jump can use them
+			a.Emit({ 0xB9 });													// mov ecx, 0
+			a.EmitImmediate32(0);
+			a.Emit({ 0xBA });													// mov edx, 1
+			a.EmitImmediate32(1);
+			a.Emit({ 0x0F, static_cast<std::uint8_t>(isSigned ? 0x4F : 0x47), 0xCA });	// cmova or cmovg ecx, edx
+			a.Emit({ 0xBA });													// mov edx, -1
+			a.EmitImmediate32(static_cast<std::uint32_t>(-1));
+			a.Emit({ 0x0F, static_cast<std::uint8_t>(isSigned ? 0x4C : 0x42), 0xCA });	// cmovb or cmovl ecx, edx
+			EmitStore(false, Rcx, inst.Destination);
+		}
+		void EmitJump(bool isWide, std::uint8_t value, bool isEqual, const RegisterInstruction& inst) {
+			if (m_Index != 0 && m_IsFused[m_Index - 1]) {
+				// je, jne, ja, jae, jb and jbe on the flags of the comparison
+				static constexpr std::uint8_t unsignedConditions[] = { 0x84, 0x85, 0x87, 0x83, 0x82, 0x86 };
+				static constexpr std::uint8_t signedConditions[] = { 0x84, 0x85, 0x8F, 0x8D, 0x8C, 0x8E };
+
+				const RegisterOpCode compare = m_Code.Instructions[m_Index - 1].OpCode;
+				const bool isSigned = compare == RegisterOpCode::ICmpInt || compare == RegisterOpCode::ICmpLong;
+				const std::size_t relation = (static_cast<std::uint8_t>(inst.OpCode) - static_cast<std::uint8_t>(RegisterOpCode::JeInt)) / 3;
+				m_Jumps.emplace_back(m_Assembler.EmitJump({ 0x0F, (isSigned ? signedConditions : unsignedConditions)[relation] }), inst.Immediate);
+				return;
+			}
+
+			m_Assembler.EmitLocation(isWide, { 0x83 }, 7, GetLocation(inst.Left));	// cmp left, value
+			m_Assembler.Emit({ value });
+			m_Jumps.emplace_back(m_Assembler.EmitJump({ 0x0F, static_cast<std::uint8_t>(isEqual ? 0x84 : 0x85) }), inst.Immediate);
+		}
+		void EmitJumpDouble(int value, bool isEqual, const RegisterInstruction& inst) {
+			Assembler& a = m_Assembler;
+			EmitLoadDouble(Xmm0, inst.Left);
+			if (value == 0) {
+				a.Emit({ 0x66, 0x0F, 0x57, 0xC9 });								// xorpd xmm1, xmm1
+			} else {
+				EmitLoadDouble(Xmm1, static_cast<double>(value));
+			}
+			a.Emit({ 0x66, 0x0F, 0x2E, 0xC1 });									// ucomisd xmm0, xmm1
+
+			// NaN is not equal to anything
+			if (isEqual) {
+				const std::size_t unordered = a.EmitShortJump(0x7A);			// jp
+				m_Jumps.emplace_back(a.EmitJump({ 0x0F, 0x84 }), inst.Immediate);
+				a.BindShortJump(unordered);
+			} else {
+				m_Jumps.emplace_back(a.EmitJump({ 0x0F, 0x8A }), inst.Immediate);
+				m_Jumps.emplace_back(a.EmitJump({ 0x0F, 0x85 }), inst.Immediate);
+			}
+		}
+	};
+}
+#endif
+
+namespace svm {
+	JitCode CompileRegisterCode(const RegisterCode& code) {
+#ifdef SVM_JIT
+		if (code.Instructions.empty()) return {};
+		return Compiler(code).Compile();
+#else
+		static_cast<void>(code);
+		return {};
+#endif
+	}
+}
\ No newline at end of file
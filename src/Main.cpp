@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstdint>
 #include <cstdlib>
 #include <exception>
 #include <iomanip>
@@ -17,7 +18,15 @@ int main(int argc, char* argv[]) {
 	option.AddVariable("stack", 1 * 1024 * 1024)
 		  .AddVariable("young", 8 * 1024 * 1024)
 		  .AddVariable("old", 32 * 1024 * 1024)
-		  .AddFlag("gc", true);
+		  .AddVariable("ngram", 0)
+		  .AddVariable("tier1", 100)
+		  .AddVariable("tier2", 1000)
+		  .AddFlag("gc", true)
+		  .AddFlag("threaded", false)
+		  .AddFlag("register", false)
+		  .AddFlag("jit", false)
+		  .AddFlag("verify", false)
+		  .AddFlag("cache", false);
 
 	if (!option.Parse(argc, argv) || !option.Verity()) {
 		return EXIT_FAILURE;
@@ -35,6 +44,7 @@ int main(int argc, char* argv[]) {
 
 	svm::Parser parser;
 	parser.Load(option.Path);
+
 	try {
 		parser.Parse();
 	} catch (const std::exception & e) {
@@ -43,16 +53,64 @@ int main(int argc, char* argv[]) {
 		return EXIT_FAILURE;
 	}
 
+	// The cache has the byte file after it was optimized, so a warm start skips the optimizer.
+	// Function bodies are parsed when they are needed first, so the byte file is still parsed to be printed the same as a cold start.
+	const bool useCache = option.GetFlag("cache");
+	const std::uint64_t hash = useCache ? parser.GetHash() : 0;
+	svm::Interpreter interpreter;
+	const bool isCached = useCache && interpreter.LoadCache(option.Path, hash);
+
 	const auto endParsing = std::chrono::system_clock::now();
 	const std::chrono::duration<double> parsing = endParsing - startParsing;
 
 	svm::ByteFile byteFile = parser.GetResult();
-	std::cout << "Parsed in " << std::fixed << std::setprecision(6) << parsing.count() << "s!\n"
+	std::cout << (isCached ? "Loaded from the cache in " : "Parsed in ") << std::fixed << std::setprecision(6) << parsing.count() << "s!\n"
 			  << "Result:\n" << std::defaultfloat << svm::Indent << byteFile << "\n----------------------------------------\n";
 
 	const auto startInterpreting = std::chrono::system_clock::now();
 
-	svm::Interpreter interpreter(std::move(byteFile));
+	if (!isCached) {
+		interpreter.Load(std::move(byteFile));
+		if (useCache) {
+			// A cache that cannot be saved only leaves the next start cold
+			try {
+				interpreter.SaveCache(hash);
+			} catch (const std::exception&) {}
+		}
+	}
+	if (const auto& errors = interpreter.GetVerifierErrors(); option.GetFlag("verify") && !errors.empty()) {
+		const auto& funcs = interpreter.GetByteFile().GetFunctions();
+
+		std::cout << "Verification failed!\n";
+		for (const auto& error : errors) {
+			using namespace svm;
+
+			if (error.Function == nullptr) {
+				std::cout << "\tentrypoint";
+			} else {
+				std::cout << "\t[" << std::distance(funcs.data(), error.Function) << ']';
+			}
+			std::cout << '(' << error.InstructionIndex
+					  << '(' << QWord(error.Instructions->GetOffset(error.InstructionIndex)) << ")): "
+					  << '"' << GetInterpreterExceptionMessage(error.Code) << "\"\n";
+		}
+
+		return EXIT_FAILURE;
+	}
+	if (option.GetFlag("jit")) {
+		interpreter.SetEngine(svm::InterpreterEngine::Jit);
+	} else if (option.GetFlag("register")) {
+		interpreter.SetEngine(svm::InterpreterEngine::Register);
+	} else if (option.GetFlag("threaded")) {
+		interpreter.SetEngine(svm::InterpreterEngine::Threaded);
+	}
+	interpreter.SetRegisterThreshold(option.GetVariable("tier1"));
+	interpreter.SetNativeThreshold(option.GetVariable("tier2"));
+
+	svm::NGramProfiler profiler(static_cast<std::size_t>(option.GetVariable("ngram")));
+	if (profiler.GetLength()) {
+		interpreter.SetProfiler(&profiler);
+	}
 	interpreter.AllocateStack(static_cast<std::size_t>(option.GetVariable("stack")));
 	if (option.GetFlag("gc")) {
 		interpreter.SetGarbageCollector(std::make_unique<svm::SimpleGarbageCollector>(
@@ -84,7 +142,7 @@ int main(int argc, char* argv[]) {
 				std::cout << "\t[" << dis << ']';
 			}
 			std::cout << '(' << frame.Caller
-					  << '(' << QWord(frame.Instructions->GetInstruction(frame.Caller).Offset) << "))";
+					  << '(' << QWord(frame.Instructions->GetOffset(frame.Caller)) << "))";
 			if (frame.Function == nullptr) {
 				std::cout << '\n';
 			} else {
@@ -103,6 +161,18 @@ int main(int argc, char* argv[]) {
 		interpreter.PrintObject(std::cout, result, true);
 	}
 
+	if (profiler.GetLength()) {
+		const auto nGrams = profiler.GetMostFrequent(16);
+		const std::uint64_t totalCount = profiler.GetTotalCount();
+
+		std::cout << "\n----------------------------------------\n"
+				  << "Most frequent " << profiler.GetLength() << "-grams:";
+		for (const auto& nGram : nGrams) {
+			std::cout << "\n\t" << nGram.Count << '(' << std::fixed << std::setprecision(2) << nGram.Count * 100.0 / totalCount << "%): "
+					  << std::defaultfloat << nGram;
+		}
+	}
+
 	std::cout << "\n----------------------------------------\n"
 			  << "Total used: " << std::fixed << std::setprecision(6) << parsing.count() + interpreting.count() << "s\n";
 
@@ -0,0 +1,965 @@
+#include <svm/Optimizer.hpp>
+
+#include <svm/ConstantPool.hpp>
+#include <svm/Object.hpp>
+#include <svm/Structure.hpp>
+#include <svm/Type.hpp>
+#include <svm/Verifier.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace svm {
+	namespace {
+		// Calls transform(labels, insts, index) for the entry point(index 0) and the functions(index 1...),
+		// the same order as VerifyByteFile, and stores the instructions back if it returns true. Functions that are not loaded are skipped
+		template<typename F>
+		bool TransformInstructions(ByteFile& byteFile, F&& transform) {
+			bool isChanged = false;
+
+			std::vector<std::uint64_t> labels = byteFile.GetEntryPoint().GetLabels();
+			std::vector<Instruction> insts = byteFile.GetEntryPoint().GetInstructions();
+			if (transform(labels, insts, std::size_t(0))) {
+				byteFile.SetEntryPoint({ std::move(labels), std::move(insts) });
+				isChanged = true;
+			}
+
+			Functions& functions = byteFile.GetFunctions();
+			for (std::size_t i = 0; i < functions.size(); ++i) {
+				if (!functions[i].IsLoaded()) continue;
+
+				labels = functions[i].GetInstructions().GetLabels();
+				insts = functions[i].GetInstructions().GetInstructions();
+				if (transform(labels, insts, i + 1)) {
+					functions[i].SetInstructions({ std::move(labels), std::move(insts) });
+					isChanged = true;
+				}
+			}
+			return isChanged;
+		}
+
+		bool IsJump(OpCode opCode) noexcept {
+			return OpCode::Jmp <= opCode && opCode <= OpCode::Jbe;
+		}
+
+		// Instructions that a label points to. Sequences can only be merged if no jump lands in the middle of them.
+		std::vector<bool> FindJumpTargets(const std::vector<std::uint64_t>& labels, const std::vector<Instruction>& insts) {
+			std::vector<bool> isTarget(insts.size() + 1);
+			for (const std::uint64_t label : labels) {
+				if (label < isTarget.size()) {
+					isTarget[static_cast<std::size_t>(label)] = true;
+				}
+			}
+			return isTarget;
+		}
+
+		// Removes nops, which the passes use to mark removed instructions. Labels of removed instructions move to the next instruction,
+		// and labels that no jump refers to are removed. Labels and jumps that were out of range stay out of range.
+		bool Compact(std::vector<std::uint64_t>& labels, std::vector<Instruction>& insts) {
+			const std::size_t instCount = insts.size();
+			const std::uint32_t labelCount = static_cast<std::uint32_t>(labels.size());
+
+			std::vector<std::uint64_t> newIndices(instCount + 1);
+			std::uint64_t newInstCount = 0;
+			for (std::size_t i = 0; i < instCount; ++i) {
+				newIndices[i] = newInstCount;
+				if (insts[i].OpCode != OpCode::Nop) {
+					++newInstCount;
+				}
+			}
+			newIndices[instCount] = newInstCount;
+
+			std::vector<bool> isReferred(labelCount);
+			for (const Instruction& inst : insts) {
+				if (IsJump(inst.OpCode) && inst.Operand < labelCount) {
+					isReferred[inst.Operand] = true;
+				}
+			}
+
+			std::vector<std::uint64_t> newLabels;
+			std::vector<std::uint32_t> newLabelIndices(labelCount);
+			for (std::uint32_t i = 0; i < labelCount; ++i) {
+				if (!isReferred[i]) continue;
+
+				const std::uint64_t label = labels[i];
+				newLabelIndices[i] = static_cast<std::uint32_t>(newLabels.size());
+				newLabels.push_back(label <= instCount ? newIndices[static_cast<std::size_t>(label)] : newInstCount + (label - instCount));
+			}
+			const std::uint32_t newLabelCount = static_cast<std::uint32_t>(newLabels.size());
+
+			if (newInstCount == instCount && newLabels == labels) return false;
+
+			std::vector<Instruction> newInsts;
+			newInsts.reserve(static_cast<std::size_t>(newInstCount));
+
+			for (Instruction inst : insts) {
+				if (inst.OpCode == OpCode::Nop) continue;
+				else if (IsJump(inst.OpCode)) {
+					inst.Operand = inst.Operand < labelCount ? newLabelIndices[inst.Operand] : inst.Operand - (labelCount - newLabelCount);
+				}
+
+				newInsts.push_back(inst);
+			}
+
+			labels = std::move(newLabels);
+			insts = std::move(newInsts);
+			return true;
+		}
+	}
+
+	bool OptimizeTailCalls(ByteFile& byteFile) {
+		Functions& functions = byteFile.GetFunctions();
+		bool isChanged = false;
+
+		for (Function& function : functions) {
+			if (!function.IsLoaded()) continue;
+
+			const Instructions& instructions = function.GetInstructions();
+			const std::uint64_t instCount = instructions.GetInstructionCount();
+
+			// Tail calls overwrite the stack frame and the arguments, so the callee must not see pointers into them.
+			// Only lea makes such pointers, so only the functions that use it are verified to find where they can go.
+			const std::vector<Instruction>& allInsts = instructions.GetInstructions();
+			const bool hasLea = std::any_of(allInsts.begin(), allInsts.end(), [](const Instruction& inst) { return inst.OpCode == OpCode::Lea; });
+			std::optional<VerifierResult> result;
+
+			std::vector<std::uint64_t> tailCalls;
+			for (std::uint64_t i = 0; i + 1 < instCount; ++i) {
+				const Instruction& inst = instructions.GetInstruction(i);
+				if (inst.OpCode != OpCode::Call || instructions.GetInstruction(i + 1).OpCode != OpCode::Ret) continue;
+				else if (inst.Operand >= functions.size() || functions[inst.Operand].HasResult() != function.HasResult()) continue;
+
+				if (hasLea) {
+					if (!result) {
+						result = VerifyInstructions(byteFile, &function);
+					}
+					if (!result->IsVerified || result->IsFrameVisible[static_cast<std::size_t>(i)]) continue;
+				}
+				tailCalls.push_back(i);
+			}
+			if (tailCalls.empty()) continue;
+
+			std::vector<Instruction> insts = instructions.GetInstructions();
+			for (const std::uint64_t index : tailCalls) {
+				insts[static_cast<std::size_t>(index)].OpCode = OpCode::TCall;
+			}
+			function.SetInstructions({ instructions.GetLabels(), std::move(insts) });
+			isChanged = true;
+		}
+		return isChanged;
+	}
+	bool RemoveUnreachableCode(ByteFile& byteFile) {
+		return TransformInstructions(byteFile, [](std::vector<std::uint64_t>& labels, std::vector<Instruction>& insts, std::size_t index) {
+			const std::size_t instCount = insts.size();
+			const std::uint32_t labelCount = static_cast<std::uint32_t>(labels.size());
+
+			std::vector<bool> isReachable(instCount);
+			std::vector<std::size_t> worklist;
+			const auto visit = [&](std::uint64_t target) {
+				if (target < instCount && !isReachable[static_cast<std::size_t>(target)]) {
+					isReachable[static_cast<std::size_t>(target)] = true;
+					worklist.push_back(static_cast<std::size_t>(target));
+				}
+			};
+
+			visit(0);
+			while (!worklist.empty()) {
+				const std::size_t i = worklist.back();
+				worklist.pop_back();
+
+				const Instruction& inst = insts[i];
+				if (IsJump(inst.OpCode) && inst.Operand < labelCount) {
+					visit(labels[inst.Operand]);
+				}
+
+				// Unlike the other jumps, jmp never falls through. tcall acts like call in the entry point.
+				if (inst.OpCode == OpCode::Jmp || inst.OpCode == OpCode::Ret) continue;
+				else if (inst.OpCode == OpCode::TCall && index != 0) continue;
+				else if (IsJump(inst.OpCode) && inst.Operand >= labelCount) continue;
+
+				visit(i + 1);
+			}
+
+			for (std::size_t i = 0; i < instCount; ++i) {
+				if (!isReachable[i]) {
+					insts[i].OpCode = OpCode::Nop;
+				}
+			}
+			return Compact(labels, insts);
+		});
+	}
+	bool ThreadJumps(ByteFile& byteFile) {
+		return TransformInstructions(byteFile, [](std::vector<std::uint64_t>& labels, std::vector<Instruction>& insts, std::size_t) {
+			const std::size_t instCount = insts.size();
+			const std::uint32_t labelCount = static_cast<std::uint32_t>(labels.size());
+			const std::vector<Instruction> oldInsts = insts;
+
+			for (std::size_t i = 0; i < instCount; ++i) {
+				Instruction& inst = insts[i];
+				if (!IsJump(inst.OpCode) || inst.Operand >= labelCount) continue;
+
+				// jmps can form a cycle. Stopping at the first visited one gives the same label when threading again.
+				std::uint32_t label = inst.Operand;
+				std::vector<std::uint64_t> visited;
+				while (true) {
+					const std::uint64_t target = labels[label];
+					if (target >= instCount || std::find(visited.begin(), visited.end(), target) != visited.end()) break;
+
+					visited.push_back(target);
+					const Instruction& targetInst = insts[static_cast<std::size_t>(target)];
+					if (targetInst.OpCode != OpCode::Jmp || targetInst.Operand >= labelCount) break;
+
+					label = targetInst.Operand;
+				}
+				inst.Operand = label;
+
+				if (inst.OpCode != OpCode::Jmp) continue;
+				else if (const std::uint64_t target = labels[label]; target == i + 1) {
+					inst.OpCode = OpCode::Nop;
+				} else if (target < instCount && insts[static_cast<std::size_t>(target)].OpCode == OpCode::Ret) {
+					inst.OpCode = OpCode::Ret;
+					inst.Operand = 0;
+				}
+			}
+
+			// Compact reports whether anything moved, so compare the operands too
+			const bool isCompacted = Compact(labels, insts);
+			return isCompacted || oldInsts != insts;
+		});
+	}
+}
+
+namespace svm {
+	namespace {
+		// Small functions are always inlined, and larger ones only if they have a single call site
+		constexpr std::size_t InlineSizeLimit = 8;
+		constexpr std::size_t SingleCallInlineSizeLimit = 32;
+
+		struct InlinedBody final {
+			std::vector<Instruction> Instructions;
+			std::vector<std::uint64_t> Origins;	// The index of the instruction of the callee that each instruction came from
+			std::size_t Size = 0;				// The number of the instructions of the callee before ret
+		};
+
+		// The arguments of an inlined function stay where the caller pushed them instead of becoming local variables,
+		// since a local variable can only be made from the top of the stack and nothing drops a value below the top.
+		// So only straight-line functions whose loads of the arguments can become nothing or copy are inlined.
+		// swap is not used for loads, since it raises an exception if the two values have different types.
+		std::optional<InlinedBody> MakeInlinedBody(const Functions& functions, const Function& function) {
+			static constexpr std::uint32_t Temporary = 0xFFFFFFFF;
+
+			const std::vector<Instruction>& insts = function.GetInstructions().GetInstructions();
+			const auto retIter = std::find_if(insts.begin(), insts.end(), [](const Instruction& inst) {
+				return inst.OpCode == OpCode::Ret;
+			});
+			if (retIter == insts.end()) return std::nullopt;
+
+			const std::uint16_t arity = function.GetArity();
+			const auto size = static_cast<std::size_t>(retIter - insts.begin());
+
+			std::vector<std::size_t> loadCounts(arity);
+			for (std::size_t i = 0; i < size; ++i) {
+				if (insts[i].OpCode == OpCode::Load && insts[i].Operand < arity) {
+					++loadCounts[insts[i].Operand];
+				}
+			}
+
+			// What each value on the stack is, an argument that was not loaded yet or a value of the callee. The first argument is the top.
+			std::vector<std::uint32_t> stack(arity);
+			for (std::uint16_t i = 0; i < arity; ++i) {
+				stack[i] = arity - 1u - i;
+			}
+
+			InlinedBody body;
+			body.Size = size;
+			const auto emit = [&body](OpCode opCode, std::uint32_t operand, std::size_t origin) {
+				// Two swaps cancel each other out
+				if (opCode == OpCode::Swap && !body.Instructions.empty() && body.Instructions.back().OpCode == OpCode::Swap) {
+					body.Instructions.pop_back();
+					body.Origins.pop_back();
+					return;
+				}
+				body.Instructions.emplace_back(opCode, operand);
+				body.Origins.push_back(origin);
+			};
+			// The callee can only use the values it pushed, as the arguments lie below its stack frame
+			const auto popValues = [&stack](std::size_t count) {
+				if (stack.size() < count) return false;
+				else if (std::any_of(stack.end() - count, stack.end(), [](std::uint32_t value) { return value != Temporary; })) return false;
+
+				stack.erase(stack.end() - count, stack.end());
+				return true;
+			};
+
+			for (std::size_t i = 0; i < size; ++i) {
+				const Instruction& inst = insts[i];
+				switch (inst.OpCode) {
+				case OpCode::Nop:
+					break;
+
+				case OpCode::Push:
+					stack.push_back(Temporary);
+					emit(inst.OpCode, inst.Operand, i);
+					break;
+
+				case OpCode::Load: {
+					const std::uint32_t argument = inst.Operand;
+					if (argument >= arity) return std::nullopt;
+
+					const bool isLastLoad = --loadCounts[argument] == 0;
+					if (!stack.empty() && stack.back() == argument) {
+						if (isLastLoad) {
+							stack.back() = Temporary;
+						} else {
+							stack.push_back(Temporary);
+							emit(OpCode::Copy, 0, i);
+						}
+					} else return std::nullopt;
+					break;
+				}
+
+				case OpCode::Add:
+				case OpCode::Sub:
+				case OpCode::Mul:
+				case OpCode::IMul:
+				case OpCode::Div:
+				case OpCode::IDiv:
+				case OpCode::Mod:
+				case OpCode::IMod:
+				case OpCode::And:
+				case OpCode::Or:
+				case OpCode::Xor:
+				case OpCode::Shl:
+				case OpCode::Sal:
+				case OpCode::Shr:
+				case OpCode::Sar:
+				case OpCode::Cmp:
+				case OpCode::ICmp:
+					if (!popValues(2)) return std::nullopt;
+
+					stack.push_back(Temporary);
+					emit(inst.OpCode, 0, i);
+					break;
+
+				case OpCode::Neg:
+				case OpCode::Not:
+				case OpCode::ToI:
+				case OpCode::ToL:
+				case OpCode::ToD:
+				case OpCode::ToP:
+				case OpCode::Copy:
+					if (!popValues(1)) return std::nullopt;
+
+					stack.push_back(Temporary);
+					if (inst.OpCode == OpCode::Copy) {
+						stack.push_back(Temporary);
+					}
+					emit(inst.OpCode, 0, i);
+					break;
+
+				case OpCode::Swap:
+					if (!popValues(2)) return std::nullopt;
+
+					stack.insert(stack.end(), 2, Temporary);
+					emit(inst.OpCode, 0, i);
+					break;
+
+				case OpCode::Pop:
+					if (!popValues(1)) return std::nullopt;
+
+					emit(inst.OpCode, 0, i);
+					break;
+
+				case OpCode::Call:
+					if (inst.Operand >= functions.size() || !popValues(functions[inst.Operand].GetArity())) return std::nullopt;
+
+					if (functions[inst.Operand].HasResult()) {
+						stack.push_back(Temporary);
+					}
+					emit(inst.OpCode, inst.Operand, i);
+					break;
+
+				default:
+					return std::nullopt;
+				}
+			}
+
+			// ret drops the arguments and the values below the result, but only the values on the top can be popped here
+			if (function.HasResult()) {
+				if (stack.size() != 1 || stack.back() != Temporary) return std::nullopt;
+			} else {
+				for (std::size_t i = 0; i < stack.size(); ++i) {
+					emit(OpCode::Pop, 0, size);
+				}
+			}
+			return body;
+		}
+
+		// Finds the functions that can call themselves, and orders the functions so that callees come before their callers
+		void AnalyzeCallGraph(const std::vector<std::vector<std::uint32_t>>& callees, std::vector<bool>& isRecursive, std::vector<std::uint32_t>& order) {
+			static constexpr std::uint32_t Unvisited = 0xFFFFFFFF;
+
+			// Tarjan's algorithm without recursion, as call chains can be long
+			const auto funcCount = static_cast<std::uint32_t>(callees.size());
+			std::vector<std::uint32_t> indices(funcCount, Unvisited), lowLinks(funcCount);
+			std::vector<bool> isOnStack(funcCount);
+			std::vector<std::uint32_t> stack;
+			std::vector<std::pair<std::uint32_t, std::size_t>> dfs;
+			std::uint32_t nextIndex = 0;
+
+			isRecursive.assign(funcCount, false);
+			order.clear();
+
+			const auto visit = [&](std::uint32_t node) {
+				indices[node] = lowLinks[node] = nextIndex++;
+				stack.push_back(node);
+				isOnStack[node] = true;
+				dfs.push_back({ node, 0 });
+			};
+			for (std::uint32_t root = 0; root < funcCount; ++root) {
+				if (indices[root] != Unvisited) continue;
+
+				visit(root);
+				while (!dfs.empty()) {
+					const std::uint32_t node = dfs.back().first;
+					if (const std::size_t edge = dfs.back().second++; edge < callees[node].size()) {
+						const std::uint32_t callee = callees[node][edge];
+						if (callee == node) {
+							isRecursive[node] = true;
+						} else if (indices[callee] == Unvisited) {
+							visit(callee);
+						} else if (isOnStack[callee]) {
+							lowLinks[node] = std::min(lowLinks[node], indices[callee]);
+						}
+						continue;
+					}
+
+					dfs.pop_back();
+					if (!dfs.empty()) {
+						const std::uint32_t parent = dfs.back().first;
+						lowLinks[parent] = std::min(lowLinks[parent], lowLinks[node]);
+					}
+					if (lowLinks[node] != indices[node]) continue;
+
+					const auto begin = std::find(stack.begin(), stack.end(), node);
+					const bool isCycle = stack.end() - begin > 1;
+					for (auto iter = begin; iter < stack.end(); ++iter) {
+						isOnStack[*iter] = false;
+						isRecursive[*iter] = isRecursive[*iter] || isCycle;
+						order.push_back(*iter);
+					}
+					stack.erase(begin, stack.end());
+				}
+			}
+		}
+
+		bool IsFundamentalType(Type type) noexcept {
+			return type == IntType || type == LongType || type == DoubleType || type == PointerType || type == GCPointerType;
+		}
+	}
+
+	bool InlineFunctions(ByteFile& byteFile, std::vector<InstructionOrigins>* origins) {
+		Functions& functions = byteFile.GetFunctions();
+		const auto funcCount = static_cast<std::uint32_t>(functions.size());
+		if (funcCount == 0) return false;
+
+		const auto getInstructions = [&](std::size_t index) -> const Instructions& {
+			return index == 0 ? byteFile.GetEntryPoint() : functions[index - 1].GetInstructions();
+		};
+
+		std::vector<std::vector<std::uint32_t>> callees(funcCount);
+		std::vector<std::size_t> callCounts(funcCount);
+		for (std::size_t i = 0; i <= funcCount; ++i) {
+			if (i != 0 && !functions[i - 1].IsLoaded()) continue;
+
+			for (const Instruction& inst : getInstructions(i).GetInstructions()) {
+				if ((inst.OpCode != OpCode::Call && inst.OpCode != OpCode::TCall) || inst.Operand >= funcCount) continue;
+
+				++callCounts[inst.Operand];
+				if (i != 0) {
+					callees[i - 1].push_back(inst.Operand);
+				}
+			}
+		}
+
+		std::vector<bool> isRecursive;
+		std::vector<std::uint32_t> order;
+		AnalyzeCallGraph(callees, isRecursive, order);
+
+		if (origins) {
+			origins->assign(funcCount + 1, {});
+		}
+		const auto getOrigins = [&](std::size_t index, std::uint64_t inst) -> std::vector<InstructionOrigin> {
+			if (!origins || (*origins)[index].empty()) return { { index, inst } };
+			else return (*origins)[index][static_cast<std::size_t>(inst)];
+		};
+
+		// Callees are inlined after their own callees were, so the bodies are made when they are first needed
+		std::vector<std::optional<std::optional<InlinedBody>>> bodies(funcCount);
+		const auto getBody = [&](std::uint32_t callee) -> const std::optional<InlinedBody>& {
+			if (!bodies[callee]) {
+				std::optional<InlinedBody> body;
+				if (!isRecursive[callee]) {
+					body = MakeInlinedBody(functions, functions[callee]);
+				}
+				if (body && body->Size > InlineSizeLimit && (callCounts[callee] != 1 || body->Size > SingleCallInlineSizeLimit)) {
+					body.reset();
+				}
+				bodies[callee] = std::move(body);
+			}
+			return *bodies[callee];
+		};
+
+		// Arguments have to be proven, since an argument that is a local variable or an array cannot be used in place
+		const std::vector<VerifierResult> results = VerifyByteFile(byteFile);
+
+		bool isChanged = false;
+		std::vector<std::size_t> indices;
+		for (const std::uint32_t func : order) {
+			indices.push_back(func + std::size_t(1));
+		}
+		indices.push_back(0);
+
+		for (const std::size_t index : indices) {
+			const std::size_t func = index - 1;
+			const VerifierResult& result = results[index];
+			if (!result.IsVerified) continue;
+
+			const Instructions& instructions = getInstructions(index);
+			const std::vector<Instruction>& insts = instructions.GetInstructions();
+			const std::size_t instCount = insts.size();
+			const Function* const caller = index == 0 ? nullptr : &functions[func];
+
+			std::vector<Instruction> newInsts;
+			InstructionOrigins newOrigins;
+			std::vector<std::uint64_t> newIndices(instCount + 1);
+			bool isInlined = false;
+
+			for (std::size_t i = 0; i < instCount; ++i) {
+				const Instruction& inst = insts[i];
+				newIndices[i] = newInsts.size();
+
+				const InlinedBody* body = nullptr;
+				if ((inst.OpCode == OpCode::Call || inst.OpCode == OpCode::TCall) && inst.Operand < funcCount && i < result.ArgumentTypes.size()) {
+					const Function& callee = functions[inst.Operand];
+					const std::vector<Type>& argTypes = result.ArgumentTypes[i];
+					const bool isTailCall = inst.OpCode == OpCode::TCall && caller;
+					if ((callee.GetArity() == 0 || argTypes.size() == callee.GetArity()) &&
+						std::all_of(argTypes.begin(), argTypes.end(), IsFundamentalType) &&
+						(!isTailCall || callee.HasResult() == caller->HasResult())) {
+						if (const std::optional<InlinedBody>& inlinedBody = getBody(inst.Operand); inlinedBody) {
+							body = &*inlinedBody;
+						}
+					}
+				}
+
+				if (!body) {
+					newInsts.push_back(inst);
+					newOrigins.push_back(getOrigins(index, i));
+					continue;
+				}
+
+				for (std::size_t j = 0; j < body->Instructions.size(); ++j) {
+					std::vector<InstructionOrigin> origin = getOrigins(index, i);
+					const std::vector<InstructionOrigin> calleeOrigin = getOrigins(inst.Operand + std::size_t(1), body->Origins[j]);
+					origin.insert(origin.end(), calleeOrigin.begin(), calleeOrigin.end());
+
+					newInsts.push_back(body->Instructions[j]);
+					newOrigins.push_back(std::move(origin));
+				}
+				if (inst.OpCode == OpCode::TCall && caller) {
+					std::vector<InstructionOrigin> origin = getOrigins(index, i);
+					const std::vector<InstructionOrigin> calleeOrigin = getOrigins(inst.Operand + std::size_t(1), body->Size);
+					origin.insert(origin.end(), calleeOrigin.begin(), calleeOrigin.end());
+
+					newInsts.emplace_back(OpCode::Ret);
+					newOrigins.push_back(std::move(origin));
+				}
+				isInlined = true;
+			}
+			if (!isInlined) continue;
+
+			newIndices[instCount] = newInsts.size();
+
+			std::vector<std::uint64_t> labels = instructions.GetLabels();
+			for (std::uint64_t& label : labels) {
+				label = label <= instCount ? newIndices[static_cast<std::size_t>(label)] : newIndices[instCount] + (label - instCount);
+			}
+
+			if (index == 0) {
+				byteFile.SetEntryPoint({ std::move(labels), std::move(newInsts) });
+			} else {
+				functions[func].SetInstructions({ std::move(labels), std::move(newInsts) });
+			}
+			if (origins) {
+				(*origins)[index] = std::move(newOrigins);
+			}
+			isChanged = true;
+		}
+		return isChanged;
+	}
+}
+
+namespace svm {
+	namespace {
+		struct Constant final {
+			svm::Type Type;
+			std::uint64_t Bits = 0;
+		};
+
+		// Push operands are renumbered while folding, since folding adds constants to the pool.
+		// Constants keep their indices, and structures and invalid operands are marked with these bits.
+		constexpr std::uint32_t StructureMark = 0x80000000;
+		constexpr std::uint32_t InvalidMark = 0xFFFFFFFF;
+
+		Constant MakeInt(std::uint32_t value) noexcept {
+			return { IntType, value };
+		}
+		Constant MakeLong(std::uint64_t value) noexcept {
+			return { LongType, value };
+		}
+		Constant MakeDouble(double value) noexcept {
+			Constant result{ DoubleType };
+			std::memcpy(&result.Bits, &value, sizeof(value));
+			return result;
+		}
+		double GetDouble(const Constant& constant) noexcept {
+			double result;
+			std::memcpy(&result, &constant.Bits, sizeof(result));
+			return result;
+		}
+
+		// Same as Interpreter::CompareTwoSameType
+		template<typename T>
+		std::uint32_t Compare(T lhs, T rhs) noexcept {
+			if (lhs > rhs) return 1;
+			else if (lhs == rhs) return 0;
+			else return static_cast<std::uint32_t>(-1);
+		}
+
+		// Operations that raise an exception or depend on the platform are not folded
+		template<typename T, typename S>
+		bool FoldInteger(OpCode opCode, T lhs, T rhs, T& result, std::uint32_t& compared) noexcept {
+			const S signedLhs = static_cast<S>(lhs), signedRhs = static_cast<S>(rhs);
+			const bool isSignedOverflow = signedLhs == std::numeric_limits<S>::min() && signedRhs == -1;
+
+			switch (opCode) {
+			case OpCode::Add: result = lhs + rhs; return true;
+			case OpCode::Sub: result = lhs - rhs; return true;
+			case OpCode::Mul:
+			case OpCode::IMul: result = lhs * rhs; return true;
+			case OpCode::Div:
+				if (rhs == 0) return false;
+				result = lhs / rhs;
+				return true;
+			case OpCode::IDiv:
+				if (rhs == 0 || isSignedOverflow) return false;
+				result = static_cast<T>(signedLhs / signedRhs);
+				return true;
+			case OpCode::Mod:
+				if (rhs == 0) return false;
+				result = lhs % rhs;
+				return true;
+			case OpCode::IMod:
+				if (rhs == 0 || isSignedOverflow) return false;
+				result = static_cast<T>(signedLhs % signedRhs);
+				return true;
+			case OpCode::And: result = lhs & rhs; return true;
+			case OpCode::Or: result = lhs | rhs; return true;
+			case OpCode::Xor: result = lhs ^ rhs; return true;
+			case OpCode::Cmp: compared = Compare(lhs, rhs); return true;
+			case OpCode::ICmp: compared = Compare(signedLhs, signedRhs); return true;
+			default: return false;
+			}
+		}
+		bool FoldBinary(OpCode opCode, const Constant& lhs, const Constant& rhs, Constant& result) noexcept {
+			if (lhs.Type != rhs.Type) return false;
+
+			const bool isCompare = opCode == OpCode::Cmp || opCode == OpCode::ICmp;
+			std::uint32_t compared = 0;
+			if (lhs.Type == IntType) {
+				std::uint32_t value = 0;
+				if (!FoldInteger<std::uint32_t, std::int32_t>(opCode, static_cast<std::uint32_t>(lhs.Bits), static_cast<std::uint32_t>(rhs.Bits), value, compared)) return false;
+
+				result = MakeInt(isCompare ? compared : value);
+				return true;
+			} else if (lhs.Type == LongType) {
+				std::uint64_t value = 0;
+				if (!FoldInteger<std::uint64_t, std::int64_t>(opCode, lhs.Bits, rhs.Bits, value, compared)) return false;
+
+				result = isCompare ? MakeInt(compared) : MakeLong(value);
+				return true;
+			}
+
+			const double l = GetDouble(lhs), r = GetDouble(rhs);
+			switch (opCode) {
+			case OpCode::Add: result = MakeDouble(l + r); return true;
+			case OpCode::Sub: result = MakeDouble(l - r); return true;
+			case OpCode::Mul:
+			case OpCode::IMul: result = MakeDouble(l * r); return true;
+			case OpCode::Div:
+			case OpCode::IDiv:
+				if (r == 0) return false;
+				result = MakeDouble(l / r);
+				return true;
+			case OpCode::Mod:
+			case OpCode::IMod:
+				if (r == 0) return false;
+				result = MakeDouble(std::fmod(l, r));
+				return true;
+			case OpCode::Cmp:
+			case OpCode::ICmp: result = MakeInt(Compare(l, r)); return true;
+			default: return false;
+			}
+		}
+		bool FoldUnary(OpCode opCode, const Constant& operand, Constant& result) noexcept {
+			if (operand.Type == IntType) {
+				const auto value = static_cast<std::uint32_t>(operand.Bits);
+				if (opCode == OpCode::Neg) result = MakeInt(0 - value);
+				else if (opCode == OpCode::Not) result = MakeInt(~value);
+				else return false;
+			} else if (operand.Type == LongType) {
+				if (opCode == OpCode::Neg) result = MakeLong(0 - operand.Bits);
+				else if (opCode == OpCode::Not) result = MakeLong(~operand.Bits);
+				else return false;
+			} else if (opCode == OpCode::Neg) {
+				result = MakeDouble(-GetDouble(operand));
+			} else return false;
+			return true;
+		}
+	}
+
+	bool FoldConstants(ByteFile& byteFile) {
+		// The constant pool is rebuilt, so no function may keep the old indices
+		byteFile.LoadFunctions();
+
+		const ConstantPool& constantPool = byteFile.GetConstantPool();
+		const std::uint32_t constCount = constantPool.GetAllCount();
+		const std::uint32_t structCount = byteFile.GetStructures().GetStructureCount();
+		if (constCount >= StructureMark || structCount >= StructureMark) return false;
+
+		std::vector<Constant> constants;
+		constants.reserve(constCount);
+		for (const IntObject& constant : constantPool.GetIntPool()) {
+			constants.push_back(MakeInt(constant.Value));
+		}
+		for (const LongObject& constant : constantPool.GetLongPool()) {
+			constants.push_back(MakeLong(constant.Value));
+		}
+		for (const DoubleObject& constant : constantPool.GetDoublePool()) {
+			constants.push_back(MakeDouble(constant.Value));
+		}
+
+		const auto addConstant = [&constants](const Constant& constant) {
+			constants.push_back(constant);
+			return static_cast<std::uint32_t>(constants.size() - 1);
+		};
+
+		bool isFolded = false;
+		TransformInstructions(byteFile, [&](std::vector<std::uint64_t>& labels, std::vector<Instruction>& insts, std::size_t) {
+			const std::size_t instCount = insts.size();
+			for (Instruction& inst : insts) {
+				if (inst.OpCode != OpCode::Push || inst.Operand < constCount) continue;
+				else if (inst.Operand - constCount < structCount) {
+					inst.Operand = (inst.Operand - constCount) | StructureMark;
+				} else {
+					inst.Operand = InvalidMark;
+				}
+			}
+
+			const std::vector<bool> isTarget = FindJumpTargets(labels, insts);
+			const auto isConstant = [&](std::size_t i) {
+				return insts[i].OpCode == OpCode::Push && !(insts[i].Operand & StructureMark);
+			};
+
+			for (std::size_t i = 0; i < instCount; ++i) {
+				if (!isConstant(i)) continue;
+
+				Constant result;
+				if (i + 2 < instCount && isConstant(i + 1) && !isTarget[i + 1] && !isTarget[i + 2] &&
+					FoldBinary(insts[i + 2].OpCode, constants[insts[i].Operand], constants[insts[i + 1].Operand], result)) {
+					insts[i].Operand = addConstant(result);
+					insts[i + 1].OpCode = insts[i + 2].OpCode = OpCode::Nop;
+					i += 2;
+					isFolded = true;
+				} else if (i + 1 < instCount && !isTarget[i + 1] &&
+					FoldUnary(insts[i + 1].OpCode, constants[insts[i].Operand], result)) {
+					insts[i].Operand = addConstant(result);
+					insts[i + 1].OpCode = OpCode::Nop;
+					++i;
+					isFolded = true;
+				}
+			}
+
+			Compact(labels, insts);
+			return true;
+		});
+
+		// Rebuilds the pool with the constants in use, merging the same ones
+		std::map<std::pair<std::uint32_t, std::uint64_t>, std::uint32_t> newIndices;
+		std::vector<IntObject> intPool;
+		std::vector<LongObject> longPool;
+		std::vector<DoubleObject> doublePool;
+		TransformInstructions(byteFile, [&](std::vector<std::uint64_t>&, std::vector<Instruction>& insts, std::size_t) {
+			for (const Instruction& inst : insts) {
+				if (inst.OpCode != OpCode::Push || (inst.Operand & StructureMark)) continue;
+
+				const Constant& constant = constants[inst.Operand];
+				const auto [iter, isInserted] = newIndices.insert({ { static_cast<std::uint32_t>(constant.Type->Code), constant.Bits }, 0 });
+				if (!isInserted) continue;
+				else if (constant.Type == IntType) {
+					iter->second = static_cast<std::uint32_t>(intPool.size());
+					intPool.push_back(static_cast<std::uint32_t>(constant.Bits));
+				} else if (constant.Type == LongType) {
+					iter->second = static_cast<std::uint32_t>(longPool.size());
+					longPool.push_back(constant.Bits);
+				} else {
+					iter->second = static_cast<std::uint32_t>(doublePool.size());
+					doublePool.push_back(GetDouble(constant));
+				}
+			}
+			return false;
+		});
+
+		const auto newIntCount = static_cast<std::uint32_t>(intPool.size());
+		const auto newLongCount = static_cast<std::uint32_t>(longPool.size());
+		const std::uint32_t newConstCount = newIntCount + newLongCount + static_cast<std::uint32_t>(doublePool.size());
+		TransformInstructions(byteFile, [&](std::vector<std::uint64_t>&, std::vector<Instruction>& insts, std::size_t) {
+			for (Instruction& inst : insts) {
+				if (inst.OpCode != OpCode::Push) continue;
+				else if (inst.Operand == InvalidMark) continue;
+				else if (inst.Operand & StructureMark) {
+					inst.Operand = (inst.Operand & ~StructureMark) + newConstCount;
+					continue;
+				}
+
+				const Constant& constant = constants[inst.Operand];
+				const std::uint32_t index = newIndices[{ static_cast<std::uint32_t>(constant.Type->Code), constant.Bits }];
+				if (constant.Type == IntType) {
+					inst.Operand = index;
+				} else if (constant.Type == LongType) {
+					inst.Operand = newIntCount + index;
+				} else {
+					inst.Operand = newIntCount + newLongCount + index;
+				}
+			}
+			return true;
+		});
+
+		byteFile.SetConstantPool({ std::move(intPool), std::move(longPool), std::move(doublePool) });
+		return isFolded;
+	}
+	bool RemovePushPop(ByteFile& byteFile) {
+		const std::uint32_t pushCount = byteFile.GetConstantPool().GetAllCount() + byteFile.GetStructures().GetStructureCount();
+		const std::vector<VerifierResult> results = VerifyByteFile(byteFile);
+
+		return TransformInstructions(byteFile, [&](std::vector<std::uint64_t>& labels, std::vector<Instruction>& insts, std::size_t index) {
+			const std::size_t instCount = insts.size();
+			const VerifierResult& result = results[index];
+			const std::vector<bool> isTarget = FindJumpTargets(labels, insts);
+
+			for (std::size_t i = 0; i + 1 < instCount; ++i) {
+				if (insts[i + 1].OpCode != OpCode::Pop || isTarget[i + 1]) continue;
+
+				// Loads can fail, so they are removed only if the verifier proved the local variable
+				const Instruction& inst = insts[i];
+				const bool isPush = inst.OpCode == OpCode::Push && inst.Operand < pushCount;
+				const bool isLoad = inst.OpCode == OpCode::Load && result.IsVerified && i < result.OperandTypes.size() && result.OperandTypes[i] != NoneType;
+				if (!isPush && !isLoad) continue;
+
+				insts[i].OpCode = insts[i + 1].OpCode = OpCode::Nop;
+				++i;
+			}
+			return Compact(labels, insts);
+		});
+	}
+	bool RemoveRedundantLoadStore(ByteFile& byteFile) {
+		const std::vector<VerifierResult> results = VerifyByteFile(byteFile);
+
+		return TransformInstructions(byteFile, [&](std::vector<std::uint64_t>& labels, std::vector<Instruction>& insts, std::size_t index) {
+			const VerifierResult& result = results[index];
+			if (!result.IsVerified || result.OperandTypes.size() != insts.size() || result.LocalVariableOffsets.size() != insts.size()) return false;
+
+			const std::size_t instCount = insts.size();
+			const std::vector<bool> isTarget = FindJumpTargets(labels, insts);
+
+			for (std::size_t i = 0; i + 1 < instCount; ++i) {
+				const Instruction& load = insts[i];
+				const Instruction& store = insts[i + 1];
+				if (load.OpCode != OpCode::Load || store.OpCode != OpCode::Store || load.Operand != store.Operand || isTarget[i + 1]) continue;
+
+				// Both have to be proven, or the store may be the one that raises an exception
+				const Type type = result.OperandTypes[i];
+				if (type == NoneType || result.OperandTypes[i + 1] != type) continue;
+				else if (result.LocalVariableOffsets[i] == 0 || result.LocalVariableOffsets[i + 1] != result.LocalVariableOffsets[i]) continue;
+
+				insts[i].OpCode = insts[i + 1].OpCode = OpCode::Nop;
+				++i;
+			}
+			return Compact(labels, insts);
+		});
+	}
+
+	bool AllocateOnStack(ByteFile& byteFile) {
+		// Large objects stay on the heap, so that they do not overflow the stack
+		static constexpr std::size_t SizeLimit = 1024;
+
+		const Structures& structures = byteFile.GetStructures();
+		const std::uint32_t constCount = byteFile.GetConstantPool().GetAllCount();
+		const std::vector<VerifierResult> results = VerifyByteFile(byteFile);
+
+		return TransformInstructions(byteFile, [&](std::vector<std::uint64_t>&, std::vector<Instruction>& insts, std::size_t index) {
+			const VerifierResult& result = results[index];
+			if (result.LocalAllocations.size() != insts.size()) return false;
+
+			// gcnew pushes the object itself, which becomes the local variable, and loads of the pointer take its address instead
+			const std::size_t instCount = insts.size();
+			std::vector<bool> isReplaced(instCount);
+			for (std::size_t i = 0; i < instCount; ++i) {
+				if (result.LocalAllocations[i] != i) continue;
+
+				const std::uint32_t structIndex = insts[i].Operand - static_cast<std::uint32_t>(TypeCode::Structure);
+				if (structures[structIndex]->Type.Size > SizeLimit) continue;
+
+				insts[i].OpCode = OpCode::Push;
+				insts[i].Operand = constCount + structIndex;
+				isReplaced[i] = true;
+			}
+
+			bool isChanged = false;
+			for (std::size_t i = 0; i < instCount; ++i) {
+				const std::uint64_t allocation = result.LocalAllocations[i];
+				if (allocation == static_cast<std::uint64_t>(-1) || !isReplaced[static_cast<std::size_t>(allocation)]) continue;
+				else if (insts[i].OpCode == OpCode::Load) {
+					insts[i].OpCode = OpCode::Lea;
+				}
+				isChanged = true;
+			}
+			return isChanged;
+		});
+	}
+
+	void OptimizeByteFile(ByteFile& byteFile) {
+		byteFile.LoadFunctions();
+
+		bool isChanged = true;
+		while (isChanged) {
+			isChanged = InlineFunctions(byteFile);
+			isChanged |= OptimizeTailCalls(byteFile);
+			isChanged |= RemoveUnreachableCode(byteFile);
+			isChanged |= ThreadJumps(byteFile);
+			isChanged |= FoldConstants(byteFile);
+			isChanged |= RemovePushPop(byteFile);
+			isChanged |= RemoveRedundantLoadStore(byteFile);
+			isChanged |= AllocateOnStack(byteFile);
+		}
+	}
+}
\ No newline at end of file
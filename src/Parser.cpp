@@ -1,22 +1,83 @@
 #include <svm/Parser.hpp>
 
+#include <svm/Macro.hpp>
 #include <svm/Memory.hpp>
 #include <svm/Type.hpp>
+#include <svm/detail/Hash.hpp>
 
 #include <fstream>
 #include <ios>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifdef SVM_WINDOWS
+#	define WIN32_LEAN_AND_MEAN
+#	define NOMINMAX
+#	include <Windows.h>
+#elif defined(SVM_LINUX)
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+namespace svm {
+	// Owns the bytes of a file, and is shared with the functions that are not parsed yet
+	class Parser::Buffer final {
+	private:
+		std::vector<std::uint8_t> m_Bytes;
+		void* m_Mapping = nullptr;
+		std::size_t m_MappingSize = 0;
+
+	public:
+		explicit Buffer(std::vector<std::uint8_t>&& bytes) noexcept
+			: m_Bytes(std::move(bytes)) {}
+		Buffer(void* mapping, std::size_t mappingSize) noexcept
+			: m_Mapping(mapping), m_MappingSize(mappingSize) {}
+		Buffer(const Buffer&) = delete;
+		~Buffer() {
+			if (!m_Mapping) return;
+
+#ifdef SVM_WINDOWS
+			UnmapViewOfFile(m_Mapping);
+#elif defined(SVM_LINUX)
+			munmap(m_Mapping, m_MappingSize);
+#endif
+		}
+
+	public:
+		Buffer& operator=(const Buffer&) = delete;
+
+	public:
+		const std::uint8_t* GetData() const noexcept {
+			return m_Mapping ? static_cast<const std::uint8_t*>(m_Mapping) : m_Bytes.data();
+		}
+		std::size_t GetSize() const noexcept {
+			return m_Mapping ? m_MappingSize : m_Bytes.size();
+		}
+	};
+}
 
 namespace svm {
 	Parser::Parser(Parser&& parser) noexcept
-		: m_File(std::move(parser.m_File)), m_Pos(parser.m_Pos),
-		m_ByteFile(std::move(parser.m_ByteFile)), m_ByteFileVersion(parser.m_ByteFileVersion), m_ByteCodeVersion(parser.m_ByteCodeVersion) {}
+		: m_Buffer(std::move(parser.m_Buffer)), m_Data(parser.m_Data), m_Size(parser.m_Size), m_Pos(parser.m_Pos),
+		m_ByteFile(std::move(parser.m_ByteFile)), m_ByteFileVersion(parser.m_ByteFileVersion), m_ByteCodeVersion(parser.m_ByteCodeVersion) {
+		parser.m_Data = nullptr;
+		parser.m_Size = 0;
+	}
 
 	Parser& Parser::operator=(Parser&& parser) noexcept {
-		m_File = std::move(parser.m_File);
+		m_Buffer = std::move(parser.m_Buffer);
+		m_Data = parser.m_Data;
+		m_Size = parser.m_Size;
 		m_Pos = parser.m_Pos;
 
+		parser.m_Data = nullptr;
+		parser.m_Size = 0;
+
 		m_ByteFile = std::move(parser.m_ByteFile);
 		m_ByteFileVersion = parser.m_ByteFileVersion;
 		m_ByteCodeVersion = parser.m_ByteCodeVersion;
@@ -24,7 +85,9 @@ namespace svm {
 	}
 
 	void Parser::Clear() noexcept {
-		m_File.clear();
+		m_Buffer.reset();
+		m_Data = nullptr;
+		m_Size = 0;
 		m_Pos = 0;
 
 		m_ByteFile.Clear();
@@ -32,6 +95,8 @@ namespace svm {
 		m_ByteCodeVersion = ByteCodeVersion::Latest;
 	}
 	void Parser::Load(const std::string& path) {
+		if (Map(path)) return;
+
 		std::ifstream stream(path, std::ifstream::binary);
 		if (!stream) throw std::runtime_error("Failed to open the file.");
 
@@ -48,18 +113,82 @@ namespace svm {
 		stream.read(reinterpret_cast<char*>(bytes.data()), length);
 		if (stream.gcount() != length) throw std::runtime_error("Failed to read the file.");
 
-		m_File = std::move(bytes);
+		Load(path, std::move(bytes));
+	}
+	void Parser::Load(const std::string& path, std::vector<std::uint8_t>&& bytes) {
+		SetBuffer(path, std::make_shared<const Buffer>(std::move(bytes)));
+	}
+	bool Parser::Map(const std::string& path) {
+		// The parser reads the mapped pages directly, so the file is never copied into a buffer.
+#ifdef SVM_WINDOWS
+		const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) return false;
+
+		LARGE_INTEGER length;
+		if (!GetFileSizeEx(file, &length) || length.QuadPart == 0) {
+			CloseHandle(file);
+			return false;
+		}
+
+		const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (mapping == nullptr) return false;
+
+		void* const view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+		if (view == nullptr) return false;
+
+		const std::size_t size = static_cast<std::size_t>(length.QuadPart);
+#elif defined(SVM_LINUX)
+		const int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (file == -1) return false;
+
+		struct stat status;
+		if (fstat(file, &status) == -1 || !S_ISREG(status.st_mode) || status.st_size == 0) {
+			close(file);
+			return false;
+		}
+
+		const std::size_t size = static_cast<std::size_t>(status.st_size);
+		void* const view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+		close(file);
+		if (view == MAP_FAILED) return false;
+
+		madvise(view, size, MADV_SEQUENTIAL);
+#else
+		static_cast<void>(path);
+		return false;
+#endif
+
+#if defined(SVM_WINDOWS) || defined(SVM_LINUX)
+		SetBuffer(path, std::make_shared<const Buffer>(view, size));
+		return true;
+#endif
+	}
+	void Parser::SetBuffer(const std::string& path, std::shared_ptr<const Buffer>&& buffer) {
+		m_Buffer = std::move(buffer);
+		m_Data = m_Buffer->GetData();
+		m_Size = m_Buffer->GetSize();
 		m_Pos = 0;
 
 		m_ByteFile.Clear();
 		m_ByteFile.SetPath(path);
 	}
 	bool Parser::IsLoaded() const noexcept {
-		return m_File.size() != 0;
+		return m_Size != 0;
+	}
+	const std::uint8_t* Parser::GetData() const noexcept {
+		return m_Data;
+	}
+	std::size_t Parser::GetSize() const noexcept {
+		return m_Size;
+	}
+	std::uint64_t Parser::GetHash() const noexcept {
+		return detail::HashBytes(m_Data, m_Size);
 	}
 	void Parser::Parse() {
 		if (!IsLoaded()) throw std::runtime_error("Failed to parse the file. Incomplete loading.");
-		else if (m_File.size() < 36) throw std::runtime_error("Failed to parse the file. Invalid format.");
+		else if (m_Size < 36) throw std::runtime_error("Failed to parse the file. Invalid format.");
 
 		static constexpr std::uint8_t magic[] = { 0x74, 0x68, 0x74, 0x68 };
 		const auto [magicBegin, magicEnd] = ReadFile(4);
@@ -108,11 +237,14 @@ namespace svm {
 		const auto structCount = ReadFile<std::uint32_t>();
 		std::vector<StructureInfo> structures(structCount);
 
+		// Fields can refer to structures declared after them, and a Type takes its tag from the code
 		for (std::uint32_t i = 0; i < structCount; ++i) {
-			const auto fieldCount = ReadFile<std::uint32_t>();
-			structures[i].Fields.resize(fieldCount);
 			structures[i].Type.Name = "structure" + std::to_string(i);
 			structures[i].Type.Code = static_cast<TypeCode>(i + static_cast<std::uint32_t>(TypeCode::Structure));
+		}
+		for (std::uint32_t i = 0; i < structCount; ++i) {
+			const auto fieldCount = ReadFile<std::uint32_t>();
+			structures[i].Fields.resize(fieldCount);
 
 			for (std::uint32_t j = 0; j < fieldCount; ++j) {
 				Field& field = structures[i].Fields[j];
@@ -138,14 +270,41 @@ namespace svm {
 		Functions functions;
 		functions.reserve(funcCount);
 
+		if (m_ByteFileVersion < ByteFileVersion::v0_5_0) {
+			for (std::uint32_t i = 0; i < funcCount; ++i) {
+				const auto arity = ReadFile<std::uint16_t>();
+				const auto hasResult = ReadFile<bool>();
+				auto instructions = ParseInstructions();
+
+				functions.emplace_back(arity, hasResult, std::move(instructions));
+			}
+
+			m_ByteFile.SetFunctions(std::move(functions));
+			return;
+		}
+
+		// The instructions of each function are parsed when they are needed first, from the offset in the table
 		for (std::uint32_t i = 0; i < funcCount; ++i) {
 			const auto arity = ReadFile<std::uint16_t>();
 			const auto hasResult = ReadFile<bool>();
-			auto instructions = ParseInstructions();
-
-			functions.emplace_back(arity, hasResult, std::move(instructions));
+			const auto offset = ReadFile<std::uint64_t>();
+			if (offset >= m_Size) throw std::runtime_error("Failed to parse the file. Invalid format.");
+
+			functions.emplace_back(arity, hasResult, [buffer = m_Buffer, offset, version = m_ByteCodeVersion] {
+				Parser parser;
+				parser.m_Buffer = buffer;
+				parser.m_Data = buffer->GetData();
+				parser.m_Size = buffer->GetSize();
+				parser.m_Pos = static_cast<std::size_t>(offset);
+				parser.m_ByteCodeVersion = version;
+				return parser.ParseInstructions();
+			});
 		}
 
+		const auto entryPointOffset = ReadFile<std::uint64_t>();
+		if (entryPointOffset >= m_Size) throw std::runtime_error("Failed to parse the file. Invalid format.");
+
+		m_Pos = static_cast<std::size_t>(entryPointOffset);
 		m_ByteFile.SetFunctions(std::move(functions));
 	}
 	Instructions Parser::ParseInstructions() {
@@ -158,15 +317,12 @@ namespace svm {
 		const auto instCount = ReadFile<std::uint64_t>();
 		std::vector<Instruction> insts(static_cast<std::size_t>(instCount));
 
-		std::uint64_t nextOffset = 0;
 		for (std::size_t i = 0; i < instCount; ++i) {
 			insts[i].OpCode = ReadOpCode();
-			insts[i].Offset = nextOffset;
-			if (insts[i].HasOperand()) {
+			if (insts[i].OpCode == OpCode::TCall && m_ByteCodeVersion < ByteCodeVersion::v0_5_0) throw std::runtime_error("Failed to parse the file. Invalid format.");
+			else if (insts[i].HasOperand()) {
 				insts[i].Operand = ReadFile<std::uint32_t>();
-				nextOffset += 4;
 			}
-			++nextOffset;
 		}
 
 		return { std::move(labels), std::move(insts) };
@@ -0,0 +1,93 @@
+#include <svm/Profiler.hpp>
+
+#include <svm/IO.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace svm {
+	NGramProfiler::NGramProfiler(std::size_t length) noexcept
+		: m_Length(std::min(length, MaxLength)) {}
+	NGramProfiler::NGramProfiler(NGramProfiler&& profiler) noexcept
+		: m_Length(profiler.m_Length), m_Window(profiler.m_Window), m_WindowSize(profiler.m_WindowSize), m_LastInstruction(profiler.m_LastInstruction),
+		m_TotalCount(profiler.m_TotalCount), m_Counts(std::move(profiler.m_Counts)) {}
+
+	NGramProfiler& NGramProfiler::operator=(NGramProfiler&& profiler) noexcept {
+		m_Length = profiler.m_Length;
+		m_Window = profiler.m_Window;
+		m_WindowSize = profiler.m_WindowSize;
+		m_LastInstruction = profiler.m_LastInstruction;
+
+		m_TotalCount = profiler.m_TotalCount;
+		m_Counts = std::move(profiler.m_Counts);
+		return *this;
+	}
+
+	void NGramProfiler::Clear() noexcept {
+		m_Window = 0;
+		m_WindowSize = 0;
+		m_LastInstruction = nullptr;
+
+		m_TotalCount = 0;
+		m_Counts.clear();
+	}
+	void NGramProfiler::Record(const Instruction& instruction) {
+		// Only instructions that are adjacent in the code can be fused, so taken jumps, calls and returns break the window
+		if (!m_LastInstruction || &instruction != m_LastInstruction + 1) {
+			m_Window = 0;
+			m_WindowSize = 0;
+		}
+		m_LastInstruction = &instruction;
+
+		m_Window = (m_Window << 8) | static_cast<std::uint8_t>(instruction.OpCode);
+		if (m_Length != MaxLength) {
+			m_Window &= (static_cast<std::uint64_t>(1) << (m_Length * 8)) - 1;
+		}
+
+		if (++m_WindowSize >= m_Length) {
+			++m_Counts[m_Window];
+			++m_TotalCount;
+		}
+	}
+
+	std::size_t NGramProfiler::GetLength() const noexcept {
+		return m_Length;
+	}
+	std::uint64_t NGramProfiler::GetTotalCount() const noexcept {
+		return m_TotalCount;
+	}
+	std::vector<NGram> NGramProfiler::GetMostFrequent(std::size_t count) const {
+		std::vector<std::pair<std::uint64_t, std::uint64_t>> counts(m_Counts.begin(), m_Counts.end());
+		count = std::min(count, counts.size());
+
+		std::partial_sort(counts.begin(), counts.begin() + count, counts.end(), [](const auto& lhs, const auto& rhs) {
+			return lhs.second > rhs.second || (lhs.second == rhs.second && lhs.first < rhs.first);
+		});
+
+		std::vector<NGram> result(count);
+		for (std::size_t i = 0; i < count; ++i) {
+			result[i].OpCodes.resize(m_Length);
+			for (std::size_t j = 0; j < m_Length; ++j) {
+				result[i].OpCodes[j] = static_cast<OpCode>(counts[i].first >> ((m_Length - j - 1) * 8));
+			}
+			result[i].Count = counts[i].second;
+		}
+		return result;
+	}
+
+	std::ostream& operator<<(std::ostream& stream, const NGram& nGram) {
+		for (std::size_t i = 0; i < nGram.OpCodes.size(); ++i) {
+			if (i != 0) {
+				stream << ' ';
+			}
+			const std::uint8_t opCode = static_cast<std::uint8_t>(nGram.OpCodes[i]);
+			if (opCode < std::size(Mnemonics)) {
+				stream << Mnemonics[opCode];
+			} else {
+				stream << "0x" << Hex(opCode);
+			}
+		}
+		return stream;
+	}
+}
@@ -140,6 +140,11 @@ namespace svm {
 			return false;
 		}
 
+		if (GetVariable("ngram") > 8) {
+			std::cout << "Error: Length of n-grams cannot be greater than 8.\n";
+			return false;
+		}
+
 		return true;
 	}
 }
\ No newline at end of file
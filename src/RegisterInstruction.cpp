@@ -0,0 +1,1056 @@
+#include <svm/RegisterInstruction.hpp>
+
+#include <svm/ConstantPool.hpp>
+#include <svm/Function.hpp>
+#include <svm/Interpreter.hpp>
+#include <svm/Object.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace svm {
+	std::int32_t GetValueSlot(std::size_t index) noexcept {
+		// Every value of register code is a fundamental object
+		return static_cast<std::int32_t>(sizeof(Type)) - static_cast<std::int32_t>((index + 1) * sizeof(IntObject));
+	}
+	std::int32_t GetArgumentSlot(std::size_t index) noexcept {
+		return static_cast<std::int32_t>(sizeof(StackFrame) + index * sizeof(IntObject) + sizeof(Type));
+	}
+	std::size_t GetFrameOffset(std::size_t stackBegin, std::int32_t slot) noexcept {
+		return static_cast<std::size_t>(static_cast<std::ptrdiff_t>(stackBegin) - (slot - static_cast<std::int32_t>(sizeof(Type))));
+	}
+}
+
+namespace {
+	using namespace svm;
+
+	bool IsSameValues(const std::vector<RegisterValue>& lhs, const std::vector<RegisterValue>& rhs) noexcept {
+		return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](const RegisterValue& lhs, const RegisterValue& rhs) {
+			return lhs.Type == rhs.Type && lhs.Source == rhs.Source && lhs.IsLocalVariable == rhs.IsLocalVariable;
+		});
+	}
+	bool IsSameState(const RegisterState& lhs, const RegisterState& rhs) noexcept {
+		return IsSameValues(lhs.Values, rhs.Values) && IsSameValues(lhs.LocalVariables, rhs.LocalVariables);
+	}
+
+	int GetTypeIndex(Type type) noexcept {
+		if (type == IntType) return 0;
+		else if (type == LongType) return 1;
+		else if (type == DoubleType) return 2;
+		else return -1;
+	}
+	RegisterOpCode Select(RegisterOpCode first, int typeIndex) noexcept {
+		return static_cast<RegisterOpCode>(static_cast<std::uint8_t>(first) + typeIndex);
+	}
+
+	class Translator final {
+	private:
+		const ByteFile& m_ByteFile;
+		const Instructions& m_Instructions;
+		RegisterCode& m_Result;
+
+		RegisterState m_State;
+		std::uint64_t m_Index = 0;
+		bool m_IsReachable = true;
+		std::size_t m_BlockBegin = 0;
+
+		std::vector<bool> m_IsBlockBegin;
+		std::vector<std::optional<RegisterState>> m_BlockStates;
+		std::vector<std::size_t> m_BlockInstructions;
+		std::vector<std::pair<std::size_t, std::uint64_t>> m_Jumps;
+
+	public:
+		Translator(const ByteFile& byteFile, const Instructions& instructions, RegisterCode& result) noexcept
+			: m_ByteFile(byteFile), m_Instructions(instructions), m_Result(result) {}
+
+	public:
+		void Translate(const std::vector<Type>& argumentTypes) {
+			const std::uint64_t instCount = m_Instructions.GetInstructionCount();
+			for (std::size_t i = 0; i < argumentTypes.size(); ++i) {
+				m_State.LocalVariables.push_back({ argumentTypes[i], GetArgumentSlot(i), true });
+			}
+
+			m_IsBlockBegin.assign(static_cast<std::size_t>(instCount + 1), false);
+			m_BlockStates.resize(static_cast<std::size_t>(instCount + 1));
+			m_BlockInstructions.assign(static_cast<std::size_t>(instCount + 1), 0);
+			m_Result.EntryIndices.assign(static_cast<std::size_t>(instCount), RegisterCode::NoEntry);
+
+			m_IsBlockBegin[0] = true;
+			for (std::uint64_t i = 0; i < instCount; ++i) {
+				const Instruction& inst = m_Instructions.GetInstruction(i);
+				if (OpCode::Jmp <= inst.OpCode && inst.OpCode <= OpCode::Jbe) {
+					if (const std::optional<std::uint64_t> target = GetTarget(inst.Operand); target) {
+						m_IsBlockBegin[static_cast<std::size_t>(*target)] = true;
+					}
+				}
+			}
+
+			for (; m_Index < instCount; ++m_Index) {
+				if (m_IsBlockBegin[static_cast<std::size_t>(m_Index)]) {
+					BeginBlock(m_Index);
+				}
+				if (m_IsReachable) {
+					TranslateInstruction(m_Index);
+				}
+			}
+			if (m_IsReachable) {
+				Exit(instCount);
+			}
+
+			for (const auto& [index, target] : m_Jumps) {
+				m_Result.Instructions[index].Immediate = m_BlockInstructions[static_cast<std::size_t>(target)];
+			}
+		}
+
+	private:
+		std::optional<std::uint64_t> GetTarget(std::uint32_t label) const noexcept {
+			if (label >= m_Instructions.GetLabelCount()) return std::nullopt;
+
+			const std::uint64_t target = m_Instructions.GetLabel(label);
+			if (target >= m_Instructions.GetInstructionCount()) return std::nullopt;
+			else return target;
+		}
+
+		void BeginBlock(std::uint64_t index) {
+			std::optional<RegisterState>& blockState = m_BlockStates[static_cast<std::size_t>(index)];
+			if (m_IsReachable) {
+				Flush();
+				if (!blockState) {
+					blockState = m_State;
+				} else if (!IsSameState(*blockState, m_State)) {
+					// The block was entered with another layout
+					Exit(index);
+				}
+			}
+
+			if (!blockState) {
+				m_IsReachable = false;
+				return;
+			}
+
+			m_State = *blockState;
+			m_IsReachable = true;
+			m_BlockBegin = m_Result.Instructions.size();
+			m_BlockInstructions[static_cast<std::size_t>(index)] = m_BlockBegin;
+
+			m_Result.EntryIndices[static_cast<std::size_t>(index)] = static_cast<std::uint32_t>(m_Result.Entries.size());
+			m_Result.Entries.push_back({ m_BlockBegin, m_State });
+		}
+		bool JumpTo(std::uint64_t target, const RegisterState& state, RegisterOpCode opCode, std::int32_t value) {
+			std::optional<RegisterState>& blockState = m_BlockStates[static_cast<std::size_t>(target)];
+			const bool isBackward = target <= m_Index;
+			if (!blockState) {
+				// Backward jumps can only reach blocks that were translated
+				if (isBackward) return false;
+
+				blockState = state;
+			} else if (!IsSameState(*blockState, state)) return false;
+
+			// Backward jumps can leave at their targets so that loops can move to another tier
+			const std::uint64_t exit = isBackward ? AddExit(target, *blockState) : 0;
+			m_Jumps.emplace_back(m_Result.Instructions.size(), target);
+			Emit(opCode, 0, value, static_cast<std::int32_t>(exit));
+			return true;
+		}
+
+		void Emit(RegisterOpCode opCode, std::int32_t destination, std::int32_t left = 0, std::int32_t right = 0, std::uint64_t immediate = 0) {
+			m_Result.Instructions.push_back({ opCode, destination, left, right, immediate });
+		}
+		std::uint64_t AddExit(std::uint64_t index) {
+			return AddExit(index, m_State);
+		}
+		std::uint64_t AddExit(std::uint64_t index, const RegisterState& state) {
+			m_Result.Exits.push_back({ index, state });
+			return m_Result.Exits.size() - 1;
+		}
+		void Exit(std::uint64_t index) {
+			Emit(RegisterOpCode::Exit, 0, 0, 0, AddExit(index));
+			m_IsReachable = false;
+		}
+
+		void Push(Type type, std::int32_t source) {
+			const std::int32_t slot = GetValueSlot(m_State.Values.size());
+			m_State.Values.push_back({ type, source == 0 ? slot : source, false });
+			m_Result.MaxValueCount = std::max(m_Result.MaxValueCount, m_State.Values.size());
+		}
+		std::int32_t Slot(std::size_t depth) const noexcept {
+			return GetValueSlot(m_State.Values.size() - depth - 1);
+		}
+		RegisterValue& Top(std::size_t depth = 0) noexcept {
+			return m_State.Values[m_State.Values.size() - depth - 1];
+		}
+		bool IsTemporary(std::size_t count, bool isTypeRequired = true) const noexcept {
+			if (m_State.Values.size() < count) return false;
+
+			for (std::size_t i = 0; i < count; ++i) {
+				const RegisterValue& value = m_State.Values[m_State.Values.size() - i - 1];
+				if (value.IsLocalVariable || (isTypeRequired && GetTypeIndex(value.Type) == -1)) return false;
+			}
+			return true;
+		}
+
+		void Flush() {
+			for (std::size_t i = 0; i < m_State.Values.size(); ++i) {
+				Flush(m_State.Values[i], GetValueSlot(i));
+			}
+		}
+		void Flush(RegisterValue& value, std::int32_t slot) {
+			if (value.Source != slot) {
+				Emit(RegisterOpCode::Move, slot, value.Source);
+				value.Source = slot;
+			}
+		}
+		void FlushAliases(std::int32_t source) {
+			for (std::size_t i = 0; i < m_State.Values.size(); ++i) {
+				if (m_State.Values[i].Source == source) {
+					Flush(m_State.Values[i], GetValueSlot(i));
+				}
+			}
+		}
+		bool HasAlias(std::int32_t source) const noexcept {
+			return std::any_of(m_State.Values.begin(), m_State.Values.end(), [source](const RegisterValue& value) {
+				return value.Source == source && !value.IsLocalVariable;
+			});
+		}
+
+	private:
+		void TranslateInstruction(std::uint64_t index) {
+			const Instruction& inst = m_Instructions.GetInstruction(index);
+			switch (inst.OpCode) {
+			case OpCode::Nop: break;
+
+			case OpCode::Push: TranslatePush(index, inst.Operand); break;
+			case OpCode::Pop: TranslatePop(index); break;
+			case OpCode::Load: TranslateLoad(index, inst.Operand); break;
+			case OpCode::Store: TranslateStore(index, inst.Operand); break;
+			case OpCode::Lea: TranslateLea(index, inst.Operand); break;
+			case OpCode::Copy: TranslateCopy(index); break;
+
+			case OpCode::Add: TranslateBinary(index, RegisterOpCode::AddInt, false); break;
+			case OpCode::Sub: TranslateBinary(index, RegisterOpCode::SubInt, false); break;
+			case OpCode::Mul: TranslateBinary(index, RegisterOpCode::MulInt, false); break;
+			case OpCode::IMul: TranslateSigned(index, RegisterOpCode::IMulInt, RegisterOpCode::MulDouble, false); break;
+			case OpCode::Div: TranslateBinary(index, RegisterOpCode::DivInt, true); break;
+			case OpCode::IDiv: TranslateSigned(index, RegisterOpCode::IDivInt, RegisterOpCode::DivDouble, true); break;
+			case OpCode::Mod: TranslateBinary(index, RegisterOpCode::ModInt, true); break;
+			case OpCode::IMod: TranslateSigned(index, RegisterOpCode::IModInt, RegisterOpCode::ModDouble, true); break;
+			case OpCode::Neg: TranslateUnary(index, RegisterOpCode::NegInt, RegisterOpCode::NegDouble); break;
+
+			case OpCode::And: TranslateBitwise(index, RegisterOpCode::AndInt); break;
+			case OpCode::Or: TranslateBitwise(index, RegisterOpCode::OrInt); break;
+			case OpCode::Xor: TranslateBitwise(index, RegisterOpCode::XorInt); break;
+			case OpCode::Not: TranslateUnary(index, RegisterOpCode::NotInt, RegisterOpCode::NotLong); break;
+			case OpCode::Shl:
+			case OpCode::Sal: TranslateShift(index, RegisterOpCode::ShlInt); break;
+			case OpCode::Shr: TranslateShift(index, RegisterOpCode::ShrInt); break;
+			case OpCode::Sar: TranslateShift(index, RegisterOpCode::SarInt); break;
+
+			case OpCode::Cmp: TranslateCompare(index, RegisterOpCode::CmpInt, RegisterOpCode::CmpDouble); break;
+			case OpCode::ICmp: TranslateCompare(index, RegisterOpCode::ICmpInt, RegisterOpCode::CmpDouble); break;
+			case OpCode::Jmp: TranslateJmp(index, inst.Operand); break;
+			case OpCode::Je: TranslateJump(index, inst.Operand, RegisterOpCode::JeInt); break;
+			case OpCode::Jne: TranslateJump(index, inst.Operand, RegisterOpCode::JneInt); break;
+			case OpCode::Ja: TranslateJump(index, inst.Operand, RegisterOpCode::JaInt); break;
+			case OpCode::Jae: TranslateJump(index, inst.Operand, RegisterOpCode::JaeInt); break;
+			case OpCode::Jb: TranslateJump(index, inst.Operand, RegisterOpCode::JbInt); break;
+			case OpCode::Jbe: TranslateJump(index, inst.Operand, RegisterOpCode::JbeInt); break;
+			case OpCode::Call: TranslateCall(index, inst.Operand); break;
+
+			case OpCode::ToI: TranslateConversion(index, IntType); break;
+			case OpCode::ToL: TranslateConversion(index, LongType); break;
+			case OpCode::ToD: TranslateConversion(index, DoubleType); break;
+
+			default: Exit(index); break;
+			}
+		}
+
+		void TranslatePush(std::uint64_t index, std::uint32_t operand) {
+			const ConstantPool& constantPool = m_ByteFile.GetConstantPool();
+			if (operand >= constantPool.GetAllCount()) {
+				Exit(index);
+				return;
+			}
+
+			const Type type = constantPool.GetConstantType(operand);
+			std::uint64_t value = 0;
+			if (type == IntType) {
+				value = constantPool.GetConstant<IntObject>(operand).Value;
+			} else if (type == LongType) {
+				value = constantPool.GetConstant<LongObject>(operand).Value;
+			} else if (type == DoubleType) {
+				const double constant = constantPool.GetConstant<DoubleObject>(operand).Value;
+				std::memcpy(&value, &constant, sizeof(value));
+			} else {
+				Exit(index);
+				return;
+			}
+
+			Push(type, 0);
+			Emit(RegisterOpCode::Const, Slot(0), 0, 0, value);
+		}
+		void TranslatePop(std::uint64_t index) {
+			if (m_State.Values.empty()) {
+				Exit(index);
+				return;
+			}
+
+			if (Top().IsLocalVariable) {
+				m_State.LocalVariables.pop_back();
+			}
+			m_State.Values.pop_back();
+		}
+		void TranslateLoad(std::uint64_t index, std::uint32_t operand) {
+			if (operand >= m_State.LocalVariables.size()) {
+				Exit(index);
+				return;
+			}
+
+			const RegisterValue variable = m_State.LocalVariables[operand];
+			if (GetTypeIndex(variable.Type) == -1) {
+				Push(variable.Type, 0);
+				Emit(RegisterOpCode::MoveObject, Slot(0), variable.Source);
+			} else {
+				Push(variable.Type, variable.Source);
+			}
+		}
+		void TranslateStore(std::uint64_t index, std::uint32_t operand) {
+			if (!IsTemporary(1, false) || operand > m_State.LocalVariables.size()) {
+				Exit(index);
+				return;
+			} else if (operand == m_State.LocalVariables.size()) {
+				RegisterValue& top = Top();
+				Flush(top, Slot(0));
+				top.IsLocalVariable = true;
+				m_State.LocalVariables.push_back(top);
+				return;
+			}
+
+			const RegisterValue variable = m_State.LocalVariables[operand];
+			const RegisterValue top = Top();
+			if (GetTypeIndex(top.Type) == -1 || top.Type != variable.Type) {
+				Exit(index);
+				return;
+			}
+
+			const std::int32_t slot = Slot(0);
+			m_State.Values.pop_back();
+			if (top.Source == variable.Source) return;
+
+			RegisterInstruction* const last = m_Result.Instructions.size() > m_BlockBegin ? &m_Result.Instructions.back() : nullptr;
+			if (last && top.Source == slot && last->Destination == slot && !HasAlias(variable.Source)) {
+				// The result is written to the local variable directly
+				last->Destination = variable.Source;
+				return;
+			}
+
+			FlushAliases(variable.Source);
+			Emit(RegisterOpCode::Move, variable.Source, top.Source);
+		}
+		void TranslateLea(std::uint64_t index, std::uint32_t operand) {
+			const std::uint64_t next = index + 1;
+			if (operand >= m_State.LocalVariables.size() || next >= m_Instructions.GetInstructionCount() || m_IsBlockBegin[static_cast<std::size_t>(next)]) {
+				Exit(index);
+				return;
+			}
+
+			const OpCode nextOpCode = m_Instructions.GetInstruction(next).OpCode;
+			const RegisterValue variable = m_State.LocalVariables[operand];
+			const int typeIndex = GetTypeIndex(variable.Type);
+			if ((nextOpCode != OpCode::Inc && nextOpCode != OpCode::Dec) || typeIndex == -1) {
+				Exit(index);
+				return;
+			}
+
+			// The pointer is pushed for a moment
+			m_Result.MaxValueCount = std::max(m_Result.MaxValueCount, m_State.Values.size() + 1);
+
+			FlushAliases(variable.Source);
+			Emit(Select(nextOpCode == OpCode::Inc ? RegisterOpCode::IncInt : RegisterOpCode::DecInt, typeIndex), variable.Source);
+			++m_Index;
+		}
+		void TranslateCopy(std::uint64_t index) {
+			if (!IsTemporary(1, false)) {
+				Exit(index);
+				return;
+			}
+
+			const RegisterValue top = Top();
+			if (GetTypeIndex(top.Type) == -1) {
+				Push(top.Type, 0);
+				Emit(RegisterOpCode::MoveObject, Slot(0), top.Source);
+			} else if (top.Source != Slot(0)) {
+				Push(top.Type, top.Source);
+			} else {
+				Push(top.Type, 0);
+				Emit(RegisterOpCode::Move, Slot(0), top.Source);
+			}
+		}
+
+		void TranslateBinary(std::uint64_t index, RegisterOpCode first, bool canExit) {
+			if (!IsTemporary(2) || Top().Type != Top(1).Type) {
+				Exit(index);
+				return;
+			}
+
+			EmitBinary(index, Select(first, GetTypeIndex(Top().Type)), Top().Type, canExit);
+		}
+		void TranslateSigned(std::uint64_t index, RegisterOpCode first, RegisterOpCode forDouble, bool canExit) {
+			if (!IsTemporary(2) || Top().Type != Top(1).Type) {
+				Exit(index);
+				return;
+			}
+
+			const Type type = Top().Type;
+			EmitBinary(index, type == DoubleType ? forDouble : Select(first, GetTypeIndex(type)), type, canExit);
+		}
+		void TranslateBitwise(std::uint64_t index, RegisterOpCode first) {
+			if (!IsTemporary(2) || Top().Type != Top(1).Type) {
+				Exit(index);
+				return;
+			}
+
+			// Doubles are treated as longs
+			const Type type = Top().Type;
+			EmitBinary(index, Select(first, type == IntType ? 0 : 1), type, false);
+		}
+		void TranslateShift(std::uint64_t index, RegisterOpCode first) {
+			if (!IsTemporary(2) || Top().Type != Top(1).Type || Top().Type == DoubleType) {
+				Exit(index);
+				return;
+			}
+
+			EmitBinary(index, Select(first, GetTypeIndex(Top().Type)), Top().Type, false);
+		}
+		void TranslateCompare(std::uint64_t index, RegisterOpCode first, RegisterOpCode forDouble) {
+			if (!IsTemporary(2) || Top().Type != Top(1).Type) {
+				Exit(index);
+				return;
+			}
+
+			const Type type = Top().Type;
+			EmitBinary(index, type == DoubleType ? forDouble : Select(first, GetTypeIndex(type)), IntType, false);
+		}
+		void EmitBinary(std::uint64_t index, RegisterOpCode opCode, Type resultType, bool canExit) {
+			const std::uint64_t exit = canExit ? AddExit(index) : 0;
+			const std::int32_t left = Top(1).Source;
+			const std::int32_t right = Top().Source;
+
+			m_State.Values.pop_back();
+			Top() = { resultType, Slot(0), false };
+			Emit(opCode, Slot(0), left, right, exit);
+		}
+		void TranslateUnary(std::uint64_t index, RegisterOpCode first, RegisterOpCode forDouble) {
+			if (!IsTemporary(1)) {
+				Exit(index);
+				return;
+			}
+
+			const Type type = Top().Type;
+			const std::int32_t source = Top().Source;
+			Top().Source = Slot(0);
+			Emit(type == DoubleType ? forDouble : Select(first, GetTypeIndex(type)), Slot(0), source);
+		}
+		void TranslateConversion(std::uint64_t index, Type to) {
+			if (!IsTemporary(1)) {
+				Exit(index);
+				return;
+			}
+
+			static constexpr RegisterOpCode conversions[3][3] = {
+				{ RegisterOpCode::Exit, RegisterOpCode::IntToLong, RegisterOpCode::IntToDouble },
+				{ RegisterOpCode::LongToInt, RegisterOpCode::Exit, RegisterOpCode::LongToDouble },
+				{ RegisterOpCode::DoubleToInt, RegisterOpCode::DoubleToLong, RegisterOpCode::Exit },
+			};
+
+			RegisterValue& top = Top();
+			if (top.Type == to) return;
+
+			const std::int32_t source = top.Source;
+			Emit(conversions[GetTypeIndex(top.Type)][GetTypeIndex(to)], Slot(0), source);
+			top = { to, Slot(0), false };
+		}
+
+		void TranslateJmp(std::uint64_t index, std::uint32_t operand) {
+			const std::optional<std::uint64_t> target = GetTarget(operand);
+			if (!target) {
+				Exit(index);
+				return;
+			}
+
+			Flush();
+			if (JumpTo(*target, m_State, RegisterOpCode::Jmp, 0)) {
+				m_IsReachable = false;
+			} else {
+				Exit(index);
+			}
+		}
+		void TranslateJump(std::uint64_t index, std::uint32_t operand, RegisterOpCode first) {
+			const std::optional<std::uint64_t> target = GetTarget(operand);
+			if (!target || !IsTemporary(1)) {
+				Exit(index);
+				return;
+			}
+
+			for (std::size_t i = 0; i < m_State.Values.size() - 1; ++i) {
+				Flush(m_State.Values[i], GetValueSlot(i));
+			}
+
+			RegisterState taken = m_State;
+			taken.Values.pop_back();
+
+			const RegisterValue top = Top();
+			if (!JumpTo(*target, taken, Select(first, GetTypeIndex(top.Type)), top.Source)) {
+				Exit(index);
+			}
+		}
+		void TranslateCall(std::uint64_t index, std::uint32_t operand) {
+			Exit(index);
+
+			const Functions& functions = m_ByteFile.GetFunctions();
+			const std::uint64_t next = index + 1;
+			if (operand >= functions.size() || next >= m_Instructions.GetInstructionCount()) return;
+
+			const Function& function = functions[operand];
+			if (!IsTemporary(function.GetArity(), false)) return;
+
+			// The interpreter continues from the next instruction after the call returns
+			for (std::size_t i = 0; i < m_State.Values.size(); ++i) {
+				m_State.Values[i].Source = GetValueSlot(i);
+			}
+			m_State.Values.resize(m_State.Values.size() - function.GetArity());
+			if (function.HasResult()) {
+				Push(NoneType, 0);
+			}
+
+			m_IsBlockBegin[static_cast<std::size_t>(next)] = true;
+			if (!m_BlockStates[static_cast<std::size_t>(next)]) {
+				m_BlockStates[static_cast<std::size_t>(next)] = m_State;
+			}
+		}
+	};
+}
+
+namespace {
+	using namespace svm;
+
+	bool IsJump(RegisterOpCode opCode) noexcept {
+		return RegisterOpCode::Jmp <= opCode && opCode <= RegisterOpCode::JbeDouble;
+	}
+	bool IsFallingThrough(RegisterOpCode opCode) noexcept {
+		return opCode != RegisterOpCode::Exit && opCode != RegisterOpCode::Jmp;
+	}
+	bool IsWriting(RegisterOpCode opCode) noexcept {
+		return opCode != RegisterOpCode::Exit && !IsJump(opCode);
+	}
+	bool IsIncrement(RegisterOpCode opCode) noexcept {
+		return RegisterOpCode::IncInt <= opCode && opCode <= RegisterOpCode::DecDouble;
+	}
+	bool IsUnary(RegisterOpCode opCode) noexcept {
+		return opCode == RegisterOpCode::Move || opCode == RegisterOpCode::MoveObject ||
+			(RegisterOpCode::NegInt <= opCode && opCode <= RegisterOpCode::NegDouble) ||
+			opCode == RegisterOpCode::NotInt || opCode == RegisterOpCode::NotLong ||
+			(RegisterOpCode::IntToLong <= opCode && opCode <= RegisterOpCode::DoubleToLong);
+	}
+	// Instructions whose destinations depend only on their operands. Divisions leave the code if they would throw.
+	bool IsComputing(RegisterOpCode opCode) noexcept {
+		return IsWriting(opCode) && opCode != RegisterOpCode::Const && opCode != RegisterOpCode::Move && opCode != RegisterOpCode::MoveObject && !IsIncrement(opCode);
+	}
+	// Computing instructions that never leave the code and are defined for any operands, so they can run where they did not
+	bool IsHoistable(RegisterOpCode opCode) noexcept {
+		return (RegisterOpCode::AddInt <= opCode && opCode <= RegisterOpCode::IMulLong) ||
+			(RegisterOpCode::NegInt <= opCode && opCode <= RegisterOpCode::NegDouble) ||
+			(RegisterOpCode::AndInt <= opCode && opCode <= RegisterOpCode::NotLong) ||
+			(RegisterOpCode::CmpInt <= opCode && opCode <= RegisterOpCode::LongToDouble);
+	}
+	bool IsCommutative(RegisterOpCode opCode) noexcept {
+		return (RegisterOpCode::AddInt <= opCode && opCode <= RegisterOpCode::AddDouble) ||
+			(RegisterOpCode::MulInt <= opCode && opCode <= RegisterOpCode::IMulLong) ||
+			(RegisterOpCode::AndInt <= opCode && opCode <= RegisterOpCode::XorLong);
+	}
+	// A value that an operand of an instruction is known to have
+	struct RegisterOperand final {
+		bool IsConstant = false;
+		std::uint64_t Value = 0;		// The constant, or the slot
+
+		bool operator==(const RegisterOperand& operand) const noexcept {
+			return IsConstant == operand.IsConstant && Value == operand.Value;
+		}
+		bool operator<(const RegisterOperand& operand) const noexcept {
+			return std::tie(IsConstant, Value) < std::tie(operand.IsConstant, operand.Value);
+		}
+		bool IsSlot(std::int32_t slot) const noexcept {
+			return !IsConstant && Value == static_cast<std::uint64_t>(static_cast<std::uint32_t>(slot));
+		}
+		std::int32_t GetSlot() const noexcept {
+			return static_cast<std::int32_t>(static_cast<std::uint32_t>(Value));
+		}
+
+		static RegisterOperand Slot(std::int32_t slot) noexcept {
+			return { false, static_cast<std::uint32_t>(slot) };
+		}
+		static RegisterOperand Constant(std::uint64_t value) noexcept {
+			return { true, value };
+		}
+	};
+
+	// A slot holds the result of an operation. Const and Move keep what they copy in Left.
+	struct RegisterFact final {
+		std::int32_t Slot = 0;
+		RegisterOpCode OpCode = RegisterOpCode::Exit;
+		RegisterOperand Left;
+		RegisterOperand Right;
+
+		bool operator==(const RegisterFact& fact) const noexcept {
+			return Slot == fact.Slot && OpCode == fact.OpCode && Left == fact.Left && Right == fact.Right;
+		}
+		bool operator<(const RegisterFact& fact) const noexcept {
+			return std::tie(Slot, OpCode, Left, Right) < std::tie(fact.Slot, fact.OpCode, fact.Left, fact.Right);
+		}
+		bool IsReading(std::int32_t slot) const noexcept {
+			return Left.IsSlot(slot) || Right.IsSlot(slot);
+		}
+	};
+
+	// Register code has no memory but its slots, so an instruction can move or be replaced as long as its operands keep their values.
+	// The interpreter can enter the code at any entry with any values, so nothing is known at entries.
+	class RegisterOptimizer final {
+	private:
+		struct Loop final {
+			std::size_t Header = 0;
+			std::vector<bool> Body;
+			std::size_t Size = 0;
+		};
+
+	private:
+		RegisterCode& m_Code;
+		std::vector<std::vector<std::size_t>> m_Predecessors;
+		std::vector<bool> m_IsEntry;
+		std::vector<bool> m_IsTrampoline;
+
+	public:
+		explicit RegisterOptimizer(RegisterCode& code) noexcept
+			: m_Code(code) {}
+
+	public:
+		void Optimize() {
+			// Instructions move out of the innermost loops first, and then out of the loops around them
+			while (HoistInvariants()) {}
+			NumberValues();
+		}
+
+	private:
+		void Analyze() {
+			const std::vector<RegisterInstruction>& insts = m_Code.Instructions;
+			m_Predecessors.assign(insts.size(), {});
+			for (std::size_t i = 0; i < insts.size(); ++i) {
+				const RegisterInstruction& inst = insts[i];
+				if (IsFallingThrough(inst.OpCode) && i + 1 < insts.size()) {
+					m_Predecessors[i + 1].push_back(i);
+				}
+				if (IsJump(inst.OpCode)) {
+					m_Predecessors[static_cast<std::size_t>(inst.Immediate)].push_back(i);
+				}
+			}
+
+			m_IsEntry.assign(insts.size() + 1, false);
+			for (const std::uint32_t entry : m_Code.EntryIndices) {
+				if (entry != RegisterCode::NoEntry) {
+					m_IsEntry[m_Code.Entries[entry].Instruction] = true;
+				}
+			}
+
+			// Blocks that are entered only from the interpreter and jump into loops compute the preheaders of the loops first
+			m_IsTrampoline.assign(insts.size(), false);
+			for (std::size_t i = 1; i < insts.size(); ++i) {
+				if (!m_IsEntry[i] || !m_Predecessors[i].empty()) continue;
+
+				std::size_t end = i;
+				while (end + 1 < insts.size() && IsFallingThrough(insts[end].OpCode) && !IsJump(insts[end].OpCode) && !IsBlockBegin(end + 1)) {
+					++end;
+				}
+				if (insts[end].OpCode == RegisterOpCode::Jmp) {
+					std::fill(m_IsTrampoline.begin() + static_cast<std::ptrdiff_t>(i), m_IsTrampoline.begin() + static_cast<std::ptrdiff_t>(end + 1), true);
+				}
+			}
+		}
+		bool IsBlockBegin(std::size_t index) const noexcept {
+			return index == 0 || m_IsEntry[index] || m_Predecessors[index].size() != 1 || m_Predecessors[index].front() != index - 1;
+		}
+		std::int32_t AddSlot() noexcept {
+			return GetValueSlot(m_Code.MaxValueCount++);
+		}
+
+	private: // Loop-invariant code motion
+		bool HoistInvariants() {
+			Analyze();
+			for (const Loop& loop : FindLoops()) {
+				std::vector<RegisterInstruction> preheader = Hoist(loop);
+				if (!preheader.empty()) {
+					InsertPreheader(loop, preheader);
+					return true;
+				}
+			}
+			return false;
+		}
+		std::vector<Loop> FindLoops() const {
+			const std::vector<RegisterInstruction>& insts = m_Code.Instructions;
+			std::vector<Loop> loops;
+			std::unordered_map<std::size_t, std::size_t> loopIndices;
+			for (std::size_t i = 0; i < insts.size(); ++i) {
+				const RegisterInstruction& inst = insts[i];
+				if (!IsJump(inst.OpCode) || inst.Immediate > i) continue;
+
+				const std::size_t header = static_cast<std::size_t>(inst.Immediate);
+				const auto [iter, isInserted] = loopIndices.emplace(header, loops.size());
+				if (isInserted) {
+					loops.push_back({ header, std::vector<bool>(insts.size()) });
+					loops.back().Body[header] = true;
+				}
+
+				// The body is everything that reaches the back-edge without passing the header
+				Loop& loop = loops[iter->second];
+				std::vector<std::size_t> worklist{ i };
+				while (!worklist.empty()) {
+					const std::size_t index = worklist.back();
+					worklist.pop_back();
+					if (loop.Body[index]) continue;
+
+					loop.Body[index] = true;
+					for (const std::size_t pred : m_Predecessors[index]) {
+						if (!m_IsTrampoline[pred]) {
+							worklist.push_back(pred);
+						}
+					}
+				}
+			}
+
+			// Loops have to be entered only through their headers or trampolines, and only divisions can leave them
+			loops.erase(std::remove_if(loops.begin(), loops.end(), [&](const Loop& loop) {
+				for (std::size_t i = 0; i < insts.size(); ++i) {
+					if (!loop.Body[i]) continue;
+					else if (insts[i].OpCode == RegisterOpCode::Exit) return true;
+					else if (i == loop.Header) continue;
+					else if (i == 0 || std::any_of(m_Predecessors[i].begin(), m_Predecessors[i].end(), [&](std::size_t pred) { return !loop.Body[pred] && !m_IsTrampoline[pred]; })) return true;
+				}
+				return false;
+			}), loops.end());
+
+			for (Loop& loop : loops) {
+				loop.Size = static_cast<std::size_t>(std::count(loop.Body.begin(), loop.Body.end(), true));
+			}
+			std::stable_sort(loops.begin(), loops.end(), [](const Loop& lhs, const Loop& rhs) {
+				return lhs.Size < rhs.Size;
+			});
+			return loops;
+		}
+		// Moves the invariant instructions of the loop to the returned preheader, where they write to new slots,
+		// and replaces them with moves from the new slots
+		std::vector<RegisterInstruction> Hoist(const Loop& loop) {
+			std::vector<RegisterInstruction>& insts = m_Code.Instructions;
+			std::unordered_set<std::int32_t> written;
+			for (std::size_t i = 0; i < insts.size(); ++i) {
+				if (loop.Body[i] && IsWriting(insts[i].OpCode)) {
+					written.insert(insts[i].Destination);
+				}
+			}
+
+			std::vector<RegisterInstruction> preheader;
+			std::unordered_map<std::uint64_t, std::int32_t> constantSlots;
+			const auto getSlot = [&](const RegisterOperand& operand) {
+				if (!operand.IsConstant) return operand.GetSlot();
+
+				const auto [iter, isInserted] = constantSlots.emplace(operand.Value, 0);
+				if (isInserted) {
+					iter->second = AddSlot();
+					preheader.push_back({ RegisterOpCode::Const, iter->second, 0, 0, operand.Value });
+				}
+				return iter->second;
+			};
+
+			// Slots that are written in the loop are invariant only after a move or a constant in the same block
+			std::unordered_map<std::int32_t, RegisterOperand> copies;
+			const auto getInvariant = [&](std::int32_t slot) -> std::optional<RegisterOperand> {
+				if (written.find(slot) == written.end()) return RegisterOperand::Slot(slot);
+				else if (const auto iter = copies.find(slot); iter != copies.end()) return iter->second;
+				else return std::nullopt;
+			};
+
+			for (std::size_t i = 0; i < insts.size(); ++i) {
+				if (!loop.Body[i]) continue;
+				else if (IsBlockBegin(i)) {
+					copies.clear();
+				}
+
+				RegisterInstruction& inst = insts[i];
+				if (IsHoistable(inst.OpCode)) {
+					const std::optional<RegisterOperand> left = getInvariant(inst.Left);
+					const std::optional<RegisterOperand> right = IsUnary(inst.OpCode) ? RegisterOperand() : getInvariant(inst.Right);
+					if (left && right) {
+						const std::int32_t slot = AddSlot();
+						const std::int32_t leftSlot = getSlot(*left);
+						const std::int32_t rightSlot = IsUnary(inst.OpCode) ? 0 : getSlot(*right);
+						preheader.push_back({ inst.OpCode, slot, leftSlot, rightSlot, inst.Immediate });
+
+						inst = { RegisterOpCode::Move, inst.Destination, slot };
+						copies[inst.Destination] = RegisterOperand::Slot(slot);
+						continue;
+					}
+				}
+				if (!IsWriting(inst.OpCode)) continue;
+
+				std::optional<RegisterOperand> value;
+				if (inst.OpCode == RegisterOpCode::Const) {
+					value = RegisterOperand::Constant(inst.Immediate);
+				} else if (inst.OpCode == RegisterOpCode::Move) {
+					value = getInvariant(inst.Left);
+				}
+
+				copies.erase(inst.Destination);
+				if (value) {
+					copies[inst.Destination] = *value;
+				}
+			}
+			return preheader;
+		}
+		void InsertPreheader(const Loop& loop, const std::vector<RegisterInstruction>& preheader) {
+			const std::vector<RegisterInstruction>& insts = m_Code.Instructions;
+			const std::size_t header = loop.Header;
+
+			// The interpreter can enter the loop in the middle, so such entries and the trampolines that jump into the loop
+			// have to compute the preheader too. New trampolines are skipped over before the preheader.
+			std::vector<std::size_t> entries;
+			for (std::size_t i = 0; i < m_Code.Entries.size(); ++i) {
+				const std::size_t instruction = m_Code.Entries[i].Instruction;
+				if (instruction != header && loop.Body[instruction]) {
+					entries.push_back(i);
+				}
+			}
+
+			std::vector<std::vector<RegisterInstruction>> insertions(insts.size());
+			for (std::size_t i = 0; i < insts.size(); ++i) {
+				const RegisterInstruction& inst = insts[i];
+				if (m_IsTrampoline[i] && inst.OpCode == RegisterOpCode::Jmp && inst.Immediate != header && loop.Body[static_cast<std::size_t>(inst.Immediate)]) {
+					std::size_t begin = i;
+					while (!m_IsEntry[begin]) {
+						--begin;
+					}
+					insertions[begin] = preheader;
+				}
+			}
+
+			std::vector<RegisterInstruction>& headerInsertion = insertions[header];
+			const std::size_t trampolineSize = preheader.size() + 1;
+			if (!entries.empty()) {
+				headerInsertion.push_back({ RegisterOpCode::Jmp });
+				for (std::size_t i = 0; i < entries.size(); ++i) {
+					headerInsertion.insert(headerInsertion.end(), preheader.begin(), preheader.end());
+					headerInsertion.push_back({ RegisterOpCode::Jmp });
+				}
+			}
+			headerInsertion.insert(headerInsertion.end(), preheader.begin(), preheader.end());
+
+			// Jumps from outside the loop go to the preheader, and back-edges skip it
+			std::vector<std::size_t> newIndices(insts.size() + 1);
+			std::size_t insertionCount = 0;
+			for (std::size_t i = 0; i < insts.size(); ++i) {
+				newIndices[i] = i + insertionCount;
+				insertionCount += insertions[i].size();
+			}
+			newIndices[insts.size()] = insts.size() + insertionCount;
+			const auto getNewIndex = [&](std::size_t index, bool isInserted) {
+				return newIndices[index] + (isInserted ? 0 : insertions[index].size());
+			};
+
+			std::vector<RegisterInstruction> newInsts;
+			newInsts.reserve(insts.size() + insertionCount);
+			for (std::size_t i = 0; i < insts.size(); ++i) {
+				newInsts.insert(newInsts.end(), insertions[i].begin(), insertions[i].end());
+				newInsts.push_back(insts[i]);
+
+				RegisterInstruction& inst = newInsts.back();
+				if (IsJump(inst.OpCode)) {
+					const std::size_t target = static_cast<std::size_t>(inst.Immediate);
+					inst.Immediate = getNewIndex(target, target != header || !loop.Body[i]);
+				}
+			}
+
+			for (RegisterEntry& entry : m_Code.Entries) {
+				entry.Instruction = getNewIndex(entry.Instruction, true);
+			}
+			if (!entries.empty()) {
+				const std::size_t headerBegin = newIndices[header];
+				const std::size_t preheaderBegin = headerBegin + 1 + entries.size() * trampolineSize;
+				newInsts[headerBegin].Immediate = preheaderBegin;
+				for (std::size_t i = 0; i < entries.size(); ++i) {
+					RegisterEntry& entry = m_Code.Entries[entries[i]];
+					const std::size_t trampolineBegin = headerBegin + 1 + i * trampolineSize;
+					newInsts[trampolineBegin + preheader.size()].Immediate = entry.Instruction;
+					entry.Instruction = trampolineBegin;
+				}
+			}
+			m_Code.Instructions = std::move(newInsts);
+		}
+
+	private: // Global value numbering
+		void NumberValues() {
+			Analyze();
+			const std::vector<RegisterInstruction>& insts = m_Code.Instructions;
+			std::vector<std::size_t> blockBegins;
+			std::vector<std::size_t> blockIndices(insts.size());
+			for (std::size_t i = 0; i < insts.size(); ++i) {
+				if (IsBlockBegin(i)) {
+					blockBegins.push_back(i);
+				}
+				blockIndices[i] = blockBegins.size() - 1;
+			}
+			blockBegins.push_back(insts.size());
+
+			// The values that are available at the beginning of each block on every path, or nullopt if no path was followed yet
+			const std::size_t blockCount = blockBegins.size() - 1;
+			std::vector<std::optional<std::vector<RegisterFact>>> blockFacts(blockCount);
+			std::vector<std::size_t> worklist;
+			for (std::size_t i = 0; i < blockCount; ++i) {
+				if (i == 0 || m_IsEntry[blockBegins[i]]) {
+					blockFacts[i].emplace();
+					worklist.push_back(i);
+				}
+			}
+			while (!worklist.empty()) {
+				const std::size_t block = worklist.back();
+				worklist.pop_back();
+
+				std::vector<RegisterFact> facts = *blockFacts[block];
+				const std::size_t last = blockBegins[block + 1] - 1;
+				for (std::size_t i = blockBegins[block]; i <= last; ++i) {
+					Apply(insts[i], facts);
+				}
+
+				const auto merge = [&](std::size_t target) {
+					const std::size_t successor = blockIndices[target];
+					if (m_IsEntry[target]) return;
+
+					std::optional<std::vector<RegisterFact>>& successorFacts = blockFacts[successor];
+					if (!successorFacts) {
+						successorFacts = facts;
+					} else {
+						std::vector<RegisterFact> intersection;
+						std::set_intersection(successorFacts->begin(), successorFacts->end(), facts.begin(), facts.end(), std::back_inserter(intersection));
+						if (intersection.size() == successorFacts->size()) return;
+
+						*successorFacts = std::move(intersection);
+					}
+					worklist.push_back(successor);
+				};
+				if (IsFallingThrough(insts[last].OpCode) && last + 1 < insts.size()) {
+					merge(last + 1);
+				}
+				if (IsJump(insts[last].OpCode)) {
+					merge(static_cast<std::size_t>(insts[last].Immediate));
+				}
+			}
+
+			// Instructions whose values are in other slots become moves, and the ones whose values are in their destinations are removed
+			std::vector<RegisterInstruction> newInsts;
+			std::vector<std::size_t> newIndices(insts.size() + 1);
+			for (std::size_t block = 0; block < blockCount; ++block) {
+				std::optional<std::vector<RegisterFact>> facts = blockFacts[block];
+				for (std::size_t i = blockBegins[block]; i < blockBegins[block + 1]; ++i) {
+					newIndices[i] = newInsts.size();
+
+					const RegisterInstruction& inst = insts[i];
+					const std::optional<std::int32_t> slot = facts ? Apply(inst, *facts) : std::nullopt;
+					if (!slot) {
+						newInsts.push_back(inst);
+					} else if (*slot != inst.Destination) {
+						newInsts.push_back({ RegisterOpCode::Move, inst.Destination, *slot });
+					}
+				}
+			}
+			newIndices[insts.size()] = newInsts.size();
+
+			for (RegisterInstruction& inst : newInsts) {
+				if (IsJump(inst.OpCode)) {
+					inst.Immediate = newIndices[static_cast<std::size_t>(inst.Immediate)];
+				}
+			}
+			for (RegisterEntry& entry : m_Code.Entries) {
+				entry.Instruction = newIndices[entry.Instruction];
+			}
+			m_Code.Instructions = std::move(newInsts);
+		}
+		// Updates the facts after the instruction, and returns a slot that already had the value of the instruction
+		static std::optional<std::int32_t> Apply(const RegisterInstruction& inst, std::vector<RegisterFact>& facts) {
+			if (!IsWriting(inst.OpCode)) return std::nullopt;
+
+			const auto getOperand = [&facts](std::int32_t slot) {
+				for (const RegisterFact& fact : facts) {
+					if (fact.Slot != slot) continue;
+					else if (fact.OpCode == RegisterOpCode::Const || fact.OpCode == RegisterOpCode::Move) return fact.Left;
+				}
+				return RegisterOperand::Slot(slot);
+			};
+
+			const std::int32_t destination = inst.Destination;
+			std::vector<RegisterFact> newFacts;
+			std::optional<std::int32_t> result;
+			if (inst.OpCode == RegisterOpCode::Const) {
+				newFacts.push_back({ destination, inst.OpCode, RegisterOperand::Constant(inst.Immediate), RegisterOperand() });
+			} else if (inst.OpCode == RegisterOpCode::Move) {
+				// The destination has every value that the source has
+				newFacts.push_back({ destination, inst.OpCode, getOperand(inst.Left), RegisterOperand() });
+				for (const RegisterFact& fact : facts) {
+					if (fact.Slot == inst.Left && fact.OpCode != RegisterOpCode::Const && fact.OpCode != RegisterOpCode::Move) {
+						newFacts.push_back({ destination, fact.OpCode, fact.Left, fact.Right });
+					}
+				}
+			} else if (IsComputing(inst.OpCode)) {
+				RegisterOperand left = getOperand(inst.Left);
+				RegisterOperand right = IsUnary(inst.OpCode) ? RegisterOperand() : getOperand(inst.Right);
+				if (IsCommutative(inst.OpCode) && right < left) {
+					std::swap(left, right);
+				}
+
+				const RegisterFact fact{ destination, inst.OpCode, left, right };
+				for (const RegisterFact& available : facts) {
+					if (available.OpCode == fact.OpCode && available.Left == fact.Left && available.Right == fact.Right) {
+						result = available.Slot;
+						break;
+					}
+				}
+				newFacts.push_back(fact);
+			}
+
+			facts.erase(std::remove_if(facts.begin(), facts.end(), [destination](const RegisterFact& fact) {
+				return fact.Slot == destination || fact.IsReading(destination);
+			}), facts.end());
+			for (const RegisterFact& fact : newFacts) {
+				if (!fact.IsReading(destination)) {
+					facts.insert(std::lower_bound(facts.begin(), facts.end(), fact), fact);
+				}
+			}
+			return result;
+		}
+	};
+}
+
+namespace svm {
+	RegisterCode TranslateInstructions(const ByteFile& byteFile, const Instructions& instructions, const std::vector<Type>& argumentTypes) {
+		RegisterCode result;
+		if (std::all_of(argumentTypes.begin(), argumentTypes.end(), [](Type type) { return type.IsFundamentalType(); })) {
+			Translator(byteFile, instructions, result).Translate(argumentTypes);
+		}
+		return result;
+	}
+	void OptimizeRegisterCode(RegisterCode& code) {
+		if (!code.Instructions.empty()) {
+			RegisterOptimizer(code).Optimize();
+		}
+	}
+}
\ No newline at end of file
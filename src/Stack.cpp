@@ -27,36 +27,6 @@ namespace svm {
 		m_Used = 0;
 	}
 
-	const Type* Stack::GetTopType() const noexcept {
-		return GetTop<Type>();
-	}
-	Type* Stack::GetTopType() noexcept {
-		return GetTop<Type>();
-	}
-
-	std::size_t Stack::GetSize() const noexcept {
-		return m_Data.size();
-	}
-	std::size_t Stack::GetUsedSize() const noexcept {
-		return m_Used;
-	}
-	void Stack::SetUsedSize(std::size_t newUsedSize) noexcept {
-		m_Used = newUsedSize;
-	}
-	std::size_t Stack::GetFreeSize() const noexcept {
-		return GetSize() - GetUsedSize();
-	}
-
-	bool Stack::Expand(std::size_t delta) noexcept {
-		if (GetFreeSize() < delta) return false;
-
-		m_Used += delta;
-		return true;
-	}
-	void Stack::Reduce(std::size_t delta) noexcept {
-		m_Used -= delta;
-	}
-
 	const std::uint8_t* Stack::Begin() const noexcept {
 		return &*m_Data.begin();
 	}
@@ -20,21 +20,30 @@ namespace svm {
 }
 
 namespace svm {
-	bool Type::IsFundamentalType() const noexcept {
-		const TypeCode code = GetReference().Code;
+	static_assert(alignof(TypeInfo) > Type::TagMask);
 
-		return code != TypeCode::None && code < TypeCode::Array;
-	}
-	bool Type::IsArray() const noexcept {
-		return GetReference().Code == TypeCode::Array;
-	}
-	bool Type::IsStructure() const noexcept {
-		return GetReference().Code >= TypeCode::Structure;
-	}
-	bool Type::IsValidType() const noexcept {
-		return IsFundamentalType() || IsArray() || IsStructure();
+	Type::Type(const TypeInfo& data) noexcept
+		: m_Data(reinterpret_cast<std::uintptr_t>(&data)) {
+		TypeTag tag = TypeTag::None;
+		switch (data.Code) {
+		case TypeCode::Int: tag = TypeTag::Int; break;
+		case TypeCode::Long: tag = TypeTag::Long; break;
+		case TypeCode::Double: tag = TypeTag::Double; break;
+		case TypeCode::Pointer: tag = TypeTag::Pointer; break;
+		case TypeCode::GCPointer: tag = TypeTag::GCPointer; break;
+		case TypeCode::Array: tag = TypeTag::Array; break;
+
+		default:
+			if (data.Code >= TypeCode::Structure) {
+				tag = TypeTag::Structure;
+			}
+			break;
+		}
+		m_Data |= static_cast<std::uintptr_t>(tag);
 	}
+}
 
+namespace svm {
 	namespace {
 		static const TypeInfo s_NoneType(TypeCode::None, "none", 0);
 		static const TypeInfo s_IntType(TypeCode::Int, "int", sizeof(IntObject));
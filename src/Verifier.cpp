@@ -0,0 +1,922 @@
+#include <svm/Verifier.hpp>
+
+#include <svm/ConstantPool.hpp>
+#include <svm/Interpreter.hpp>
+#include <svm/Structure.hpp>
+#include <svm/detail/InterpreterExceptionCode.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <set>
+#include <utility>
+
+namespace {
+	using namespace svm;
+
+	constexpr std::uint64_t NoAllocation = static_cast<std::uint64_t>(-1);
+	constexpr std::uint64_t NoLocalVariable = static_cast<std::uint64_t>(-1);
+
+	// The bits of an int or a long as an unsigned integer, which is how cmp and alea see them
+	struct ValueRange final {
+		std::uint64_t Min = 0;
+		std::uint64_t Max = std::numeric_limits<std::uint64_t>::max();
+
+		bool operator==(const ValueRange& other) const noexcept {
+			return Min == other.Min && Max == other.Max;
+		}
+	};
+
+	// The result of cmp that compared a local variable with a value in Range
+	struct Comparison final {
+		std::uint64_t LocalVariable = NoLocalVariable;
+		ValueRange Range;
+		bool IsSwapped = false;		// True if the local variable was the right operand
+
+		bool operator==(const Comparison& other) const noexcept {
+			return LocalVariable == other.LocalVariable && Range == other.Range && IsSwapped == other.IsSwapped;
+		}
+	};
+
+	struct AbstractValue final {
+		svm::Type Type = NoneType;				// NoneType if the type is not known
+		bool IsLocalVariable = false;
+		std::uint64_t Allocation = NoAllocation;	// The gcnew whose object the value points into
+		ValueRange Range;
+		std::uint64_t Count = 0;					// The count of the array that the value is or points to, 0 if it is not known
+		std::uint64_t Target = NoLocalVariable;		// The local variable whose address the pointer is
+		std::uint64_t Origin = NoLocalVariable;		// The local variable that the value was loaded from and still equals
+		::Comparison Comparison;
+		bool IsFrameAddress = false;				// True if the value may point into the stack frame, even if Target is not known
+
+		AbstractValue() noexcept = default;
+		AbstractValue(svm::Type type, bool isLocalVariable = false, std::uint64_t allocation = NoAllocation) noexcept
+			: Type(type), IsLocalVariable(isLocalVariable), Allocation(allocation) {}
+	};
+
+	struct AbstractState final {
+		std::vector<AbstractValue> Values;
+		std::vector<Type> LocalVariables;
+		std::vector<std::ptrdiff_t> LocalVariableOffsets;		// 0 if the offset depends on the path
+		std::vector<std::uint64_t> LocalVariableAllocations;	// The gcnew whose pointer the local variable took right after it
+		std::vector<ValueRange> LocalVariableRanges;
+		std::vector<std::uint64_t> LocalVariableCounts;			// The count of the array that the local variable is, 0 if it is not known
+		bool IsFrameVisible = false;							// True if a pointer into the stack frame may have escaped
+	};
+
+	bool IsPointerType(Type type) noexcept {
+		return type == PointerType || type == GCPointerType;
+	}
+	std::size_t GetValuesSize(std::vector<AbstractValue>::const_iterator begin, std::vector<AbstractValue>::const_iterator end) noexcept {
+		std::size_t result = 0;
+		for (; begin != end; ++begin) {
+			if (!begin->Type.IsFundamentalType()) return 0;
+
+			result += begin->Type->Size;
+		}
+		return result;
+	}
+	std::uint64_t GetMaxValue(Type type) noexcept {
+		return type == IntType ? std::numeric_limits<std::uint32_t>::max() : std::numeric_limits<std::uint64_t>::max();
+	}
+	// Operations that may wrap around leave the range of their result unknown
+	void StepRange(OpCode opCode, const AbstractValue& lhs, const AbstractValue& rhs, AbstractValue& result) noexcept {
+		const std::uint64_t maxValue = GetMaxValue(rhs.Type);
+		switch (opCode) {
+		case OpCode::Add:
+			if (rhs.Range.Max <= maxValue && lhs.Range.Max <= maxValue - rhs.Range.Max) {
+				result.Range = { lhs.Range.Min + rhs.Range.Min, lhs.Range.Max + rhs.Range.Max };
+			}
+			break;
+		case OpCode::Sub:
+			if (lhs.Range.Min >= rhs.Range.Max) {
+				result.Range = { lhs.Range.Min - rhs.Range.Max, lhs.Range.Max - rhs.Range.Min };
+			}
+			break;
+		case OpCode::And:
+			result.Range = { 0, std::min(lhs.Range.Max, rhs.Range.Max) };
+			break;
+		case OpCode::Mod:
+			if (rhs.Range.Max != 0) {
+				result.Range = { 0, std::min(lhs.Range.Max, rhs.Range.Max - 1) };
+			}
+			break;
+
+		case OpCode::ICmp:
+			// Signed comparisons agree with unsigned ones while the sign bits are clear
+			if (lhs.Range.Max > maxValue / 2 || rhs.Range.Max > maxValue / 2) break;
+			[[fallthrough]];
+		case OpCode::Cmp:
+			if (lhs.Origin != NoLocalVariable) {
+				result.Comparison = { lhs.Origin, rhs.Range, false };
+			} else if (rhs.Origin != NoLocalVariable) {
+				result.Comparison = { rhs.Origin, lhs.Range, true };
+			}
+			break;
+
+		default: break;
+		}
+	}
+	bool MergeTypes(std::vector<Type>& types, const std::vector<Type>& newTypes) {
+		bool isChanged = false;
+		for (std::size_t i = 0; i < types.size(); ++i) {
+			if (types[i] != newTypes[i] && types[i] != NoneType) {
+				types[i] = NoneType;
+				isChanged = true;
+			}
+		}
+		return isChanged;
+	}
+
+	class Verifier final {
+	private:
+		const ByteFile& m_ByteFile;
+		const Function* const m_Function;
+		const Instructions& m_Instructions;
+		const std::vector<Type>& m_ArgumentTypes;
+		VerifierResult& m_Result;
+
+		std::vector<std::optional<AbstractState>> m_States;
+		std::vector<std::uint64_t> m_WorkList;
+		bool m_IsFinal = false;
+
+		// Objects of gcnew escape if their pointers can be seen outside of the local variable that took them
+		std::vector<bool> m_IsEscaping;
+		std::vector<bool> m_IsStored;
+
+		// Local variables are written behind the back of the verifier if their addresses can be seen anywhere but
+		// the instruction that dereferences them, so their ranges are not tracked
+		std::vector<bool> m_IsAddressTaken;
+		bool m_IsAddressTakenChanged = false;
+
+		AbstractState m_State;
+		std::uint64_t m_Index = 0;
+
+	public:
+		Verifier(const ByteFile& byteFile, const Function* function, const std::vector<Type>& argumentTypes, VerifierResult& result) noexcept
+			: m_ByteFile(byteFile), m_Function(function), m_Instructions(function ? function->GetInstructions() : byteFile.GetEntryPoint()),
+			m_ArgumentTypes(argumentTypes), m_Result(result) {}
+
+	public:
+		bool Verify() {
+			const std::uint64_t instCount = m_Instructions.GetInstructionCount();
+			m_IsEscaping.resize(static_cast<std::size_t>(instCount));
+			m_IsStored.resize(static_cast<std::size_t>(instCount));
+			if (instCount == 0) return true;
+
+			// Ranges that were found before an address was taken may be wrong, so the states are found again without them
+			do {
+				m_IsAddressTakenChanged = false;
+				m_States.assign(static_cast<std::size_t>(instCount), std::nullopt);
+				if (!Flow(0, MakeEntryState())) return false;
+
+				while (!m_WorkList.empty()) {
+					m_Index = m_WorkList.back();
+					m_WorkList.pop_back();
+
+					m_State = *m_States[static_cast<std::size_t>(m_Index)];
+					if (!Step(m_Instructions.GetInstruction(m_Index))) return false;
+				}
+			} while (m_IsAddressTakenChanged);
+
+			// States are stable now, so the same steps give the proofs and the errors
+			m_IsFinal = true;
+			m_Result.OperandTypes.assign(static_cast<std::size_t>(instCount), NoneType);
+			m_Result.LocalVariableOffsets.assign(static_cast<std::size_t>(instCount), 0);
+			m_Result.ArgumentTypes.assign(static_cast<std::size_t>(instCount), {});
+			m_Result.LocalAllocations.assign(static_cast<std::size_t>(instCount), NoAllocation);
+			m_Result.IsFrameVisible.assign(static_cast<std::size_t>(instCount), true);
+			for (m_Index = 0; m_Index < instCount; ++m_Index) {
+				if (!m_States[static_cast<std::size_t>(m_Index)]) continue;
+
+				m_State = *m_States[static_cast<std::size_t>(m_Index)];
+				Step(m_Instructions.GetInstruction(m_Index));
+			}
+
+			for (std::uint64_t& allocation : m_Result.LocalAllocations) {
+				if (allocation != NoAllocation && (m_IsEscaping[static_cast<std::size_t>(allocation)] || !m_IsStored[static_cast<std::size_t>(allocation)])) {
+					allocation = NoAllocation;
+				}
+			}
+			return true;
+		}
+
+	private:
+		AbstractState MakeEntryState() const {
+			// Arguments lie below the stack frame, so they are local variables but not values
+			AbstractState entry;
+			if (m_Function) {
+				const std::uint16_t arity = m_Function->GetArity();
+				entry.LocalVariables.assign(arity, NoneType);
+				entry.LocalVariableOffsets.assign(arity, 0);
+				entry.LocalVariableAllocations.assign(arity, NoAllocation);
+				entry.LocalVariableRanges.assign(arity, {});
+				entry.LocalVariableCounts.assign(arity, 0);
+
+				std::ptrdiff_t offset = -static_cast<std::ptrdiff_t>(sizeof(StackFrame));
+				for (std::size_t i = 0; i < m_ArgumentTypes.size() && i < arity; ++i) {
+					const Type type = m_ArgumentTypes[i];
+					entry.LocalVariables[i] = type;
+					if (offset == 0 || !type.IsFundamentalType()) {
+						offset = 0;
+					} else {
+						entry.LocalVariableOffsets[i] = offset;
+						offset -= static_cast<std::ptrdiff_t>(type->Size);
+					}
+				}
+			}
+			return entry;
+		}
+		bool Flow(std::uint64_t target, AbstractState&& state) {
+			if (target >= m_Instructions.GetInstructionCount()) {
+				// The interpreter prints the values that are left when the entry point ends
+				EscapeAll(state);
+				return true;
+			} else if (m_IsFinal) return true;
+
+			std::optional<AbstractState>& targetState = m_States[static_cast<std::size_t>(target)];
+			if (!targetState) {
+				targetState = std::move(state);
+				m_WorkList.push_back(target);
+				return true;
+			}
+
+			// The interpreter cannot tell which values are local variables at a join if the paths disagree
+			std::vector<AbstractValue>& values = targetState->Values;
+			std::vector<Type>& localVariables = targetState->LocalVariables;
+			std::vector<std::ptrdiff_t>& localVariableOffsets = targetState->LocalVariableOffsets;
+			std::vector<std::uint64_t>& localVariableAllocations = targetState->LocalVariableAllocations;
+			std::vector<ValueRange>& localVariableRanges = targetState->LocalVariableRanges;
+			std::vector<std::uint64_t>& localVariableCounts = targetState->LocalVariableCounts;
+			if (values.size() != state.Values.size() || localVariables.size() != state.LocalVariables.size()) return false;
+
+			bool isChanged = false;
+			const bool isWidening = target <= m_Index;
+			for (std::size_t i = 0; i < values.size(); ++i) {
+				if (values[i].IsLocalVariable != state.Values[i].IsLocalVariable) return false;
+				else if (values[i].Type != state.Values[i].Type && values[i].Type != NoneType) {
+					values[i].Type = NoneType;
+					isChanged = true;
+				}
+				isChanged |= MergeAllocations(values[i].Allocation, state.Values[i].Allocation);
+				isChanged |= MergeTargets(values[i].Target, state.Values[i].Target);
+				isChanged |= MergeRanges(values[i].Range, state.Values[i].Range, isWidening);
+				isChanged |= MergeFacts(values[i].Count, state.Values[i].Count, std::uint64_t(0));
+				isChanged |= MergeFacts(values[i].Origin, state.Values[i].Origin, NoLocalVariable);
+				isChanged |= MergeFacts(values[i].Comparison, state.Values[i].Comparison, Comparison());
+				isChanged |= MergeFlags(values[i].IsFrameAddress, state.Values[i].IsFrameAddress);
+			}
+			isChanged |= MergeFlags(targetState->IsFrameVisible, state.IsFrameVisible);
+			isChanged |= MergeTypes(localVariables, state.LocalVariables);
+			for (std::size_t i = 0; i < localVariables.size(); ++i) {
+				if (localVariableOffsets[i] != state.LocalVariableOffsets[i] && localVariableOffsets[i] != 0) {
+					localVariableOffsets[i] = 0;
+					isChanged = true;
+				}
+				isChanged |= MergeAllocations(localVariableAllocations[i], state.LocalVariableAllocations[i]);
+				isChanged |= MergeRanges(localVariableRanges[i], state.LocalVariableRanges[i], isWidening);
+				isChanged |= MergeFacts(localVariableCounts[i], state.LocalVariableCounts[i], std::uint64_t(0));
+			}
+
+			if (isChanged) {
+				m_WorkList.push_back(target);
+			}
+			return true;
+		}
+		bool Fail(std::uint32_t code) {
+			if (m_IsFinal) {
+				m_Result.Errors.push_back({ m_Function, &m_Instructions, m_Index, code });
+			}
+			return true;
+		}
+		void Prove(Type type) noexcept {
+			if (m_IsFinal) {
+				m_Result.OperandTypes[static_cast<std::size_t>(m_Index)] = type;
+			}
+		}
+		void ProveOffset(std::ptrdiff_t offset) noexcept {
+			if (m_IsFinal) {
+				m_Result.LocalVariableOffsets[static_cast<std::size_t>(m_Index)] = offset;
+			}
+		}
+		void Escape(std::uint64_t allocation) noexcept {
+			if (allocation != NoAllocation) {
+				m_IsEscaping[static_cast<std::size_t>(allocation)] = true;
+			}
+		}
+		void Escape(const AbstractValue& value) {
+			Escape(value.Allocation);
+			TakeAddress(value.Target);
+			if (value.IsFrameAddress) {
+				m_State.IsFrameVisible = true;
+			}
+		}
+		void EscapeAll(const AbstractState& state) {
+			for (const AbstractValue& value : state.Values) {
+				Escape(value);
+			}
+			for (const std::uint64_t allocation : state.LocalVariableAllocations) {
+				Escape(allocation);
+			}
+		}
+		// Paths that disagree on an object lose track of it
+		bool MergeAllocations(std::uint64_t& allocation, std::uint64_t newAllocation) noexcept {
+			if (allocation == newAllocation) return false;
+
+			Escape(allocation);
+			Escape(newAllocation);
+			if (allocation == NoAllocation) return false;
+
+			allocation = NoAllocation;
+			return true;
+		}
+
+		void TakeAddress(std::uint64_t localVariable) {
+			if (localVariable == NoLocalVariable) return;
+			else if (localVariable >= m_IsAddressTaken.size()) {
+				m_IsAddressTaken.resize(static_cast<std::size_t>(localVariable + 1));
+			}
+
+			if (!m_IsAddressTaken[static_cast<std::size_t>(localVariable)]) {
+				m_IsAddressTaken[static_cast<std::size_t>(localVariable)] = true;
+				m_IsAddressTakenChanged = true;
+			}
+		}
+		bool IsAddressTaken(std::uint64_t localVariable) const noexcept {
+			return localVariable < m_IsAddressTaken.size() && m_IsAddressTaken[static_cast<std::size_t>(localVariable)];
+		}
+		bool MergeTargets(std::uint64_t& target, std::uint64_t newTarget) {
+			if (target == newTarget) return false;
+
+			TakeAddress(target);
+			TakeAddress(newTarget);
+			if (target == NoLocalVariable) return false;
+
+			target = NoLocalVariable;
+			return true;
+		}
+		// Ranges that grow along a backward jump are widened at once, so that loops do not count their iterations
+		static bool MergeRanges(ValueRange& range, const ValueRange& newRange, bool isWidening) noexcept {
+			bool isChanged = false;
+			if (newRange.Min < range.Min) {
+				range.Min = isWidening ? 0 : newRange.Min;
+				isChanged = true;
+			}
+			if (newRange.Max > range.Max) {
+				range.Max = isWidening ? std::numeric_limits<std::uint64_t>::max() : newRange.Max;
+				isChanged = true;
+			}
+			return isChanged;
+		}
+		static bool MergeFlags(bool& flag, bool newFlag) noexcept {
+			if (flag || !newFlag) return false;
+
+			flag = true;
+			return true;
+		}
+		template<typename T>
+		static bool MergeFacts(T& fact, const T& newFact, const T& unknown) {
+			if (fact == newFact || fact == unknown) return false;
+
+			fact = unknown;
+			return true;
+		}
+
+		void SetRange(std::uint64_t localVariable, const ValueRange& range) {
+			m_State.LocalVariableRanges[static_cast<std::size_t>(localVariable)] = IsAddressTaken(localVariable) ? ValueRange() : range;
+		}
+		// Values stop following a local variable once it changes
+		void Forget(std::uint64_t localVariable, bool isDestroyed) {
+			for (AbstractValue& value : m_State.Values) {
+				if (value.Origin == localVariable) {
+					value.Origin = NoLocalVariable;
+				}
+				if (value.Comparison.LocalVariable == localVariable) {
+					value.Comparison = {};
+				}
+				if (isDestroyed && value.Target == localVariable) {
+					TakeAddress(localVariable);
+					value.Target = NoLocalVariable;
+					value.Count = 0;
+				}
+			}
+		}
+		// Narrows the ranges of a local variable and its copies on the path where a comparison has the relation
+		static void Refine(AbstractState& state, const Comparison& comparison, OpCode relation) noexcept {
+			if (comparison.LocalVariable == NoLocalVariable) return;
+
+			// Relations are of the form of 'local variable ? other'
+			static constexpr OpCode swapped[] = { OpCode::Je, OpCode::Jne, OpCode::Jb, OpCode::Jbe, OpCode::Ja, OpCode::Jae };
+			if (comparison.IsSwapped) {
+				relation = swapped[static_cast<std::size_t>(relation) - static_cast<std::size_t>(OpCode::Je)];
+			}
+
+			ValueRange refined;
+			const ValueRange& other = comparison.Range;
+			switch (relation) {
+			case OpCode::Je: refined = other; break;
+			case OpCode::Ja: if (other.Min == std::numeric_limits<std::uint64_t>::max()) return; refined.Min = other.Min + 1; break;
+			case OpCode::Jae: refined.Min = other.Min; break;
+			case OpCode::Jb: if (other.Max == 0) return; refined.Max = other.Max - 1; break;
+			case OpCode::Jbe: refined.Max = other.Max; break;
+			default: return;
+			}
+
+			const auto narrow = [&refined](ValueRange& range) noexcept {
+				const ValueRange narrowed{ std::max(range.Min, refined.Min), std::min(range.Max, refined.Max) };
+				if (narrowed.Min <= narrowed.Max) {
+					range = narrowed;
+				}
+			};
+			narrow(state.LocalVariableRanges[static_cast<std::size_t>(comparison.LocalVariable)]);
+			for (AbstractValue& value : state.Values) {
+				if (value.Origin == comparison.LocalVariable) {
+					narrow(value.Range);
+				}
+			}
+		}
+
+		bool Step(const Instruction& inst) {
+			std::vector<AbstractValue>& values = m_State.Values;
+			std::vector<Type>& localVariables = m_State.LocalVariables;
+			std::vector<std::ptrdiff_t>& localVariableOffsets = m_State.LocalVariableOffsets;
+			std::vector<std::uint64_t>& localVariableAllocations = m_State.LocalVariableAllocations;
+			std::vector<ValueRange>& localVariableRanges = m_State.LocalVariableRanges;
+			std::vector<std::uint64_t>& localVariableCounts = m_State.LocalVariableCounts;
+			const AbstractValue top = values.empty() ? AbstractValue() : values.back();
+			const AbstractValue second = values.size() < 2 ? AbstractValue() : values[values.size() - 2];
+			const bool hasTop = !values.empty();
+			const bool hasSecond = values.size() >= 2;
+
+			switch (inst.OpCode) {
+			case OpCode::Nop:
+			case OpCode::ToB:
+			case OpCode::ToS:
+			case OpCode::ToF:
+				break;
+
+			case OpCode::Push: {
+				const ConstantPool& constantPool = m_ByteFile.GetConstantPool();
+				const std::uint32_t constCount = constantPool.GetAllCount();
+				if (inst.Operand < constCount) {
+					const Type type = constantPool.GetConstantType(inst.Operand);
+					values.push_back({ type });
+					if (type == IntType) {
+						const std::uint64_t value = constantPool.GetConstant<IntObject>(inst.Operand).Value;
+						values.back().Range = { value, value };
+					} else if (type == LongType) {
+						const std::uint64_t value = constantPool.GetConstant<LongObject>(inst.Operand).Value;
+						values.back().Range = { value, value };
+					}
+				} else if (inst.Operand - constCount < m_ByteFile.GetStructures().GetStructureCount()) {
+					values.push_back({});
+				} else return Fail(SVM_IEC_CONSTANTPOOL_OUTOFRANGE);
+				break;
+			}
+
+			case OpCode::Pop:
+				if (!hasTop) return Fail(SVM_IEC_STACK_EMPTY);
+				else if (top.IsLocalVariable) {
+					Forget(localVariables.size() - 1, true);
+					localVariables.pop_back();
+					localVariableOffsets.pop_back();
+					localVariableAllocations.pop_back();
+					localVariableRanges.pop_back();
+					localVariableCounts.pop_back();
+				}
+				values.pop_back();
+				break;
+
+			case OpCode::Load:
+				if (inst.Operand >= localVariables.size()) return Fail(SVM_IEC_LOCALVARIABLE_OUTOFRANGE);
+
+				Prove(localVariables[inst.Operand]);
+				ProveOffset(localVariableOffsets[inst.Operand]);
+				if (m_IsFinal) {
+					m_Result.LocalAllocations[static_cast<std::size_t>(m_Index)] = localVariableAllocations[inst.Operand];
+				}
+				values.push_back({ localVariables[inst.Operand], false, localVariableAllocations[inst.Operand] });
+				values.back().Range = localVariableRanges[inst.Operand];
+				values.back().Count = localVariableCounts[inst.Operand];
+				if (!IsAddressTaken(inst.Operand)) {
+					values.back().Origin = inst.Operand;
+				}
+				break;
+
+			case OpCode::Store:
+				if (top.IsLocalVariable) return Fail(SVM_IEC_STACK_EMPTY);
+				else if (inst.Operand > localVariables.size()) return Fail(SVM_IEC_LOCALVARIABLE_INVALIDINDEX);
+				else if (inst.Operand == localVariables.size()) {
+					if (!hasTop) return Fail(SVM_IEC_STACK_EMPTY);
+
+					// Only the local variable that takes the pointer right after gcnew can hold the object
+					const bool isAllocation = top.Allocation != NoAllocation && top.Allocation + 1 == m_Index;
+					if (isAllocation) {
+						m_IsStored[static_cast<std::size_t>(top.Allocation)] = true;
+					} else {
+						Escape(top);
+					}
+
+					// Only arrays keep their counts, since pointers may outlive their arrays
+					values.back().IsLocalVariable = true;
+					localVariables.push_back(top.Type);
+					localVariableOffsets.push_back(static_cast<std::ptrdiff_t>(GetValuesSize(values.begin(), values.end())));
+					localVariableAllocations.push_back(isAllocation ? top.Allocation : NoAllocation);
+					localVariableRanges.emplace_back();
+					localVariableCounts.push_back(top.Type == NoneType ? top.Count : 0);
+					SetRange(inst.Operand, top.Range);
+				} else if (!hasTop) return Fail(m_Function ? SVM_IEC_STACK_DIFFERENTTYPE : SVM_IEC_STACK_EMPTY);
+				else {
+					Type& varType = localVariables[inst.Operand];
+					if (top.Type != NoneType && varType != NoneType && top.Type != varType) return Fail(SVM_IEC_STACK_DIFFERENTTYPE);
+					else if (top.Type == NoneType && varType == NoneType) return false;	// An array would stay on the stack
+
+					if (top.Type == varType) {
+						Prove(varType);
+						ProveOffset(localVariableOffsets[inst.Operand]);
+					}
+					varType = top.Type != NoneType ? top.Type : varType;
+					Escape(top);
+					Escape(localVariableAllocations[inst.Operand]);
+					localVariableAllocations[inst.Operand] = NoAllocation;
+					localVariableCounts[inst.Operand] = top.Type == NoneType ? top.Count : 0;
+					SetRange(inst.Operand, top.Range);
+					Forget(inst.Operand, false);
+					values.pop_back();
+				}
+				break;
+
+			case OpCode::Lea:
+				if (inst.Operand >= localVariables.size()) return Fail(SVM_IEC_LOCALVARIABLE_OUTOFRANGE);
+
+				ProveOffset(localVariableOffsets[inst.Operand]);
+				Escape(localVariableAllocations[inst.Operand]);
+				values.push_back({ PointerType });
+				values.back().Count = localVariableCounts[inst.Operand];
+				values.back().Target = inst.Operand;
+				values.back().IsFrameAddress = true;
+				break;
+
+			case OpCode::Copy:
+				if (!hasTop || top.IsLocalVariable) return Fail(SVM_IEC_STACK_EMPTY);
+
+				values.push_back(top);
+				break;
+
+			case OpCode::Swap:
+				if (!hasTop) return Fail(SVM_IEC_STACK_EMPTY);
+				else if (top.Type == NoneType) return false;
+				else if (top.IsLocalVariable || second.IsLocalVariable) return Fail(SVM_IEC_STACK_EMPTY);
+				else if (!hasSecond) return Fail(m_Function ? SVM_IEC_STACK_DIFFERENTTYPE : SVM_IEC_STACK_EMPTY);
+				else if (second.Type != NoneType && second.Type != top.Type) return Fail(SVM_IEC_STACK_DIFFERENTTYPE);
+
+				// Swapping needs the same types, but a pointer to an object in a local variable is not a GC pointer
+				Escape(top);
+				Escape(second);
+				std::swap(values[values.size() - 2], values.back());
+				for (auto iter = values.end() - 2; iter != values.end(); ++iter) {
+					iter->Type = top.Type;
+					iter->Allocation = NoAllocation;
+					iter->Target = NoLocalVariable;
+				}
+				break;
+
+			case OpCode::Add:
+			case OpCode::Sub:
+			case OpCode::Mul:
+			case OpCode::IMul:
+			case OpCode::Div:
+			case OpCode::IDiv:
+			case OpCode::Mod:
+			case OpCode::IMod:
+			case OpCode::And:
+			case OpCode::Or:
+			case OpCode::Xor:
+			case OpCode::Shl:
+			case OpCode::Sal:
+			case OpCode::Shr:
+			case OpCode::Sar:
+			case OpCode::Cmp:
+			case OpCode::ICmp: {
+				const bool isCompare = inst.OpCode == OpCode::Cmp || inst.OpCode == OpCode::ICmp;
+				Escape(top);
+				Escape(second);
+				if (!hasTop) return Fail(SVM_IEC_STACK_EMPTY);
+				else if (top.Type == NoneType) {
+					// Every type fails if one of the operands is a local variable
+					if (top.IsLocalVariable || !hasSecond || second.IsLocalVariable) return true;
+				} else if (IsPointerType(top.Type) && !isCompare) return Fail(SVM_IEC_POINTER_INVALIDFORPOINTER);
+				else if (top.IsLocalVariable) return Fail(SVM_IEC_STACK_EMPTY);
+				else if (!hasSecond) return Fail(m_Function ? SVM_IEC_STACK_DIFFERENTTYPE : SVM_IEC_STACK_EMPTY);
+				else if (second.IsLocalVariable) return Fail(SVM_IEC_STACK_EMPTY);
+				else if (second.Type != NoneType && second.Type != top.Type) return Fail(SVM_IEC_STACK_DIFFERENTTYPE);
+				else if (second.Type == top.Type) {
+					Prove(top.Type);
+				}
+
+				values.pop_back();
+				values.back() = { isCompare ? IntType : top.Type != NoneType ? top.Type : second.Type };
+				if (second.Type == top.Type && (top.Type == IntType || top.Type == LongType)) {
+					StepRange(inst.OpCode, second, top, values.back());
+				}
+				break;
+			}
+
+			case OpCode::Neg:
+			case OpCode::Not:
+				Escape(top);
+				if (!hasTop || top.IsLocalVariable) return Fail(SVM_IEC_STACK_EMPTY);
+				else if (IsPointerType(top.Type)) return Fail(SVM_IEC_POINTER_INVALIDFORPOINTER);
+
+				values.back() = { top.Type };
+				break;
+
+			case OpCode::Inc:
+			case OpCode::Dec:
+				if (top.IsLocalVariable) return Fail(SVM_IEC_STACK_EMPTY);
+				else if (!hasTop) return Fail(m_Function ? SVM_IEC_POINTER_NOTPOINTER : SVM_IEC_STACK_EMPTY);
+				else if (top.Type != NoneType && !IsPointerType(top.Type)) return Fail(SVM_IEC_POINTER_NOTPOINTER);
+
+				values.pop_back();
+				if (top.Target != NoLocalVariable) {
+					const Type type = localVariables[top.Target];
+					const ValueRange range = localVariableRanges[top.Target];
+					if ((type != IntType && type != LongType) ||
+						(inst.OpCode == OpCode::Inc ? range.Max >= GetMaxValue(type) : range.Min == 0)) {
+						SetRange(top.Target, {});
+					} else if (inst.OpCode == OpCode::Inc) {
+						SetRange(top.Target, { range.Min + 1, range.Max + 1 });
+					} else {
+						SetRange(top.Target, { range.Min - 1, range.Max - 1 });
+					}
+					Forget(top.Target, false);
+				}
+				break;
+
+			case OpCode::Jmp:
+				if (inst.Operand >= m_Instructions.GetLabelCount()) return Fail(SVM_IEC_LABEL_OUTOFRANGE);
+				return Flow(m_Instructions.GetLabel(inst.Operand), std::move(m_State));
+
+			case OpCode::Je:
+			case OpCode::Jne:
+			case OpCode::Ja:
+			case OpCode::Jae:
+			case OpCode::Jb:
+			case OpCode::Jbe: {
+				Escape(top);
+				if (top.IsLocalVariable) return Fail(SVM_IEC_STACK_EMPTY);
+				else if (inst.Operand >= m_Instructions.GetLabelCount()) return Fail(SVM_IEC_LABEL_OUTOFRANGE);
+				else if (!hasTop) return Fail(SVM_IEC_STACK_EMPTY);
+
+				Prove(top.Type);
+
+				// The path that does not jump has the opposite relation
+				static constexpr OpCode opposites[] = { OpCode::Jne, OpCode::Je, OpCode::Jbe, OpCode::Jb, OpCode::Jae, OpCode::Ja };
+				AbstractState jumped = m_State;
+				jumped.Values.pop_back();
+				Refine(jumped, top.Comparison, inst.OpCode);
+				Refine(m_State, top.Comparison, opposites[static_cast<std::size_t>(inst.OpCode) - static_cast<std::size_t>(OpCode::Je)]);
+				if (!Flow(m_Instructions.GetLabel(inst.Operand), std::move(jumped))) return false;
+				break;
+			}
+
+			case OpCode::Call:
+			case OpCode::TCall: {
+				const Functions& functions = m_ByteFile.GetFunctions();
+				if (inst.Operand >= functions.size()) return Fail(SVM_IEC_FUNCTION_OUTOFRANGE);
+
+				// Tail calls work as calls in the entry point, which has no stack frame to reuse
+				const Function& function = functions[inst.Operand];
+				const bool isTailCall = inst.OpCode == OpCode::TCall && m_Function;
+				if (isTailCall && function.HasResult() != m_Function->HasResult()) return Fail(SVM_IEC_FUNCTION_DIFFERENTRESULT);
+
+				// Arguments that are local variables of the caller are not modelled
+				const std::uint16_t arity = function.GetArity();
+				if (values.size() < arity) return false;
+				for (std::size_t i = values.size() - arity; i < values.size(); ++i) {
+					if (values[i].IsLocalVariable) return false;
+
+					Escape(values[i]);
+				}
+				if (m_IsFinal) {
+					m_Result.IsFrameVisible[static_cast<std::size_t>(m_Index)] = m_State.IsFrameVisible;
+					// The first argument is the top of the stack
+					std::vector<Type>& argumentTypes = m_Result.ArgumentTypes[static_cast<std::size_t>(m_Index)];
+					for (auto iter = values.rbegin(); iter != values.rbegin() + arity; ++iter) {
+						argumentTypes.push_back(iter->Type);
+					}
+				}
+				if (isTailCall) return true;
+
+				values.erase(values.end() - arity, values.end());
+				if (function.HasResult()) {
+					values.push_back({});
+				}
+				break;
+			}
+
+			case OpCode::Ret:
+				// The result of a function goes to its caller, and the values of the entry point are printed
+				if (!m_Function) {
+					EscapeAll(m_State);
+				} else if (m_Function->HasResult()) {
+					Escape(top);
+				}
+				return true;
+
+			case OpCode::ToI:
+			case OpCode::ToL:
+			case OpCode::ToD:
+			case OpCode::ToP:
+				Escape(top);
+				if (!hasTop || top.IsLocalVariable) return Fail(SVM_IEC_STACK_EMPTY);
+
+				values.back() = { inst.OpCode == OpCode::ToI ? IntType :
+								  inst.OpCode == OpCode::ToL ? LongType :
+								  inst.OpCode == OpCode::ToD ? DoubleType : PointerType };
+				break;
+
+			case OpCode::Null:
+				values.push_back({ PointerType });
+				break;
+
+			case OpCode::New:
+			case OpCode::GCNew: {
+				const Structures& structures = m_ByteFile.GetStructures();
+				if (inst.Operand >= structures.GetStructureCount() + static_cast<std::uint32_t>(TypeCode::Structure)) return Fail(SVM_IEC_TYPE_OUTOFRANGE);
+				else if (GetTypeFromTypeCode(structures, static_cast<TypeCode>(inst.Operand)) == NoneType) return false;
+
+				if (inst.OpCode == OpCode::New) {
+					values.push_back({ PointerType });
+					break;
+				}
+
+				// An object that is still reachable when its gcnew runs again would share the local variable with the new one
+				const bool isStructure = inst.Operand >= static_cast<std::uint32_t>(TypeCode::Structure);
+				for (const AbstractValue& value : values) {
+					if (value.Allocation == m_Index) {
+						Escape(m_Index);
+					}
+				}
+				for (const std::uint64_t allocation : localVariableAllocations) {
+					if (allocation == m_Index) {
+						Escape(m_Index);
+					}
+				}
+				if (m_IsFinal && isStructure) {
+					m_Result.LocalAllocations[static_cast<std::size_t>(m_Index)] = m_Index;
+				}
+				values.push_back({ GCPointerType, false, isStructure ? m_Index : NoAllocation });
+				break;
+			}
+
+			case OpCode::Delete:
+				Escape(top);
+				if (top.IsLocalVariable) return Fail(SVM_IEC_STACK_EMPTY);
+				else if (!hasTop) return true;
+				else if (top.Type != NoneType && top.Type != PointerType) return Fail(SVM_IEC_POINTER_NOTPOINTER);
+
+				values.pop_back();
+				break;
+
+			case OpCode::GCNull:
+				values.push_back({ GCPointerType });
+				break;
+
+			// Pointers that are only dereferenced do not let their objects escape
+			case OpCode::FLea:
+			case OpCode::TLoad:
+			case OpCode::Count:
+				if (top.IsLocalVariable) return Fail(SVM_IEC_STACK_EMPTY);
+				else if (!hasTop) return true;
+				else if (top.Type != NoneType && !IsPointerType(top.Type)) return Fail(SVM_IEC_POINTER_NOTPOINTER);
+
+				values.pop_back();
+				if (inst.OpCode == OpCode::FLea) {
+					values.push_back({ PointerType, false, top.Allocation });
+					values.back().IsFrameAddress = top.IsFrameAddress;
+				} else if (inst.OpCode == OpCode::Count) {
+					values.push_back({ LongType });
+					if (top.Count != 0) {
+						values.back().Range = { top.Count, top.Count };
+					}
+				} else {
+					values.push_back({ NoneType });
+				}
+				break;
+
+			case OpCode::TStore:
+				Escape(top);
+				if (top.IsLocalVariable || second.IsLocalVariable) return Fail(SVM_IEC_STACK_EMPTY);
+				else if (!hasSecond) return true;
+				else if (second.Type != NoneType && !IsPointerType(second.Type)) return Fail(SVM_IEC_POINTER_NOTPOINTER);
+
+				values.erase(values.end() - 2, values.end());
+				if (second.Target != NoLocalVariable) {
+					SetRange(second.Target, top.Range);
+					Forget(second.Target, false);
+				}
+				break;
+
+			case OpCode::APush: {
+				if (top.IsLocalVariable) return Fail(SVM_IEC_STACK_EMPTY);
+				else if (inst.Operand >> 31 == 0) return Fail(SVM_IEC_TYPE_OUTOFRANGE);
+				else if (GetTypeFromTypeCode(m_ByteFile.GetStructures(), static_cast<TypeCode>(inst.Operand & 0x7FFFFFFF)) == NoneType) return Fail(SVM_IEC_TYPE_OUTOFRANGE);
+				else if (!hasTop) return true;
+				else if (top.Type != NoneType && top.Type != IntType && top.Type != LongType) return Fail(SVM_IEC_STACK_DIFFERENTTYPE);
+				else if (top.Type != NoneType && top.Range.Max == 0) return Fail(SVM_IEC_ARRAY_COUNT_CANNOTBEZERO);
+
+				// The array takes the place of its count
+				values.back() = {};
+				if (top.Type != NoneType && top.Range.Min == top.Range.Max) {
+					values.back().Count = top.Range.Min;
+				}
+				break;
+			}
+
+			case OpCode::ALea:
+				Escape(top);
+				if (top.IsLocalVariable) return Fail(SVM_IEC_STACK_EMPTY);
+				else if (!hasTop) return true;
+				else if (top.Type != NoneType && top.Type != IntType && top.Type != LongType) return Fail(SVM_IEC_STACK_DIFFERENTTYPE);
+				else if (!hasSecond) return true;
+				else if (second.IsLocalVariable) return false;	// The interpreter would drop the local variable from the stack
+				else if (second.Type != NoneType && !IsPointerType(second.Type)) return Fail(SVM_IEC_POINTER_NOTPOINTER);
+
+				// Pointers to arrays in local variables are not null, and their counts are known
+				if (top.Type != NoneType && second.Type == PointerType && second.Count != 0 && top.Range.Max < second.Count) {
+					Prove(top.Type);
+				}
+
+				values.erase(values.end() - 2, values.end());
+				values.push_back({ PointerType, false, second.Allocation });
+				values.back().IsFrameAddress = second.IsFrameAddress;
+				break;
+
+			default:
+				// Arrays on the heap are not modelled
+				return false;
+			}
+
+			return Flow(m_Index + 1, std::move(m_State));
+		}
+	};
+}
+
+namespace svm {
+	VerifierResult VerifyInstructions(const ByteFile& byteFile, const Function* function, const std::vector<Type>& argumentTypes) {
+		VerifierResult result;
+		Verifier verifier(byteFile, function, argumentTypes, result);
+		if (!verifier.Verify()) return {};
+
+		result.IsVerified = true;
+		return result;
+	}
+	std::vector<VerifierResult> VerifyByteFile(const ByteFile& byteFile) {
+		const Functions& functions = byteFile.GetFunctions();
+		std::vector<VerifierResult> results(functions.size() + 1);
+
+		// Arguments take the types that every reachable call agrees on, starting from the entry point.
+		// A function is verified again whenever the types of its arguments become less precise.
+		std::vector<std::optional<std::vector<Type>>> argumentTypes(functions.size());
+		std::set<std::size_t> workList{ 0 };
+		while (!workList.empty()) {
+			const std::size_t index = *workList.begin();
+			workList.erase(workList.begin());
+
+			const Function* const function = index ? &functions[index - 1] : nullptr;
+			VerifierResult& result = results[index];
+			result = function ? VerifyInstructions(byteFile, function, *argumentTypes[index - 1]) : VerifyInstructions(byteFile, nullptr);
+
+			const Instructions& instructions = function ? function->GetInstructions() : byteFile.GetEntryPoint();
+			for (std::uint64_t i = 0; i < instructions.GetInstructionCount(); ++i) {
+				const Instruction& inst = instructions.GetInstruction(i);
+				if ((inst.OpCode != OpCode::Call && inst.OpCode != OpCode::TCall) || inst.Operand >= functions.size()) continue;
+
+				const std::uint16_t arity = functions[inst.Operand].GetArity();
+				std::vector<Type> newTypes(arity, NoneType);
+				if (result.IsVerified) {
+					newTypes = result.ArgumentTypes[static_cast<std::size_t>(i)];
+					if (newTypes.size() != arity) continue;
+				}
+
+				std::optional<std::vector<Type>>& types = argumentTypes[inst.Operand];
+				if (!types) {
+					types = std::move(newTypes);
+				} else if (!MergeTypes(*types, newTypes)) continue;
+
+				workList.insert(inst.Operand + 1);
+			}
+		}
+
+		// Functions that are not reachable know nothing about their arguments, and are not verified if they are not loaded
+		for (std::size_t i = 0; i < functions.size(); ++i) {
+			if (!argumentTypes[i] && functions[i].IsLoaded()) {
+				results[i + 1] = VerifyInstructions(byteFile, &functions[i]);
+			}
+		}
+		return results;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include <svm/Writer.hpp>
+
+#include <svm/Type.hpp>
+
+#include <fstream>
+#include <ios>
+#include <stdexcept>
+#include <utility>
+
+namespace svm {
+	Writer::Writer(Writer&& writer) noexcept
+		: m_File(std::move(writer.m_File)) {}
+
+	Writer& Writer::operator=(Writer&& writer) noexcept {
+		m_File = std::move(writer.m_File);
+		return *this;
+	}
+
+	void Writer::Clear() noexcept {
+		m_File.clear();
+	}
+	void Writer::Write(const ByteFile& byteFile) {
+		m_File.clear();
+
+		static constexpr std::uint8_t magic[] = { 0x74, 0x68, 0x74, 0x68 };
+		for (const std::uint8_t byte : magic) {
+			WriteFile(byte);
+		}
+
+		WriteFile(ByteFileVersion::Latest);
+		WriteFile(ByteCodeVersion::Latest);
+
+		WriteConstantPool(byteFile.GetConstantPool());
+		WriteStructures(byteFile.GetStructures());
+		WriteFunctions(byteFile.GetFunctions(), byteFile.GetEntryPoint());
+	}
+	bool Writer::IsWritten() const noexcept {
+		return !m_File.empty();
+	}
+	void Writer::Save(const std::string& path) const {
+		if (!IsWritten()) throw std::runtime_error("Failed to save the file. Incomplete writing.");
+
+		std::ofstream stream(path, std::ofstream::binary);
+		if (!stream) throw std::runtime_error("Failed to open the file.");
+
+		stream.write(reinterpret_cast<const char*>(m_File.data()), static_cast<std::streamsize>(m_File.size()));
+		if (!stream) throw std::runtime_error("Failed to write the file.");
+	}
+
+	const std::vector<std::uint8_t>& Writer::GetResult() const noexcept {
+		return m_File;
+	}
+
+	void Writer::WriteConstantPool(const ConstantPool& constantPool) {
+		WriteConstants(constantPool.GetIntPool());
+		WriteConstants(constantPool.GetLongPool());
+		WriteConstants(constantPool.GetDoublePool());
+	}
+	void Writer::WriteStructures(const Structures& structures) {
+		const std::uint32_t structCount = structures.GetStructureCount();
+		WriteFile(structCount);
+
+		for (std::uint32_t i = 0; i < structCount; ++i) {
+			const std::vector<Field>& fields = structures[i]->Fields;
+			WriteFile(static_cast<std::uint32_t>(fields.size()));
+
+			for (const Field& field : fields) {
+				const auto typeCode = static_cast<std::uint32_t>(field.Type->Code);
+				if (field.IsArray()) {
+					WriteFile(typeCode | 0x80000000);
+					WriteFile(static_cast<std::uint64_t>(field.Count));
+				} else {
+					WriteFile(typeCode);
+				}
+			}
+		}
+	}
+	void Writer::WriteFunctions(const Functions& functions, const Instructions& entryPoint) {
+		WriteFile(static_cast<std::uint32_t>(functions.size()));
+
+		// The table is followed by the instructions of the functions and the entry point, and its offsets are filled later
+		std::vector<std::size_t> offsetPoses;
+		offsetPoses.reserve(functions.size() + 1);
+		for (const Function& function : functions) {
+			WriteFile(function.GetArity());
+			WriteFile(function.HasResult());
+			offsetPoses.push_back(m_File.size());
+			WriteFile(std::uint64_t(0));
+		}
+		offsetPoses.push_back(m_File.size());
+		WriteFile(std::uint64_t(0));
+
+		for (std::size_t i = 0; i < functions.size(); ++i) {
+			WriteFile(offsetPoses[i], static_cast<std::uint64_t>(m_File.size()));
+			WriteInstructions(functions[i].GetInstructions());
+		}
+		WriteFile(offsetPoses.back(), static_cast<std::uint64_t>(m_File.size()));
+		WriteInstructions(entryPoint);
+	}
+	void Writer::WriteInstructions(const Instructions& instructions) {
+		const std::uint32_t labelCount = instructions.GetLabelCount();
+		WriteFile(labelCount);
+		for (std::uint32_t i = 0; i < labelCount; ++i) {
+			WriteFile(instructions.GetLabel(i));
+		}
+
+		const std::uint64_t instCount = instructions.GetInstructionCount();
+		WriteFile(instCount);
+		for (std::uint64_t i = 0; i < instCount; ++i) {
+			const Instruction& inst = instructions.GetInstruction(i);
+			WriteFile(inst.OpCode);
+			if (inst.HasOperand()) {
+				WriteFile(inst.Operand);
+			}
+		}
+	}
+}
\ No newline at end of file
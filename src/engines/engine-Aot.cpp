@@ -0,0 +1,26 @@
+#include <svm/Interpreter.hpp>
+
+#include <svm/detail/InterpreterExceptionCode.hpp>
+
+#include <cstddef>
+
+namespace svm {
+	bool Interpreter::InterpretAot() {
+		// Byte files without a compiled function for each function run in the threaded engine
+		if (m_AotFunctions.size() != m_DecodedFunctions.size() + 1) return InterpretThreaded();
+
+		const Function* const functions = m_ByteFile.GetFunctions().data();
+		while (m_StackFrame.Caller < m_StackFrame.Instructions->GetInstructionCount()) {
+			// Compiled functions return to here whenever the stack frame changes, so deep recursion does not use the native stack
+			const std::size_t index = m_StackFrame.Function ? static_cast<std::size_t>(m_StackFrame.Function - functions) + 1 : 0;
+			if (!(this->*m_AotFunctions[index])()) return false;
+
+			++m_StackFrame.Caller;
+		}
+
+		if (m_Depth != 0) {
+			OccurException(SVM_IEC_FUNCTION_NORETINSTRUCTION);
+			return false;
+		} else return true;
+	}
+}
\ No newline at end of file
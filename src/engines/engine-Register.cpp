@@ -0,0 +1,275 @@
+#include <svm/Interpreter.hpp>
+
+#include <svm/detail/InterpreterExceptionCode.hpp>
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+	template<typename T>
+	std::uint32_t Compare(T lhs, T rhs) noexcept {
+		if (lhs > rhs) return 1;
+		else if (lhs == rhs) return 0;
+		else return static_cast<std::uint32_t>(-1);
+	}
+}
+
+namespace svm {
+	bool Interpreter::InterpretRegister() {
+		while (true) {
+			const std::uint64_t instCount = m_StackFrame.Instructions->GetInstructionCount();
+			if (m_CurrentTier != ExecutionTier::Interpreted && m_StackFrame.Caller < instCount) {
+				const RegisterCode& code = GetRegisterCode();
+				const std::uint32_t entry = code.EntryIndices.empty() ? RegisterCode::NoEntry : code.EntryIndices[static_cast<std::size_t>(m_StackFrame.Caller)];
+				if (entry != RegisterCode::NoEntry && IsRegisterStateMatched(code.Entries[entry].State, code.MaxValueCount) &&
+					InterpretRegisterCode(code, code.Entries[entry].Instruction)) continue;
+			}
+			if (m_StackFrame.Caller >= instCount) break;
+
+			// Instructions that register code exits at are interpreted one by one
+			InterpretInstruction(m_StackFrame.Instructions->GetInstruction(m_StackFrame.Caller));
+			if (m_Exception.has_value()) return false;
+
+			++m_StackFrame.Caller;
+		}
+
+		if (m_Depth != 0) {
+			OccurException(SVM_IEC_FUNCTION_NORETINSTRUCTION);
+			return false;
+		} else return true;
+	}
+
+	const RegisterCode& Interpreter::GetRegisterCode() {
+		FunctionProfile& profile = GetFunctionProfile();
+		std::optional<RegisterCode>& code = profile.Code;
+		if (!code) {
+			// Functions are specialized for the types of arguments they are called with first
+			std::vector<Type> argumentTypes;
+			if (m_StackFrame.Function) {
+				const std::uint16_t arity = m_StackFrame.Function->GetArity();
+				for (std::uint16_t i = 0; i < arity; ++i) {
+					argumentTypes.push_back(*GetLocalVariable(m_StackFrame.VariableBegin + i));
+				}
+			}
+
+			code.emplace(TranslateInstructions(m_ByteFile, *m_StackFrame.Instructions, argumentTypes));
+		}
+		if (profile.Tier == ExecutionTier::Native && !profile.IsCompiled) {
+			// Native code is compiled once for each function, so it is worth optimizing the register code first
+			OptimizeRegisterCode(*code);
+			code->Native = CompileRegisterCode(*code);
+			profile.IsCompiled = true;
+		}
+		return *code;
+	}
+	bool Interpreter::IsRegisterStateMatched(const RegisterState& state, std::size_t maxValueCount) const noexcept {
+		const std::size_t stackBegin = m_StackFrame.StackBegin;
+		if (m_Stack.GetUsedSize() != stackBegin + state.Values.size() * sizeof(IntObject) ||
+			m_Stack.GetFreeSize() < (maxValueCount - state.Values.size()) * sizeof(IntObject) ||
+			m_LocalVariables.size() != m_StackFrame.VariableBegin + state.LocalVariables.size()) return false;
+
+		const auto isMatched = [this](const RegisterValue& value, std::size_t offset) {
+			const Type type = *m_Stack.Get<Type>(offset);
+			return value.Type == NoneType ? type.IsFundamentalType() : type == value.Type;
+		};
+
+		for (std::size_t i = 0; i < state.LocalVariables.size(); ++i) {
+			const std::size_t offset = GetFrameOffset(stackBegin, state.LocalVariables[i].Source);
+			if (m_LocalVariables[m_StackFrame.VariableBegin + i] != offset || !isMatched(state.LocalVariables[i], offset)) return false;
+		}
+		for (std::size_t i = 0; i < state.Values.size(); ++i) {
+			if (!isMatched(state.Values[i], GetFrameOffset(stackBegin, GetValueSlot(i)))) return false;
+		}
+		return true;
+	}
+	void Interpreter::MaterializeRegisterState(const RegisterExit& exit, std::uint8_t* frame) {
+		const RegisterState& state = exit.State;
+		for (std::size_t i = 0; i < state.Values.size(); ++i) {
+			const RegisterValue& value = state.Values[i];
+			const std::int32_t slot = GetValueSlot(i);
+			if (value.Source != slot) {
+				std::memcpy(frame + slot, frame + value.Source, sizeof(std::uint64_t));
+			}
+			if (value.Type != NoneType) {
+				*reinterpret_cast<Type*>(frame + slot - sizeof(Type)) = value.Type;
+			}
+		}
+
+		const std::size_t stackBegin = m_StackFrame.StackBegin;
+		m_Stack.SetUsedSize(stackBegin + state.Values.size() * sizeof(IntObject));
+		m_LocalVariables.resize(m_StackFrame.VariableBegin + state.LocalVariables.size());
+		for (std::size_t i = 0; i < state.LocalVariables.size(); ++i) {
+			m_LocalVariables[m_StackFrame.VariableBegin + i] = GetFrameOffset(stackBegin, state.LocalVariables[i].Source);
+		}
+
+		m_StackFrame.Caller = exit.Instruction;
+	}
+
+	bool Interpreter::InterpretRegisterCode(const RegisterCode& code, std::size_t entry) {
+		std::uint8_t* const frame = m_Stack.Begin() + m_Stack.GetSize() - m_StackFrame.StackBegin;
+		if (!code.Native.IsEmpty()) {
+			MaterializeRegisterState(code.Exits[static_cast<std::size_t>(code.Native.Run(entry, frame))], frame);
+			return false;
+		}
+
+		const RegisterInstruction* const insts = code.Instructions.data();
+		const RegisterInstruction* inst = insts + entry;
+
+		// Loops count their back-edges so that they can move to native code while they are running
+		FunctionProfile& profile = GetFunctionProfile();
+		std::uint64_t backEdgeCount = 0;
+		std::uint64_t backEdgeLimit = 0;
+		if (m_Engine == InterpreterEngine::Jit && profile.Tier != ExecutionTier::Native) {
+			const std::uint64_t hotness = profile.CallCount + profile.BackEdgeCount;
+			backEdgeLimit = hotness < m_NativeThreshold ? m_NativeThreshold - hotness : 1;
+		}
+
+#define SVM_EXIT(exit)																			do {																						profile.BackEdgeCount += backEdgeCount;													MaterializeRegisterState(code.Exits[static_cast<std::size_t>(exit)], frame);				return false;																		} while (false)
+
+#define SVM_BRANCH()																			if (inst->Immediate <= static_cast<std::uint64_t>(inst - insts) && ++backEdgeCount == backEdgeLimit) {				profile.BackEdgeCount += backEdgeCount;													PromoteFunction(profile);																m_CurrentTier = profile.Tier;															MaterializeRegisterState(code.Exits[static_cast<std::size_t>(inst->Right)], frame);				return true;																		}																						inst = insts + inst->Immediate;															continue
+
+#define SVM_VALUE(type, slot) (*reinterpret_cast<type*>(frame + (slot)))
+
+#define SVM_BINARY(name, type, expression)												\
+		case RegisterOpCode::name: {													\
+			const type lhs = SVM_VALUE(type, inst->Left);								\
+			const type rhs = SVM_VALUE(type, inst->Right);								\
+			SVM_VALUE(type, inst->Destination) = expression;							\
+			break;																		\
+		}
+
+#define SVM_DIVISION(name, type, expression)											\
+		case RegisterOpCode::name: {													\
+			const type lhs = SVM_VALUE(type, inst->Left);								\
+			const type rhs = SVM_VALUE(type, inst->Right);								\
+			if (rhs == 0) SVM_EXIT(inst->Immediate);									\
+			SVM_VALUE(type, inst->Destination) = expression;							\
+			break;																		\
+		}
+
+#define SVM_UNARY(name, to, from, expression)											\
+		case RegisterOpCode::name: {													\
+			const from value = SVM_VALUE(from, inst->Left);								\
+			SVM_VALUE(to, inst->Destination) = expression;								\
+			break;																		\
+		}
+
+#define SVM_JUMP(name, type, condition)													\
+		case RegisterOpCode::name:														\
+			if (const type value = SVM_VALUE(type, inst->Left); condition) {			\
+				SVM_BRANCH();															\
+			}																			\
+			break;
+
+		while (true) {
+			switch (inst->OpCode) {
+			case RegisterOpCode::Exit: SVM_EXIT(inst->Immediate);
+
+			case RegisterOpCode::Const: SVM_VALUE(std::uint64_t, inst->Destination) = inst->Immediate; break;
+			case RegisterOpCode::Move: SVM_VALUE(std::uint64_t, inst->Destination) = SVM_VALUE(std::uint64_t, inst->Left); break;
+			case RegisterOpCode::MoveObject:
+				std::memcpy(frame + inst->Destination - sizeof(Type), frame + inst->Left - sizeof(Type), sizeof(IntObject));
+				break;
+
+			SVM_BINARY(AddInt, std::uint32_t, lhs + rhs)
+			SVM_BINARY(AddLong, std::uint64_t, lhs + rhs)
+			SVM_BINARY(AddDouble, double, lhs + rhs)
+			SVM_BINARY(SubInt, std::uint32_t, lhs - rhs)
+			SVM_BINARY(SubLong, std::uint64_t, lhs - rhs)
+			SVM_BINARY(SubDouble, double, lhs - rhs)
+			SVM_BINARY(MulInt, std::uint32_t, lhs * rhs)
+			SVM_BINARY(MulLong, std::uint64_t, lhs * rhs)
+			SVM_BINARY(MulDouble, double, lhs * rhs)
+			SVM_BINARY(IMulInt, std::uint32_t, static_cast<std::int32_t>(lhs) * static_cast<std::int32_t>(rhs))
+			SVM_BINARY(IMulLong, std::uint64_t, static_cast<std::int64_t>(lhs) * static_cast<std::int64_t>(rhs))
+			SVM_DIVISION(DivInt, std::uint32_t, lhs / rhs)
+			SVM_DIVISION(DivLong, std::uint64_t, lhs / rhs)
+			SVM_DIVISION(DivDouble, double, lhs / rhs)
+			SVM_DIVISION(IDivInt, std::uint32_t, static_cast<std::int32_t>(lhs) / static_cast<std::int32_t>(rhs))
+			SVM_DIVISION(IDivLong, std::uint64_t, static_cast<std::int64_t>(lhs) / static_cast<std::int64_t>(rhs))
+			SVM_DIVISION(ModInt, std::uint32_t, lhs % rhs)
+			SVM_DIVISION(ModLong, std::uint64_t, lhs % rhs)
+			SVM_DIVISION(ModDouble, double, std::fmod(lhs, rhs))
+			SVM_DIVISION(IModInt, std::uint32_t, static_cast<std::int32_t>(lhs) % static_cast<std::int32_t>(rhs))
+			SVM_DIVISION(IModLong, std::uint64_t, static_cast<std::int64_t>(lhs) % static_cast<std::int64_t>(rhs))
+			SVM_UNARY(NegInt, std::uint32_t, std::uint32_t, -static_cast<std::int32_t>(value))
+			SVM_UNARY(NegLong, std::uint64_t, std::uint64_t, -static_cast<std::int64_t>(value))
+			SVM_UNARY(NegDouble, double, double, -value)
+			case RegisterOpCode::IncInt: SVM_VALUE(std::uint32_t, inst->Destination) += 1; break;
+			case RegisterOpCode::IncLong: SVM_VALUE(std::uint64_t, inst->Destination) += 1; break;
+			case RegisterOpCode::IncDouble: SVM_VALUE(double, inst->Destination) += 1; break;
+			case RegisterOpCode::DecInt: SVM_VALUE(std::uint32_t, inst->Destination) -= 1; break;
+			case RegisterOpCode::DecLong: SVM_VALUE(std::uint64_t, inst->Destination) -= 1; break;
+			case RegisterOpCode::DecDouble: SVM_VALUE(double, inst->Destination) -= 1; break;
+
+			SVM_BINARY(AndInt, std::uint32_t, lhs & rhs)
+			SVM_BINARY(AndLong, std::uint64_t, lhs & rhs)
+			SVM_BINARY(OrInt, std::uint32_t, lhs | rhs)
+			SVM_BINARY(OrLong, std::uint64_t, lhs | rhs)
+			SVM_BINARY(XorInt, std::uint32_t, lhs ^ rhs)
+			SVM_BINARY(XorLong, std::uint64_t, lhs ^ rhs)
+			SVM_UNARY(NotInt, std::uint32_t, std::uint32_t, ~value)
+			SVM_UNARY(NotLong, std::uint64_t, std::uint64_t, ~value)
+			SVM_BINARY(ShlInt, std::uint32_t, lhs << rhs)
+			SVM_BINARY(ShlLong, std::uint64_t, lhs << rhs)
+			SVM_BINARY(ShrInt, std::uint32_t, lhs >> rhs)
+			SVM_BINARY(ShrLong, std::uint64_t, lhs >> rhs)
+			SVM_BINARY(SarInt, std::uint32_t, static_cast<std::int32_t>(lhs) >> static_cast<std::int32_t>(rhs))
+			SVM_BINARY(SarLong, std::uint64_t, static_cast<std::int64_t>(lhs) >> static_cast<std::int64_t>(rhs))
+
+			case RegisterOpCode::CmpInt:
+				SVM_VALUE(std::uint32_t, inst->Destination) = Compare(SVM_VALUE(std::uint32_t, inst->Left), SVM_VALUE(std::uint32_t, inst->Right));
+				break;
+			case RegisterOpCode::CmpLong:
+				SVM_VALUE(std::uint32_t, inst->Destination) = Compare(SVM_VALUE(std::uint64_t, inst->Left), SVM_VALUE(std::uint64_t, inst->Right));
+				break;
+			case RegisterOpCode::CmpDouble:
+				SVM_VALUE(std::uint32_t, inst->Destination) = Compare(SVM_VALUE(double, inst->Left), SVM_VALUE(double, inst->Right));
+				break;
+			case RegisterOpCode::ICmpInt:
+				SVM_VALUE(std::uint32_t, inst->Destination) = Compare(SVM_VALUE(std::int32_t, inst->Left), SVM_VALUE(std::int32_t, inst->Right));
+				break;
+			case RegisterOpCode::ICmpLong:
+				SVM_VALUE(std::uint32_t, inst->Destination) = Compare(SVM_VALUE(std::int64_t, inst->Left), SVM_VALUE(std::int64_t, inst->Right));
+				break;
+
+			SVM_UNARY(IntToLong, std::uint64_t, std::uint32_t, value)
+			SVM_UNARY(IntToDouble, double, std::uint32_t, static_cast<double>(value))
+			SVM_UNARY(LongToInt, std::uint32_t, std::uint64_t, static_cast<std::uint32_t>(value))
+			SVM_UNARY(LongToDouble, double, std::uint64_t, static_cast<double>(value))
+			SVM_UNARY(DoubleToInt, std::uint32_t, double, static_cast<std::uint32_t>(value))
+			SVM_UNARY(DoubleToLong, std::uint64_t, double, static_cast<std::uint64_t>(value))
+
+			case RegisterOpCode::Jmp: SVM_BRANCH();
+			SVM_JUMP(JeInt, std::uint32_t, value == 0)
+			SVM_JUMP(JeLong, std::uint64_t, value == 0)
+			SVM_JUMP(JeDouble, double, value == 0)
+			SVM_JUMP(JneInt, std::uint32_t, value != 0)
+			SVM_JUMP(JneLong, std::uint64_t, value != 0)
+			SVM_JUMP(JneDouble, double, value != 0)
+			SVM_JUMP(JaInt, std::uint32_t, value == 1)
+			SVM_JUMP(JaLong, std::uint64_t, value == 1)
+			SVM_JUMP(JaDouble, double, value == 1)
+			SVM_JUMP(JaeInt, std::uint32_t, value != static_cast<std::uint32_t>(-1))
+			SVM_JUMP(JaeLong, std::uint64_t, value != static_cast<std::uint64_t>(-1))
+			SVM_JUMP(JaeDouble, double, value != -1)
+			SVM_JUMP(JbInt, std::uint32_t, value == static_cast<std::uint32_t>(-1))
+			SVM_JUMP(JbLong, std::uint64_t, value == static_cast<std::uint64_t>(-1))
+			SVM_JUMP(JbDouble, double, value == -1)
+			SVM_JUMP(JbeInt, std::uint32_t, value != 1)
+			SVM_JUMP(JbeLong, std::uint64_t, value != 1)
+			SVM_JUMP(JbeDouble, double, value != 1)
+			}
+
+			++inst;
+		}
+
+#undef SVM_EXIT
+#undef SVM_BRANCH
+#undef SVM_VALUE
+#undef SVM_BINARY
+#undef SVM_DIVISION
+#undef SVM_UNARY
+#undef SVM_JUMP
+	}
+}
\ No newline at end of file
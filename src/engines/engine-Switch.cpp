@@ -0,0 +1,97 @@
+#include <svm/Interpreter.hpp>
+
+#include <svm/Macro.hpp>
+#include <svm/detail/InterpreterExceptionCode.hpp>
+
+namespace svm {
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretInstruction(const Instruction& inst) {
+		switch (inst.OpCode) {
+		case OpCode::Push: InterpretPush(inst.Operand); break;
+		case OpCode::Pop: InterpretPop(); break;
+		case OpCode::Load: InterpretLoad(inst.Operand); break;
+		case OpCode::Store: InterpretStore(inst.Operand); break;
+		case OpCode::Lea: InterpretLea(inst.Operand); break;
+		case OpCode::FLea: InterpretFLea(inst.Operand); break;
+		case OpCode::TLoad: InterpretTLoad(); break;
+		case OpCode::TStore: InterpretTStore(); break;
+		case OpCode::Copy: InterpretCopy(); break;
+		case OpCode::Swap: InterpretSwap(); break;
+
+		case OpCode::Add: InterpretAdd(); break;
+		case OpCode::Sub: InterpretSub(); break;
+		case OpCode::Mul: InterpretMul(); break;
+		case OpCode::IMul: InterpretIMul(); break;
+		case OpCode::Div: InterpretDiv(); break;
+		case OpCode::IDiv: InterpretIDiv(); break;
+		case OpCode::Mod: InterpretMod(); break;
+		case OpCode::IMod: InterpretIMod(); break;
+		case OpCode::Neg: InterpretNeg(); break;
+		case OpCode::Inc: InterpretIncDec(1); break;
+		case OpCode::Dec: InterpretIncDec(-1); break;
+
+		case OpCode::And: InterpretAnd(); break;
+		case OpCode::Or: InterpretOr(); break;
+		case OpCode::Xor: InterpretXor(); break;
+		case OpCode::Not: InterpretNot(); break;
+		case OpCode::Shl: InterpretShl(); break;
+		case OpCode::Sal: InterpretSal(); break;
+		case OpCode::Shr: InterpretShr(); break;
+		case OpCode::Sar: InterpretSar(); break;
+
+		case OpCode::Cmp: InterpretCmp(); break;
+		case OpCode::ICmp: InterpretICmp(); break;
+		case OpCode::Jmp: InterpretJmp(inst.Operand); break;
+		case OpCode::Je: InterpretJe(inst.Operand); break;
+		case OpCode::Jne: InterpretJne(inst.Operand); break;
+		case OpCode::Ja: InterpretJa(inst.Operand); break;
+		case OpCode::Jae: InterpretJae(inst.Operand); break;
+		case OpCode::Jb: InterpretJb(inst.Operand); break;
+		case OpCode::Jbe: InterpretJbe(inst.Operand); break;
+		case OpCode::Call: InterpretCall(inst.Operand); break;
+		case OpCode::Ret: InterpretRet(); break;
+
+		case OpCode::ToI: InterpretToI(); break;
+		case OpCode::ToL: InterpretToL(); break;
+		case OpCode::ToD: InterpretToD(); break;
+		case OpCode::ToP: InterpretToP(); break;
+
+		case OpCode::Null: InterpretNull(); break;
+		case OpCode::New: InterpretNew(inst.Operand); break;
+		case OpCode::Delete: InterpretDelete(); break;
+		case OpCode::GCNull: InterpretGCNull(); break;
+		case OpCode::GCNew: InterpretGCNew(inst.Operand); break;
+
+		case OpCode::APush: InterpretAPush(inst.Operand); break;
+		case OpCode::ANew: InterpretANew(inst.Operand); break;
+		case OpCode::AGCNew: InterpretAGCNew(inst.Operand); break;
+		case OpCode::ALea: InterpretALea(); break;
+		case OpCode::Count: InterpretCount(); break;
+		case OpCode::TCall: InterpretTCall(inst.Operand); break;
+
+		// Internal opcodes are made only by the decoder, so they never reach the switch engine
+		default: break;
+		}
+	}
+
+	bool Interpreter::InterpretSwitch() {
+		if (m_Profiler) return InterpretSwitch<true>();
+		else return InterpretSwitch<false>();
+	}
+	template<bool IsProfiling>
+	bool Interpreter::InterpretSwitch() {
+		for (; m_StackFrame.Caller < m_StackFrame.Instructions->GetInstructionCount(); ++m_StackFrame.Caller) {
+			const Instruction& inst = m_StackFrame.Instructions->GetInstruction(m_StackFrame.Caller);
+			if constexpr (IsProfiling) {
+				m_Profiler->Record(inst);
+			}
+
+			InterpretInstruction(inst);
+			if (m_Exception.has_value()) return false;
+		}
+
+		if (m_Depth != 0) {
+			OccurException(SVM_IEC_FUNCTION_NORETINSTRUCTION);
+			return false;
+		} else return true;
+	}
+}
\ No newline at end of file
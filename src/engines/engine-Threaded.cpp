@@ -0,0 +1,362 @@
+#include <svm/Interpreter.hpp>
+
+#include <svm/Macro.hpp>
+#include <svm/detail/InterpreterExceptionCode.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+namespace {
+	template<typename T>
+	T FromCache(std::uint64_t cache) noexcept {
+		T value;
+		std::memcpy(&value, &cache, sizeof(value));
+		return value;
+	}
+	template<typename T>
+	std::uint64_t ToCache(T value) noexcept {
+		std::uint64_t cache = 0;
+		std::memcpy(&cache, &value, sizeof(value));
+		return cache;
+	}
+	template<typename T>
+	std::uint32_t Compare(T lhs, T rhs) noexcept {
+		if (lhs > rhs) return 1;
+		else if (lhs == rhs) return 0;
+		else return static_cast<std::uint32_t>(-1);
+	}
+}
+
+namespace svm {
+	bool Interpreter::InterpretThreaded() {
+#ifdef SVM_COMPUTED_GOTO
+		static const void* const handlers[] = {
+			&&Nop,
+			&&Push, &&Pop, &&Load, &&Store, &&Lea, &&FLea, &&TLoad, &&TStore, &&Copy, &&Swap,
+			&&Add, &&Sub, &&Mul, &&IMul, &&Div, &&IDiv, &&Mod, &&IMod, &&Neg, &&Inc, &&Dec,
+			&&And, &&Or, &&Xor, &&Not, &&Shl, &&Sal, &&Shr, &&Sar,
+			&&Cmp, &&ICmp, &&Jmp, &&Je, &&Jne, &&Ja, &&Jae, &&Jb, &&Jbe, &&Call, &&Ret,
+			&&Nop/*tob*/, &&Nop/*tos*/, &&ToI, &&ToL, &&Nop/*tof*/, &&ToD, &&ToP,
+			&&Null, &&New, &&Delete, &&GCNull, &&GCNew,
+			&&APush, &&ANew, &&AGCNew, &&ALea, &&Count, &&TCall,
+
+			&&JmpDirect, &&JeDirect, &&JneDirect, &&JaDirect, &&JaeDirect, &&JbDirect, &&JbeDirect, &&CallDirect, &&TCallDirect,
+			&&PushInt, &&PushLong, &&PushDouble,
+			&&AddInt, &&AddLong, &&AddDouble, &&SubInt, &&SubLong, &&SubDouble, &&MulInt, &&MulLong, &&MulDouble, &&DivInt, &&DivLong, &&DivDouble,
+			&&CmpInt, &&CmpLong, &&CmpDouble, &&ICmpInt, &&ICmpLong,
+			&&LoadLoadAddStore, &&LoadLoadSubStore, &&CmpJe, &&CmpJne, &&CmpJa, &&CmpJae, &&CmpJb, &&CmpJbe, &&LeaInc, &&LeaDec,
+			&&VerifiedLoadInt, &&VerifiedLoadLong, &&VerifiedLoadDouble, &&VerifiedStoreInt, &&VerifiedStoreLong, &&VerifiedStoreDouble, &&VerifiedLea,
+			&&VerifiedAddInt, &&VerifiedAddLong, &&VerifiedAddDouble, &&VerifiedSubInt, &&VerifiedSubLong, &&VerifiedSubDouble, &&VerifiedMulInt, &&VerifiedMulLong, &&VerifiedMulDouble,
+			&&VerifiedCmpInt, &&VerifiedCmpLong, &&VerifiedCmpDouble, &&VerifiedICmpInt, &&VerifiedICmpLong,
+			&&VerifiedJeInt, &&VerifiedJneInt, &&VerifiedJaInt, &&VerifiedJaeInt, &&VerifiedJbInt, &&VerifiedJbeInt, &&VerifiedCall,
+			&&VerifiedALeaInt, &&VerifiedALeaLong,
+		};
+		static_assert(std::size(handlers) == std::size(Mnemonics));
+
+		if (!m_DecodedEntryPoint.front().Handler) {
+			// Addresses of labels cannot leave this function, so the handlers are bound here.
+			for (std::size_t i = 0; i <= m_DecodedFunctions.size(); ++i) {
+				DecodedInstructions& decoded = i == 0 ? m_DecodedEntryPoint : m_DecodedFunctions[i - 1];
+
+				decoded.front().Handler = &&Trap;
+				for (std::size_t j = 1; j < decoded.size() - 1; ++j) {
+					decoded[j].Handler = handlers[static_cast<std::size_t>(decoded[j].OpCode)];
+				}
+				decoded.back().Handler = &&End;
+			}
+		}
+
+		DecodedInstruction* code = GetDecodedCode();
+		DecodedInstruction* inst = code + static_cast<std::ptrdiff_t>(m_StackFrame.Caller);
+
+		// The value of the top is kept in a register after pushes of constants and verified instructions.
+		// Its slot and type are on the stack already, so only the value is written before other handlers run.
+		bool isCached = false;
+		std::uint64_t cache = 0;
+		goto *inst->Handler;
+
+#define SVM_DISPATCH()																	\
+		inst = code + static_cast<std::ptrdiff_t>(++m_StackFrame.Caller);				\
+		goto *inst->Handler
+
+#define SVM_SPILL()																		\
+		if (isCached) {																	\
+			m_Stack.GetTop<LongObject>()->Value = cache;								\
+			isCached = false;															\
+		}
+
+#define SVM_TOP(t) (isCached ? FromCache<decltype(t::Value)>(cache) : m_Stack.GetTop<t>()->Value)
+
+#define SVM_CACHED_PUSH(t, type, value)													\
+		SVM_SPILL();																	\
+		if (m_Stack.Expand(sizeof(t))) {												\
+			*m_Stack.GetTopType() = type;												\
+			cache = ToCache(value);														\
+			isCached = true;															\
+		} else {																		\
+			OccurException(SVM_IEC_STACK_OVERFLOW);										\
+		}																				\
+		SVM_DISPATCH()
+
+#define SVM_LOCAL_VARIABLE(t) m_Stack.Get<t>(m_StackFrame.StackBegin + inst->Offset)
+
+#define SVM_VERIFIED_LOAD(t, type)														\
+		SVM_CACHED_PUSH(t, type, SVM_LOCAL_VARIABLE(t)->Value)
+
+#define SVM_VERIFIED_STORE(t)															\
+		SVM_LOCAL_VARIABLE(t)->Value = SVM_TOP(t);										\
+		m_Stack.Reduce(sizeof(t));														\
+		isCached = false;																\
+		SVM_DISPATCH()
+
+#define SVM_VERIFIED_OPERATION(t, o)													\
+		{																				\
+			const auto rhs = SVM_TOP(t);												\
+			m_Stack.Reduce(sizeof(t));													\
+			cache = ToCache(static_cast<decltype(t::Value)>(m_Stack.GetTop<t>()->Value o rhs));	\
+			isCached = true;															\
+		}																				\
+		SVM_DISPATCH()
+
+#define SVM_VERIFIED_COMPARE(t, v)														\
+		{																				\
+			const v rhs = static_cast<v>(SVM_TOP(t));									\
+			m_Stack.Reduce(sizeof(t));													\
+			const v lhs = static_cast<v>(m_Stack.GetTop<t>()->Value);					\
+			*m_Stack.GetTopType() = IntType;											\
+			cache = ToCache(Compare(lhs, rhs));											\
+			isCached = true;															\
+		}																				\
+		SVM_DISPATCH()
+
+#define SVM_VERIFIED_JUMP(o, v)															\
+		if (SVM_TOP(IntObject) o static_cast<std::uint32_t>(v)) {						\
+			RecordBackEdge(inst->Operand.Target);										\
+			m_Stack.Reduce(sizeof(IntObject));											\
+			isCached = false;															\
+			m_StackFrame.Caller = inst->Operand.Target;									\
+			inst = code + static_cast<std::ptrdiff_t>(m_StackFrame.Caller);				\
+			goto *inst->Handler;														\
+		}																				\
+		SVM_DISPATCH()
+
+#define SVM_VERIFIED_ALEA(t)															\
+		{																				\
+			const std::uint64_t index = SVM_TOP(t);										\
+			m_Stack.Reduce(sizeof(t));													\
+			ArrayObject* const array = static_cast<ArrayObject*>(m_Stack.GetTop<PointerObject>()->Value);	\
+			Type* const elementType = reinterpret_cast<Type*>(array + 1);				\
+			cache = ToCache(static_cast<void*>(reinterpret_cast<std::uint8_t*>(elementType) + index * elementType->GetReference().Size));	\
+			isCached = true;															\
+		}																				\
+		SVM_DISPATCH()
+
+#define SVM_QUICKEN()																	\
+		if (const OpCode quickened = Quicken(inst->OpCode); quickened != inst->OpCode) {	\
+			inst->OpCode = quickened;													\
+			inst->Handler = handlers[static_cast<std::size_t>(quickened)];				\
+			goto *inst->Handler;														\
+		}
+
+	Nop: SVM_DISPATCH();
+
+	Push: SVM_SPILL(); InterpretPush(inst->Operand.Operand); SVM_DISPATCH();
+	Pop: isCached = false; InterpretPop(); SVM_DISPATCH();
+	Load: SVM_SPILL(); InterpretLoad(inst->Operand.Operand); SVM_DISPATCH();
+	Store: SVM_SPILL(); InterpretStore(inst->Operand.Operand); SVM_DISPATCH();
+	Lea: SVM_SPILL(); InterpretLea(inst->Operand.Operand); SVM_DISPATCH();
+	FLea: SVM_SPILL(); InterpretFLea(inst->Operand.Operand); SVM_DISPATCH();
+	TLoad: SVM_SPILL(); InterpretTLoad(); SVM_DISPATCH();
+	TStore: SVM_SPILL(); InterpretTStore(); SVM_DISPATCH();
+	Copy: SVM_SPILL(); InterpretCopy(); SVM_DISPATCH();
+	Swap: SVM_SPILL(); InterpretSwap(); SVM_DISPATCH();
+
+	Add: SVM_SPILL(); SVM_QUICKEN(); InterpretAdd(); SVM_DISPATCH();
+	Sub: SVM_SPILL(); SVM_QUICKEN(); InterpretSub(); SVM_DISPATCH();
+	Mul: SVM_SPILL(); SVM_QUICKEN(); InterpretMul(); SVM_DISPATCH();
+	IMul: SVM_SPILL(); InterpretIMul(); SVM_DISPATCH();
+	Div: SVM_SPILL(); SVM_QUICKEN(); InterpretDiv(); SVM_DISPATCH();
+	IDiv: SVM_SPILL(); InterpretIDiv(); SVM_DISPATCH();
+	Mod: SVM_SPILL(); InterpretMod(); SVM_DISPATCH();
+	IMod: SVM_SPILL(); InterpretIMod(); SVM_DISPATCH();
+	Neg: SVM_SPILL(); InterpretNeg(); SVM_DISPATCH();
+	Inc: SVM_SPILL(); InterpretIncDec(1); SVM_DISPATCH();
+	Dec: SVM_SPILL(); InterpretIncDec(-1); SVM_DISPATCH();
+
+	And: SVM_SPILL(); InterpretAnd(); SVM_DISPATCH();
+	Or: SVM_SPILL(); InterpretOr(); SVM_DISPATCH();
+	Xor: SVM_SPILL(); InterpretXor(); SVM_DISPATCH();
+	Not: SVM_SPILL(); InterpretNot(); SVM_DISPATCH();
+	Shl: SVM_SPILL(); InterpretShl(); SVM_DISPATCH();
+	Sal: SVM_SPILL(); InterpretSal(); SVM_DISPATCH();
+	Shr: SVM_SPILL(); InterpretShr(); SVM_DISPATCH();
+	Sar: SVM_SPILL(); InterpretSar(); SVM_DISPATCH();
+
+	Cmp: SVM_SPILL(); SVM_QUICKEN(); InterpretCmp(); SVM_DISPATCH();
+	ICmp: SVM_SPILL(); SVM_QUICKEN(); InterpretICmp(); SVM_DISPATCH();
+	Jmp: SVM_SPILL(); InterpretJmp(inst->Operand.Operand); goto CheckedDispatch;
+	Je: SVM_SPILL(); InterpretJe(inst->Operand.Operand); goto CheckedDispatch;
+	Jne: SVM_SPILL(); InterpretJne(inst->Operand.Operand); goto CheckedDispatch;
+	Ja: SVM_SPILL(); InterpretJa(inst->Operand.Operand); goto CheckedDispatch;
+	Jae: SVM_SPILL(); InterpretJae(inst->Operand.Operand); goto CheckedDispatch;
+	Jb: SVM_SPILL(); InterpretJb(inst->Operand.Operand); goto CheckedDispatch;
+	Jbe: SVM_SPILL(); InterpretJbe(inst->Operand.Operand); goto CheckedDispatch;
+	Call: SVM_SPILL(); InterpretCall(inst->Operand.Operand); code = GetDecodedCode(); SVM_DISPATCH();
+	Ret: SVM_SPILL(); InterpretRet(); code = GetDecodedCode(); SVM_DISPATCH();
+
+	ToI: SVM_SPILL(); InterpretToI(); SVM_DISPATCH();
+	ToL: SVM_SPILL(); InterpretToL(); SVM_DISPATCH();
+	ToD: SVM_SPILL(); InterpretToD(); SVM_DISPATCH();
+	ToP: SVM_SPILL(); InterpretToP(); SVM_DISPATCH();
+
+	Null: SVM_SPILL(); InterpretNull(); SVM_DISPATCH();
+	New: SVM_SPILL(); InterpretNew(inst->Operand.Operand); SVM_DISPATCH();
+	Delete: SVM_SPILL(); InterpretDelete(); SVM_DISPATCH();
+	GCNull: SVM_SPILL(); InterpretGCNull(); SVM_DISPATCH();
+	GCNew: SVM_SPILL(); InterpretGCNew(inst->Operand.Operand); SVM_DISPATCH();
+
+	APush: SVM_SPILL(); InterpretAPush(inst->Operand.Operand); SVM_DISPATCH();
+	ANew: SVM_SPILL(); InterpretANew(inst->Operand.Operand); SVM_DISPATCH();
+	AGCNew: SVM_SPILL(); InterpretAGCNew(inst->Operand.Operand); SVM_DISPATCH();
+	ALea: SVM_SPILL(); InterpretALea(); SVM_DISPATCH();
+	Count: SVM_SPILL(); InterpretCount(); SVM_DISPATCH();
+	TCall: SVM_SPILL(); InterpretTCall(inst->Operand.Operand); code = GetDecodedCode(); SVM_DISPATCH();
+
+	JmpDirect:
+		m_StackFrame.Caller = inst->Operand.Target;
+		inst = code + static_cast<std::ptrdiff_t>(m_StackFrame.Caller);
+		goto *inst->Handler;
+	JeDirect: SVM_SPILL(); InterpretJeDirect(inst->Operand.Target); SVM_DISPATCH();
+	JneDirect: SVM_SPILL(); InterpretJneDirect(inst->Operand.Target); SVM_DISPATCH();
+	JaDirect: SVM_SPILL(); InterpretJaDirect(inst->Operand.Target); SVM_DISPATCH();
+	JaeDirect: SVM_SPILL(); InterpretJaeDirect(inst->Operand.Target); SVM_DISPATCH();
+	JbDirect: SVM_SPILL(); InterpretJbDirect(inst->Operand.Target); SVM_DISPATCH();
+	JbeDirect: SVM_SPILL(); InterpretJbeDirect(inst->Operand.Target); SVM_DISPATCH();
+	CallDirect: SVM_SPILL(); InterpretCallDirect(inst->Operand.Function); code = GetDecodedCode(); SVM_DISPATCH();
+	TCallDirect: SVM_SPILL(); InterpretTCallDirect(inst->Operand.Function); code = GetDecodedCode(); SVM_DISPATCH();
+	PushInt: SVM_CACHED_PUSH(IntObject, IntType, inst->Operand.Int->Value);
+	PushLong: SVM_CACHED_PUSH(LongObject, LongType, inst->Operand.Long->Value);
+	PushDouble: SVM_CACHED_PUSH(DoubleObject, DoubleType, inst->Operand.Double->Value);
+
+	AddInt: SVM_SPILL(); InterpretAddInt(); SVM_DISPATCH();
+	AddLong: SVM_SPILL(); InterpretAddLong(); SVM_DISPATCH();
+	AddDouble: SVM_SPILL(); InterpretAddDouble(); SVM_DISPATCH();
+	SubInt: SVM_SPILL(); InterpretSubInt(); SVM_DISPATCH();
+	SubLong: SVM_SPILL(); InterpretSubLong(); SVM_DISPATCH();
+	SubDouble: SVM_SPILL(); InterpretSubDouble(); SVM_DISPATCH();
+	MulInt: SVM_SPILL(); InterpretMulInt(); SVM_DISPATCH();
+	MulLong: SVM_SPILL(); InterpretMulLong(); SVM_DISPATCH();
+	MulDouble: SVM_SPILL(); InterpretMulDouble(); SVM_DISPATCH();
+	DivInt: SVM_SPILL(); InterpretDivInt(); SVM_DISPATCH();
+	DivLong: SVM_SPILL(); InterpretDivLong(); SVM_DISPATCH();
+	DivDouble: SVM_SPILL(); InterpretDivDouble(); SVM_DISPATCH();
+	CmpInt: SVM_SPILL(); InterpretCmpInt(); SVM_DISPATCH();
+	CmpLong: SVM_SPILL(); InterpretCmpLong(); SVM_DISPATCH();
+	CmpDouble: SVM_SPILL(); InterpretCmpDouble(); SVM_DISPATCH();
+	ICmpInt: SVM_SPILL(); InterpretICmpInt(); SVM_DISPATCH();
+	ICmpLong: SVM_SPILL(); InterpretICmpLong(); SVM_DISPATCH();
+
+	// Superinstructions run only the first instruction of the group when they fall back
+	LoadLoadAddStore: SVM_SPILL(); if (!InterpretLoadLoadAddStore(inst)) InterpretLoad(inst->Operand.Operand); SVM_DISPATCH();
+	LoadLoadSubStore: SVM_SPILL(); if (!InterpretLoadLoadSubStore(inst)) InterpretLoad(inst->Operand.Operand); SVM_DISPATCH();
+	CmpJe: SVM_SPILL(); if (!InterpretCmpJe(inst[1].Operand.Target)) InterpretCmp(); SVM_DISPATCH();
+	CmpJne: SVM_SPILL(); if (!InterpretCmpJne(inst[1].Operand.Target)) InterpretCmp(); SVM_DISPATCH();
+	CmpJa: SVM_SPILL(); if (!InterpretCmpJa(inst[1].Operand.Target)) InterpretCmp(); SVM_DISPATCH();
+	CmpJae: SVM_SPILL(); if (!InterpretCmpJae(inst[1].Operand.Target)) InterpretCmp(); SVM_DISPATCH();
+	CmpJb: SVM_SPILL(); if (!InterpretCmpJb(inst[1].Operand.Target)) InterpretCmp(); SVM_DISPATCH();
+	CmpJbe: SVM_SPILL(); if (!InterpretCmpJbe(inst[1].Operand.Target)) InterpretCmp(); SVM_DISPATCH();
+	LeaInc: SVM_SPILL(); if (!InterpretLeaIncDec(inst->Operand.Operand, 1)) InterpretLea(inst->Operand.Operand); SVM_DISPATCH();
+	LeaDec: SVM_SPILL(); if (!InterpretLeaIncDec(inst->Operand.Operand, -1)) InterpretLea(inst->Operand.Operand); SVM_DISPATCH();
+
+	// Verified instructions read and write the cached value instead of the stack.
+	// Their local variables are found at fixed offsets from the stack frame without looking up m_LocalVariables.
+	VerifiedLoadInt: SVM_VERIFIED_LOAD(IntObject, IntType);
+	VerifiedLoadLong: SVM_VERIFIED_LOAD(LongObject, LongType);
+	VerifiedLoadDouble: SVM_VERIFIED_LOAD(DoubleObject, DoubleType);
+	VerifiedStoreInt: SVM_VERIFIED_STORE(IntObject);
+	VerifiedStoreLong: SVM_VERIFIED_STORE(LongObject);
+	VerifiedStoreDouble: SVM_VERIFIED_STORE(DoubleObject);
+	VerifiedLea: SVM_CACHED_PUSH(PointerObject, PointerType, static_cast<void*>(SVM_LOCAL_VARIABLE(Type)));
+	VerifiedAddInt: SVM_VERIFIED_OPERATION(IntObject, +);
+	VerifiedAddLong: SVM_VERIFIED_OPERATION(LongObject, +);
+	VerifiedAddDouble: SVM_VERIFIED_OPERATION(DoubleObject, +);
+	VerifiedSubInt: SVM_VERIFIED_OPERATION(IntObject, -);
+	VerifiedSubLong: SVM_VERIFIED_OPERATION(LongObject, -);
+	VerifiedSubDouble: SVM_VERIFIED_OPERATION(DoubleObject, -);
+	VerifiedMulInt: SVM_VERIFIED_OPERATION(IntObject, *);
+	VerifiedMulLong: SVM_VERIFIED_OPERATION(LongObject, *);
+	VerifiedMulDouble: SVM_VERIFIED_OPERATION(DoubleObject, *);
+	VerifiedCmpInt: SVM_VERIFIED_COMPARE(IntObject, std::uint32_t);
+	VerifiedCmpLong: SVM_VERIFIED_COMPARE(LongObject, std::uint64_t);
+	VerifiedCmpDouble: SVM_VERIFIED_COMPARE(DoubleObject, double);
+	VerifiedICmpInt: SVM_VERIFIED_COMPARE(IntObject, std::int32_t);
+	VerifiedICmpLong: SVM_VERIFIED_COMPARE(LongObject, std::int64_t);
+	VerifiedJeInt: SVM_VERIFIED_JUMP(==, 0);
+	VerifiedJneInt: SVM_VERIFIED_JUMP(!=, 0);
+	VerifiedJaInt: SVM_VERIFIED_JUMP(==, 1);
+	VerifiedJaeInt: SVM_VERIFIED_JUMP(!=, -1);
+	VerifiedJbInt: SVM_VERIFIED_JUMP(==, -1);
+	VerifiedJbeInt: SVM_VERIFIED_JUMP(!=, 1);
+	VerifiedCall: SVM_SPILL(); InterpretVerifiedCall(inst->Operand.Function, inst->Offset); code = GetDecodedCode(); SVM_DISPATCH();
+	VerifiedALeaInt: SVM_VERIFIED_ALEA(IntObject);
+	VerifiedALeaLong: SVM_VERIFIED_ALEA(LongObject);
+
+	CheckedDispatch:
+		// Jumps that could not be decoded may target a label past the end
+		if (m_Exception.has_value()) return false;
+		else if (++m_StackFrame.Caller >= m_StackFrame.Instructions->GetInstructionCount()) goto End;
+
+		inst = code + static_cast<std::ptrdiff_t>(m_StackFrame.Caller);
+		goto *inst->Handler;
+
+#undef SVM_QUICKEN
+#undef SVM_VERIFIED_JUMP
+#undef SVM_VERIFIED_COMPARE
+#undef SVM_VERIFIED_OPERATION
+#undef SVM_VERIFIED_STORE
+#undef SVM_VERIFIED_LOAD
+#undef SVM_LOCAL_VARIABLE
+#undef SVM_CACHED_PUSH
+#undef SVM_TOP
+#undef SVM_DISPATCH
+
+	Trap:
+		return false;
+
+	End:
+		SVM_SPILL();
+		if (m_Depth != 0) {
+			OccurException(SVM_IEC_FUNCTION_NORETINSTRUCTION);
+			return false;
+		} else return true;
+#else
+		return InterpretSwitch();
+#endif
+	}
+	OpCode Interpreter::Quicken(OpCode opCode) const noexcept {
+		const Type* const typePtr = m_Stack.GetTopType();
+		if (!typePtr) return opCode;
+
+		// Variants of the same operation are laid out in the order of int, long and double
+		std::uint8_t offset = 0;
+		if (*typePtr == IntType) {
+			offset = 0;
+		} else if (*typePtr == LongType) {
+			offset = 1;
+		} else if (*typePtr == DoubleType) {
+			offset = 2;
+		} else return opCode;
+
+		switch (opCode) {
+		case OpCode::Add: return static_cast<OpCode>(static_cast<std::uint8_t>(OpCode::AddInt) + offset);
+		case OpCode::Sub: return static_cast<OpCode>(static_cast<std::uint8_t>(OpCode::SubInt) + offset);
+		case OpCode::Mul: return static_cast<OpCode>(static_cast<std::uint8_t>(OpCode::MulInt) + offset);
+		case OpCode::Div: return static_cast<OpCode>(static_cast<std::uint8_t>(OpCode::DivInt) + offset);
+		case OpCode::Cmp: return static_cast<OpCode>(static_cast<std::uint8_t>(OpCode::CmpInt) + offset);
+		case OpCode::ICmp: return offset == 2 ? OpCode::CmpDouble : static_cast<OpCode>(static_cast<std::uint8_t>(OpCode::ICmpInt) + offset);
+		default: return opCode;
+		}
+	}
+}
\ No newline at end of file
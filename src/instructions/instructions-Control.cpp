@@ -16,6 +16,19 @@ namespace svm {
 			return;
 		}
 
+		JumpIf<T>(m_StackFrame.Instructions->GetLabel(operand));
+	}
+	template<typename T>
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::JumpConditionDirect(std::uint64_t target) noexcept {
+		if (IsLocalVariable()) {
+			OccurException(SVM_IEC_STACK_EMPTY);
+			return;
+		}
+
+		JumpIf<T>(target);
+	}
+	template<typename T>
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::JumpIf(std::uint64_t target) noexcept {
 		const Type* const typePtr = m_Stack.GetTopType();
 		if (!typePtr) {
 			OccurException(SVM_IEC_STACK_EMPTY);
@@ -23,42 +36,61 @@ namespace svm {
 		}
 
 		const Type type = *typePtr;
-		if (type == IntType) {
+		switch (type.GetTag()) {
+		case TypeTag::Int: {
 			const IntObject* value = reinterpret_cast<const IntObject*>(typePtr);
 			if (T::Compare(value->Value)) {
-				m_StackFrame.Caller = m_StackFrame.Instructions->GetLabel(operand) - 1;
+				RecordBackEdge(target);
+				m_StackFrame.Caller = target - 1;
 				m_Stack.Reduce(sizeof(IntObject));
 			}
-		} else if (type == LongType) {
+			break;
+		}
+		case TypeTag::Long: {
 			const LongObject* value = reinterpret_cast<const LongObject*>(typePtr);
 			if (T::Compare(value->Value)) {
-				m_StackFrame.Caller = m_StackFrame.Instructions->GetLabel(operand) - 1;
+				RecordBackEdge(target);
+				m_StackFrame.Caller = target - 1;
 				m_Stack.Reduce(sizeof(LongObject));
 			}
-		} else if (type == DoubleType) {
+			break;
+		}
+		case TypeTag::Double: {
 			const DoubleObject* value = reinterpret_cast<const DoubleObject*>(typePtr);
 			if (T::Compare(value->Value)) {
-				m_StackFrame.Caller = m_StackFrame.Instructions->GetLabel(operand) - 1;
+				RecordBackEdge(target);
+				m_StackFrame.Caller = target - 1;
 				m_Stack.Reduce(sizeof(DoubleObject));
 			}
-		} else if (type == PointerType) {
+			break;
+		}
+		case TypeTag::Pointer: {
 			const PointerObject* value = reinterpret_cast<const PointerObject*>(typePtr);
 			if (T::Compare(value->Value)) {
-				m_StackFrame.Caller = m_StackFrame.Instructions->GetLabel(operand) - 1;
+				RecordBackEdge(target);
+				m_StackFrame.Caller = target - 1;
 				m_Stack.Reduce(sizeof(PointerObject));
 			}
-		} else if (type == GCPointerType) {
+			break;
+		}
+		case TypeTag::GCPointer: {
 			const GCPointerObject* value = reinterpret_cast<const GCPointerObject*>(typePtr);
 			if (T::Compare(value->Value)) {
-				m_StackFrame.Caller = m_StackFrame.Instructions->GetLabel(operand) - 1;
+				RecordBackEdge(target);
+				m_StackFrame.Caller = target - 1;
 				m_Stack.Reduce(sizeof(GCPointerObject));
 			}
-		} else if (type.IsStructure()) {
+			break;
+		}
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (type.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 }
@@ -84,6 +116,23 @@ struct n final {											\
 #undef CompareClass
 }
 
+namespace svm {
+	template<typename T>
+	SVM_NOINLINE_FOR_PROFILING bool Interpreter::CompareAndJump(std::uint64_t target) noexcept {
+		IntObject result;
+		if (!GuardCompare(result)) return false;
+
+		++m_StackFrame.Caller;
+		if (T::Compare(result.Value)) {
+			RecordBackEdge(target);
+			m_StackFrame.Caller = target - 1;
+		} else {
+			m_Stack.Push(result);
+		}
+		return true;
+	}
+}
+
 namespace svm {
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretJmp(std::uint32_t operand) noexcept {
 		if (operand >= m_StackFrame.Instructions->GetLabelCount()) {
@@ -91,7 +140,9 @@ namespace svm {
 			return;
 		}
 
-		m_StackFrame.Caller = m_StackFrame.Instructions->GetLabel(operand) - 1;
+		const std::uint64_t target = m_StackFrame.Instructions->GetLabel(operand);
+		RecordBackEdge(target);
+		m_StackFrame.Caller = target - 1;
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretJe(std::uint32_t operand) noexcept {
 		JumpCondition<EqualZero>(operand);
@@ -117,13 +168,18 @@ namespace svm {
 		if (operand >= functions.size()) {
 			OccurException(SVM_IEC_FUNCTION_OUTOFRANGE);
 			return;
-		} else if (!m_Stack.Push(m_StackFrame)) {
+		}
+
+		InterpretCallDirect(&functions[operand]);
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretCallDirect(const Function* function) {
+		if (!m_Stack.Push(m_StackFrame)) {
 			OccurException(SVM_IEC_STACK_OVERFLOW);
 			return;
 		}
 
 		m_StackFrame = { NoneType, m_Stack.GetUsedSize(), static_cast<std::uint32_t>(m_LocalVariables.size()) };
-		m_StackFrame.Function = &functions[operand];
+		m_StackFrame.Function = function;
 		m_StackFrame.Instructions = &m_StackFrame.Function->GetInstructions();
 
 		const std::uint16_t arity = m_StackFrame.Function->GetArity();
@@ -131,8 +187,9 @@ namespace svm {
 		for (std::uint16_t j = 0; j < arity; ++j) {
 			const Type* const typePtr = m_Stack.Get<Type>(stackOffset);
 			if (!typePtr) {
-				OccurException(SVM_IEC_STACK_EMPTY);
 				m_StackFrame = *m_Stack.Pop<StackFrame>();
+				m_LocalVariables.erase(m_LocalVariables.end() - j, m_LocalVariables.end());
+				OccurException(SVM_IEC_STACK_EMPTY);
 				return;
 			}
 
@@ -144,15 +201,39 @@ namespace svm {
 			} else if (type.IsValidType()) {
 				stackOffset -= type->Size;
 			} else {
-				OccurException(SVM_IEC_STACK_EMPTY);
 				m_StackFrame = *m_Stack.Pop<StackFrame>();
 				m_LocalVariables.erase(m_LocalVariables.end() - j - 1, m_LocalVariables.end());
+				OccurException(SVM_IEC_STACK_EMPTY);
 				return;
 			}
 		}
 
+		m_StackFrame.ArgumentSize = static_cast<std::uint32_t>(m_StackFrame.StackBegin - sizeof(m_StackFrame) - stackOffset);
 		m_StackFrame.Caller = static_cast<std::uint64_t>(-1);
 		++m_Depth;
+		RecordCall();
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretVerifiedCall(const Function* function, std::uint32_t argumentSize) {
+		if (!m_Stack.Push(m_StackFrame)) {
+			OccurException(SVM_IEC_STACK_OVERFLOW);
+			return;
+		}
+
+		m_StackFrame = { NoneType, m_Stack.GetUsedSize(), static_cast<std::uint32_t>(m_LocalVariables.size()), argumentSize };
+		m_StackFrame.Function = function;
+		m_StackFrame.Instructions = &function->GetInstructions();
+
+		// The verifier proved that every argument is a fundamental object
+		const std::uint16_t arity = function->GetArity();
+		std::size_t stackOffset = m_Stack.GetUsedSize() - sizeof(m_StackFrame);
+		for (std::uint16_t j = 0; j < arity; ++j) {
+			m_LocalVariables.push_back(stackOffset);
+			stackOffset -= sizeof(IntObject);
+		}
+
+		m_StackFrame.Caller = static_cast<std::uint64_t>(-1);
+		++m_Depth;
+		RecordCall();
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretRet() noexcept {
 		if (m_Depth == 0) {
@@ -188,16 +269,12 @@ namespace svm {
 
 		m_LocalVariables.erase(m_LocalVariables.begin() + m_StackFrame.VariableBegin, m_LocalVariables.end());
 
-		const std::uint16_t arity = m_StackFrame.Function->GetArity();
-		m_Stack.SetUsedSize(m_StackFrame.StackBegin);
-		m_StackFrame = *m_Stack.Pop<StackFrame>();
-
-		for (std::uint16_t j = 0; j < arity; ++j) {
-			const Type type = *m_Stack.GetTopType();
-			m_Stack.Reduce(type->Size);
-		}
+		const std::size_t stackEnd = m_StackFrame.StackBegin - sizeof(m_StackFrame) - m_StackFrame.ArgumentSize;
+		m_StackFrame = *m_Stack.Get<StackFrame>(m_StackFrame.StackBegin);
+		m_Stack.SetUsedSize(stackEnd);
 
 		--m_Depth;
+		m_CurrentTier = GetFunctionProfile().Tier;
 		if (result) {
 			std::size_t size = 0;
 			if (result->IsArray()) {
@@ -210,4 +287,108 @@ namespace svm {
 			std::memmove(m_Stack.GetTopType(), result, size);
 		}
 	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretTCall(std::uint32_t operand) {
+		const Functions& functions = m_ByteFile.GetFunctions();
+
+		if (operand >= functions.size()) {
+			OccurException(SVM_IEC_FUNCTION_OUTOFRANGE);
+			return;
+		}
+
+		InterpretTCallDirect(&functions[operand]);
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretTCallDirect(const Function* function) {
+		// The entry point has no stack frame to reuse
+		if (m_Depth == 0) {
+			InterpretCallDirect(function);
+			return;
+		} else if (function->HasResult() != m_StackFrame.Function->HasResult()) {
+			OccurException(SVM_IEC_FUNCTION_DIFFERENTRESULT);
+			return;
+		}
+
+		const std::uint16_t arity = function->GetArity();
+		const std::size_t usedSize = m_Stack.GetUsedSize();
+		std::size_t stackOffset = usedSize;
+		for (std::uint16_t j = 0; j < arity; ++j) {
+			const Type* const typePtr = m_Stack.Get<Type>(stackOffset);
+			if (!typePtr) {
+				m_LocalVariables.erase(m_LocalVariables.end() - j, m_LocalVariables.end());
+				OccurException(SVM_IEC_STACK_EMPTY);
+				return;
+			}
+
+			m_LocalVariables.push_back(stackOffset);
+
+			const Type type = *typePtr;
+			if (type.IsArray()) {
+				stackOffset -= CalcArraySize(reinterpret_cast<const ArrayObject*>(typePtr));
+			} else if (type.IsValidType()) {
+				stackOffset -= type->Size;
+			} else {
+				m_LocalVariables.erase(m_LocalVariables.end() - j - 1, m_LocalVariables.end());
+				OccurException(SVM_IEC_STACK_EMPTY);
+				return;
+			}
+		}
+
+		// The arguments replace the ones of the current function, and the stack frame of its caller follows them
+		const std::size_t argumentSize = usedSize - stackOffset;
+		const std::size_t stackEnd = m_StackFrame.StackBegin - sizeof(m_StackFrame) - m_StackFrame.ArgumentSize;
+		const std::size_t delta = usedSize - (stackEnd + argumentSize);
+		const StackFrame callerFrame = *m_Stack.Get<StackFrame>(m_StackFrame.StackBegin);
+		std::uint8_t* const arguments = m_Stack.Get<std::uint8_t>(usedSize);
+		std::memmove(arguments + delta, arguments, argumentSize);
+		m_Stack.SetUsedSize(stackEnd + argumentSize);
+		m_Stack.Push(callerFrame);
+
+		m_LocalVariables.erase(m_LocalVariables.begin() + m_StackFrame.VariableBegin, m_LocalVariables.end() - arity);
+		for (auto iter = m_LocalVariables.end() - arity; iter < m_LocalVariables.end(); ++iter) {
+			*iter -= delta;
+		}
+
+		m_StackFrame = { NoneType, m_Stack.GetUsedSize(), m_StackFrame.VariableBegin, static_cast<std::uint32_t>(argumentSize) };
+		m_StackFrame.Function = function;
+		m_StackFrame.Instructions = &function->GetInstructions();
+		m_StackFrame.Caller = static_cast<std::uint64_t>(-1);
+		RecordCall();
+	}
+
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretJeDirect(std::uint64_t target) noexcept {
+		JumpConditionDirect<EqualZero>(target);
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretJneDirect(std::uint64_t target) noexcept {
+		JumpConditionDirect<NotEqualZero>(target);
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretJaDirect(std::uint64_t target) noexcept {
+		JumpConditionDirect<EqualOne>(target);
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretJaeDirect(std::uint64_t target) noexcept {
+		JumpConditionDirect<NotEqualMinusOne>(target);
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretJbDirect(std::uint64_t target) noexcept {
+		JumpConditionDirect<EqualMinusOne>(target);
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretJbeDirect(std::uint64_t target) noexcept {
+		JumpConditionDirect<NotEqualOne>(target);
+	}
+
+	SVM_NOINLINE_FOR_PROFILING bool Interpreter::InterpretCmpJe(std::uint64_t target) noexcept {
+		return CompareAndJump<EqualZero>(target);
+	}
+	SVM_NOINLINE_FOR_PROFILING bool Interpreter::InterpretCmpJne(std::uint64_t target) noexcept {
+		return CompareAndJump<NotEqualZero>(target);
+	}
+	SVM_NOINLINE_FOR_PROFILING bool Interpreter::InterpretCmpJa(std::uint64_t target) noexcept {
+		return CompareAndJump<EqualOne>(target);
+	}
+	SVM_NOINLINE_FOR_PROFILING bool Interpreter::InterpretCmpJae(std::uint64_t target) noexcept {
+		return CompareAndJump<NotEqualMinusOne>(target);
+	}
+	SVM_NOINLINE_FOR_PROFILING bool Interpreter::InterpretCmpJb(std::uint64_t target) noexcept {
+		return CompareAndJump<EqualMinusOne>(target);
+	}
+	SVM_NOINLINE_FOR_PROFILING bool Interpreter::InterpretCmpJbe(std::uint64_t target) noexcept {
+		return CompareAndJump<NotEqualOne>(target);
+	}
 }
\ No newline at end of file
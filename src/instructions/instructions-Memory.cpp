@@ -214,22 +214,31 @@ namespace svm {
 		}
 
 		const Type rhsType = *rhsTypePtr;
-		if (rhsType == IntType) {
+		switch (rhsType.GetTag()) {
+		case TypeTag::Int:
 			DRefAndAssign<IntObject>(rhsTypePtr);
-		} else if (rhsType == LongType) {
+			break;
+		case TypeTag::Long:
 			DRefAndAssign<LongObject>(rhsTypePtr);
-		} else if (rhsType == DoubleType) {
+			break;
+		case TypeTag::Double:
 			DRefAndAssign<DoubleObject>(rhsTypePtr);
-		} else if (rhsType == PointerType) {
+			break;
+		case TypeTag::Pointer:
 			DRefAndAssign<PointerObject>(rhsTypePtr);
-		} else if (rhsType == GCPointerType) {
+			break;
+		case TypeTag::GCPointer:
 			DRefAndAssign<GCPointerObject>(rhsTypePtr);
-		} else if (rhsType.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			DRefAndAssign<StructureObject>(rhsTypePtr);
-		} else if (rhsType.IsArray()) {
+			break;
+		case TypeTag::Array:
 			DRefAndAssign<ArrayObject>(rhsTypePtr);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 }
@@ -373,11 +382,14 @@ namespace svm {
 
 		const Type indexType = *indexTypePtr;
 		std::uint64_t index = 0;
-		if (indexType == IntType) {
+		switch (indexType.GetTag()) {
+		case TypeTag::Int:
 			index = reinterpret_cast<IntObject*>(indexTypePtr)->Value;
-		} else if (indexType == LongType) {
+			break;
+		case TypeTag::Long:
 			index = reinterpret_cast<LongObject*>(indexTypePtr)->Value;
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_DIFFERENTTYPE);
 			return;
 		}
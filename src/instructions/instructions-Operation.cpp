@@ -60,6 +60,64 @@ namespace svm {
 			return static_cast<std::uint32_t>(-1);
 		}
 	}
+	template<typename T>
+	SVM_NOINLINE_FOR_PROFILING bool Interpreter::GuardTwoSameType(Type type, T*& lhs, T*& rhs) noexcept {
+		const std::size_t usedSize = m_Stack.GetUsedSize();
+		if (usedSize < sizeof(T) * 2 || IsLocalVariable() || IsLocalVariable(sizeof(T))) return false;
+
+		Type* const rhsTypePtr = m_Stack.Get<Type>(usedSize);
+		Type* const lhsTypePtr = m_Stack.Get<Type>(usedSize - sizeof(T));
+		if (*rhsTypePtr != type || *lhsTypePtr != type) return false;
+
+		lhs = reinterpret_cast<T*>(lhsTypePtr);
+		rhs = reinterpret_cast<T*>(rhsTypePtr);
+		return true;
+	}
+	SVM_NOINLINE_FOR_PROFILING bool Interpreter::GuardCompare(IntObject& result) noexcept {
+		const Type* const typePtr = m_Stack.GetTopType();
+		if (!typePtr) return false;
+
+		const Type type = *typePtr;
+		if (IntObject* lhs = nullptr, *rhs = nullptr; type == IntType && GuardTwoSameType(IntType, lhs, rhs)) {
+			result = CompareTwoSameType(lhs->Value, rhs->Value);
+			m_Stack.Reduce(sizeof(IntObject) * 2);
+		} else if (LongObject* lhs = nullptr, *rhs = nullptr; type == LongType && GuardTwoSameType(LongType, lhs, rhs)) {
+			result = CompareTwoSameType(lhs->Value, rhs->Value);
+			m_Stack.Reduce(sizeof(LongObject) * 2);
+		} else if (DoubleObject* lhs = nullptr, *rhs = nullptr; type == DoubleType && GuardTwoSameType(DoubleType, lhs, rhs)) {
+			result = CompareTwoSameType(lhs->Value, rhs->Value);
+			m_Stack.Reduce(sizeof(DoubleObject) * 2);
+		} else return false;
+
+		return true;
+	}
+	template<typename F>
+	SVM_NOINLINE_FOR_PROFILING bool Interpreter::LoadLoadOperationStore(const DecodedInstruction* inst, F operation) noexcept {
+		const std::size_t variableCount = m_LocalVariables.size();
+		const std::uint32_t lhsIndex = inst[0].Operand.Operand + m_StackFrame.VariableBegin;
+		const std::uint32_t rhsIndex = inst[1].Operand.Operand + m_StackFrame.VariableBegin;
+		const std::uint32_t resultIndex = inst[3].Operand.Operand + m_StackFrame.VariableBegin;
+		if (lhsIndex >= variableCount || rhsIndex >= variableCount || resultIndex >= variableCount) return false;
+
+		Type* const lhsTypePtr = m_Stack.Get<Type>(m_LocalVariables[lhsIndex]);
+		Type* const rhsTypePtr = m_Stack.Get<Type>(m_LocalVariables[rhsIndex]);
+		Type* const resultTypePtr = m_Stack.Get<Type>(m_LocalVariables[resultIndex]);
+
+		const Type type = *lhsTypePtr;
+		if (*rhsTypePtr != type || *resultTypePtr != type) return false;
+
+		// Two loads have to fit in the stack as they would do without fusing
+		if (type == IntType && m_Stack.GetFreeSize() >= sizeof(IntObject) * 2) {
+			reinterpret_cast<IntObject*>(resultTypePtr)->Value = operation(reinterpret_cast<IntObject*>(lhsTypePtr)->Value, reinterpret_cast<IntObject*>(rhsTypePtr)->Value);
+		} else if (type == LongType && m_Stack.GetFreeSize() >= sizeof(LongObject) * 2) {
+			reinterpret_cast<LongObject*>(resultTypePtr)->Value = operation(reinterpret_cast<LongObject*>(lhsTypePtr)->Value, reinterpret_cast<LongObject*>(rhsTypePtr)->Value);
+		} else if (type == DoubleType && m_Stack.GetFreeSize() >= sizeof(DoubleObject) * 2) {
+			reinterpret_cast<DoubleObject*>(resultTypePtr)->Value = operation(reinterpret_cast<DoubleObject*>(lhsTypePtr)->Value, reinterpret_cast<DoubleObject*>(rhsTypePtr)->Value);
+		} else return false;
+
+		m_StackFrame.Caller += 3;
+		return true;
+	}
 }
 
 namespace svm {
@@ -71,32 +129,44 @@ namespace svm {
 		}
 
 		const Type rhsType = *rhsTypePtr;
-		if (rhsType == IntType) {
+		switch (rhsType.GetTag()) {
+		case TypeTag::Int: {
 			IntObject* lhs = nullptr;
 			const IntObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value += rhs->Value;
-		} else if (rhsType == LongType) {
+			break;
+		}
+		case TypeTag::Long: {
 			LongObject* lhs = nullptr;
 			const LongObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value += rhs->Value;
-		} else if (rhsType == DoubleType) {
+			break;
+		}
+		case TypeTag::Double: {
 			DoubleObject* lhs = nullptr;
 			const DoubleObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value += rhs->Value;
-		} else if (rhsType == PointerType || rhsType == GCPointerType) {
+			break;
+		}
+		case TypeTag::Pointer:
+		case TypeTag::GCPointer:
 			OccurException(SVM_IEC_POINTER_INVALIDFORPOINTER);
-		} else if (rhsType.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (rhsType.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretSub() noexcept {
@@ -107,32 +177,44 @@ namespace svm {
 		}
 
 		const Type rhsType = *rhsTypePtr;
-		if (rhsType == IntType) {
+		switch (rhsType.GetTag()) {
+		case TypeTag::Int: {
 			IntObject* lhs = nullptr;
 			const IntObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value -= rhs->Value;
-		} else if (rhsType == LongType) {
+			break;
+		}
+		case TypeTag::Long: {
 			LongObject* lhs = nullptr;
 			const LongObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value -= rhs->Value;
-		} else if (rhsType == DoubleType) {
+			break;
+		}
+		case TypeTag::Double: {
 			DoubleObject* lhs = nullptr;
 			const DoubleObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value -= rhs->Value;
-		} else if (rhsType == PointerType || rhsType == GCPointerType) {
+			break;
+		}
+		case TypeTag::Pointer:
+		case TypeTag::GCPointer:
 			OccurException(SVM_IEC_POINTER_INVALIDFORPOINTER);
-		} else if (rhsType.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (rhsType.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretMul() noexcept {
@@ -143,32 +225,44 @@ namespace svm {
 		}
 
 		const Type rhsType = *rhsTypePtr;
-		if (rhsType == IntType) {
+		switch (rhsType.GetTag()) {
+		case TypeTag::Int: {
 			IntObject* lhs = nullptr;
 			const IntObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value *= rhs->Value;
-		} else if (rhsType == LongType) {
+			break;
+		}
+		case TypeTag::Long: {
 			LongObject* lhs = nullptr;
 			const LongObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value *= rhs->Value;
-		} else if (rhsType == DoubleType) {
+			break;
+		}
+		case TypeTag::Double: {
 			DoubleObject* lhs = nullptr;
 			const DoubleObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value *= rhs->Value;
-		} else if (rhsType == PointerType || rhsType == GCPointerType) {
+			break;
+		}
+		case TypeTag::Pointer:
+		case TypeTag::GCPointer:
 			OccurException(SVM_IEC_POINTER_INVALIDFORPOINTER);
-		} else if (rhsType.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (rhsType.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretIMul() noexcept {
@@ -179,32 +273,44 @@ namespace svm {
 		}
 
 		const Type rhsType = *rhsTypePtr;
-		if (rhsType == IntType) {
+		switch (rhsType.GetTag()) {
+		case TypeTag::Int: {
 			IntObject* lhs = nullptr;
 			const IntObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value = static_cast<std::int32_t>(lhs->Value) * static_cast<std::int32_t>(rhs->Value);
-		} else if (rhsType == LongType) {
+			break;
+		}
+		case TypeTag::Long: {
 			LongObject* lhs = nullptr;
 			const LongObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value = static_cast<std::int64_t>(lhs->Value) * static_cast<std::int64_t>(rhs->Value);
-		} else if (rhsType == DoubleType) {
+			break;
+		}
+		case TypeTag::Double: {
 			DoubleObject* lhs = nullptr;
 			const DoubleObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value *= rhs->Value;
-		} else if (rhsType == PointerType || rhsType == GCPointerType) {
+			break;
+		}
+		case TypeTag::Pointer:
+		case TypeTag::GCPointer:
 			OccurException(SVM_IEC_POINTER_INVALIDFORPOINTER);
-		} else if (rhsType.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (rhsType.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretDiv() noexcept {
@@ -215,7 +321,8 @@ namespace svm {
 		}
 
 		const Type rhsType = *rhsTypePtr;
-		if (rhsType == IntType) {
+		switch (rhsType.GetTag()) {
+		case TypeTag::Int: {
 			IntObject* lhs = nullptr;
 			const IntObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
@@ -225,7 +332,9 @@ namespace svm {
 			}
 
 			lhs->Value /= rhs->Value;
-		} else if (rhsType == LongType) {
+			break;
+		}
+		case TypeTag::Long: {
 			LongObject* lhs = nullptr;
 			const LongObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
@@ -235,7 +344,9 @@ namespace svm {
 			}
 
 			lhs->Value /= rhs->Value;
-		} else if (rhsType == DoubleType) {
+			break;
+		}
+		case TypeTag::Double: {
 			DoubleObject* lhs = nullptr;
 			const DoubleObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
@@ -245,14 +356,21 @@ namespace svm {
 			}
 
 			lhs->Value /= rhs->Value;
-		} else if (rhsType == PointerType || rhsType == GCPointerType) {
+			break;
+		}
+		case TypeTag::Pointer:
+		case TypeTag::GCPointer:
 			OccurException(SVM_IEC_POINTER_INVALIDFORPOINTER);
-		} else if (rhsType.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (rhsType.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretIDiv() noexcept {
@@ -263,7 +381,8 @@ namespace svm {
 		}
 
 		const Type rhsType = *rhsTypePtr;
-		if (rhsType == IntType) {
+		switch (rhsType.GetTag()) {
+		case TypeTag::Int: {
 			IntObject* lhs = nullptr;
 			const IntObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
@@ -273,7 +392,9 @@ namespace svm {
 			}
 
 			lhs->Value = static_cast<std::int32_t>(lhs->Value) / static_cast<std::int32_t>(rhs->Value);
-		} else if (rhsType == LongType) {
+			break;
+		}
+		case TypeTag::Long: {
 			LongObject* lhs = nullptr;
 			const LongObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
@@ -283,7 +404,9 @@ namespace svm {
 			}
 
 			lhs->Value = static_cast<std::int64_t>(lhs->Value) / static_cast<std::int64_t>(rhs->Value);
-		} else if (rhsType == DoubleType) {
+			break;
+		}
+		case TypeTag::Double: {
 			DoubleObject* lhs = nullptr;
 			const DoubleObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
@@ -293,14 +416,21 @@ namespace svm {
 			}
 
 			lhs->Value /= rhs->Value;
-		} else if (rhsType == PointerType || rhsType == GCPointerType) {
+			break;
+		}
+		case TypeTag::Pointer:
+		case TypeTag::GCPointer:
 			OccurException(SVM_IEC_POINTER_INVALIDFORPOINTER);
-		} else if (rhsType.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (rhsType.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretMod() noexcept {
@@ -311,7 +441,8 @@ namespace svm {
 		}
 
 		const Type rhsType = *rhsTypePtr;
-		if (rhsType == IntType) {
+		switch (rhsType.GetTag()) {
+		case TypeTag::Int: {
 			IntObject* lhs = nullptr;
 			const IntObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
@@ -321,7 +452,9 @@ namespace svm {
 			}
 
 			lhs->Value %= rhs->Value;
-		} else if (rhsType == LongType) {
+			break;
+		}
+		case TypeTag::Long: {
 			LongObject* lhs = nullptr;
 			const LongObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
@@ -331,7 +464,9 @@ namespace svm {
 			}
 
 			lhs->Value %= rhs->Value;
-		} else if (rhsType == DoubleType) {
+			break;
+		}
+		case TypeTag::Double: {
 			DoubleObject* lhs = nullptr;
 			const DoubleObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
@@ -341,14 +476,21 @@ namespace svm {
 			}
 
 			lhs->Value = std::fmod(lhs->Value, rhs->Value);
-		} else if (rhsType == PointerType || rhsType == GCPointerType) {
+			break;
+		}
+		case TypeTag::Pointer:
+		case TypeTag::GCPointer:
 			OccurException(SVM_IEC_POINTER_INVALIDFORPOINTER);
-		} else if (rhsType.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (rhsType.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretIMod() noexcept {
@@ -359,7 +501,8 @@ namespace svm {
 		}
 
 		const Type rhsType = *rhsTypePtr;
-		if (rhsType == IntType) {
+		switch (rhsType.GetTag()) {
+		case TypeTag::Int: {
 			IntObject* lhs = nullptr;
 			const IntObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
@@ -369,7 +512,9 @@ namespace svm {
 			}
 
 			lhs->Value = static_cast<std::int32_t>(lhs->Value) % static_cast<std::int32_t>(rhs->Value);
-		} else if (rhsType == LongType) {
+			break;
+		}
+		case TypeTag::Long: {
 			LongObject* lhs = nullptr;
 			const LongObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
@@ -379,7 +524,9 @@ namespace svm {
 			}
 
 			lhs->Value = static_cast<std::int64_t>(lhs->Value) % static_cast<std::int64_t>(rhs->Value);
-		} else if (rhsType == DoubleType) {
+			break;
+		}
+		case TypeTag::Double: {
 			DoubleObject* lhs = nullptr;
 			const DoubleObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
@@ -389,14 +536,21 @@ namespace svm {
 			}
 
 			lhs->Value = std::fmod(lhs->Value, rhs->Value);
-		} else if (rhsType == PointerType || rhsType == GCPointerType) {
+			break;
+		}
+		case TypeTag::Pointer:
+		case TypeTag::GCPointer:
 			OccurException(SVM_IEC_POINTER_INVALIDFORPOINTER);
-		} else if (rhsType.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (rhsType.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretNeg() noexcept {
@@ -412,23 +566,35 @@ namespace svm {
 		}
 
 		const Type type = *typePtr;
-		if (type == IntType) {
+		switch (type.GetTag()) {
+		case TypeTag::Int: {
 			IntObject& top = reinterpret_cast<IntObject&>(*typePtr);
 			top.Value = -static_cast<std::int32_t>(top.Value);
-		} else if (type == LongType) {
+			break;
+		}
+		case TypeTag::Long: {
 			LongObject& top = reinterpret_cast<LongObject&>(*typePtr);
 			top.Value = -static_cast<std::int64_t>(top.Value);
-		} else if (type == DoubleType) {
+			break;
+		}
+		case TypeTag::Double: {
 			DoubleObject& top = reinterpret_cast<DoubleObject&>(*typePtr);
 			top.Value = -top.Value;
-		} else if (type == PointerType || type == GCPointerType) {
+			break;
+		}
+		case TypeTag::Pointer:
+		case TypeTag::GCPointer:
 			OccurException(SVM_IEC_POINTER_INVALIDFORPOINTER);
-		} else if (type.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (type.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretIncDec(int delta) noexcept {
@@ -460,18 +626,26 @@ namespace svm {
 		}
 
 		const Type targetType = *targetTypePtr;
-		if (targetType == IntType) {
+		switch (targetType.GetTag()) {
+		case TypeTag::Int:
 			reinterpret_cast<IntObject*>(targetTypePtr)->Value += delta;
-		} else if (targetType == LongType) {
+			break;
+		case TypeTag::Long:
 			reinterpret_cast<LongObject*>(targetTypePtr)->Value += delta;
-		} else if (targetType == DoubleType) {
+			break;
+		case TypeTag::Double:
 			reinterpret_cast<DoubleObject*>(targetTypePtr)->Value += delta;
-		} else if (targetType == PointerType || targetType == GCPointerType) {
+			break;
+		case TypeTag::Pointer:
+		case TypeTag::GCPointer:
 			OccurException(SVM_IEC_POINTER_INVALIDFORPOINTER);
-		} else if (targetType.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 
 		m_Stack.Reduce(sizeof(PointerObject));
@@ -487,26 +661,37 @@ namespace svm {
 		}
 
 		const Type rhsType = *rhsTypePtr;
-		if (rhsType == IntType) {
+		switch (rhsType.GetTag()) {
+		case TypeTag::Int: {
 			IntObject* lhs = nullptr;
 			const IntObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value &= rhs->Value;
-		} else if (rhsType == LongType || rhsType == DoubleType) {
+			break;
+		}
+		case TypeTag::Long:
+		case TypeTag::Double: {
 			LongObject* lhs = nullptr;
 			const LongObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value &= rhs->Value;
-		} else if (rhsType == PointerType || rhsType == GCPointerType) {
+			break;
+		}
+		case TypeTag::Pointer:
+		case TypeTag::GCPointer:
 			OccurException(SVM_IEC_POINTER_INVALIDFORPOINTER);
-		} else if (rhsType.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (rhsType.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretOr() noexcept {
@@ -517,26 +702,37 @@ namespace svm {
 		}
 
 		const Type rhsType = *rhsTypePtr;
-		if (rhsType == IntType) {
+		switch (rhsType.GetTag()) {
+		case TypeTag::Int: {
 			IntObject* lhs = nullptr;
 			const IntObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value |= rhs->Value;
-		} else if (rhsType == LongType || rhsType == DoubleType) {
+			break;
+		}
+		case TypeTag::Long:
+		case TypeTag::Double: {
 			LongObject* lhs = nullptr;
 			const LongObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value |= rhs->Value;
-		} else if (rhsType == PointerType || rhsType == GCPointerType) {
+			break;
+		}
+		case TypeTag::Pointer:
+		case TypeTag::GCPointer:
 			OccurException(SVM_IEC_POINTER_INVALIDFORPOINTER);
-		} else if (rhsType.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (rhsType.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretXor() noexcept {
@@ -547,26 +743,37 @@ namespace svm {
 		}
 
 		const Type rhsType = *rhsTypePtr;
-		if (rhsType == IntType) {
+		switch (rhsType.GetTag()) {
+		case TypeTag::Int: {
 			IntObject* lhs = nullptr;
 			const IntObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value ^= rhs->Value;
-		} else if (rhsType == LongType || rhsType == DoubleType) {
+			break;
+		}
+		case TypeTag::Long:
+		case TypeTag::Double: {
 			LongObject* lhs = nullptr;
 			const LongObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value ^= rhs->Value;
-		} else if (rhsType == PointerType || rhsType == GCPointerType) {
+			break;
+		}
+		case TypeTag::Pointer:
+		case TypeTag::GCPointer:
 			OccurException(SVM_IEC_POINTER_INVALIDFORPOINTER);
-		} else if (rhsType.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (rhsType.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretNot() noexcept {
@@ -582,20 +789,31 @@ namespace svm {
 		}
 
 		const Type type = *typePtr;
-		if (type == IntType) {
+		switch (type.GetTag()) {
+		case TypeTag::Int: {
 			IntObject& top = reinterpret_cast<IntObject&>(*typePtr);
 			top.Value = ~top.Value;
-		} else if (type == LongType || type == DoubleType) {
+			break;
+		}
+		case TypeTag::Long:
+		case TypeTag::Double: {
 			LongObject& top = reinterpret_cast<LongObject&>(*typePtr);
 			top.Value = ~top.Value;
-		} else if (type == PointerType || type == GCPointerType) {
+			break;
+		}
+		case TypeTag::Pointer:
+		case TypeTag::GCPointer:
 			OccurException(SVM_IEC_POINTER_INVALIDFORPOINTER);
-		} else if (type.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (type.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretShl() noexcept {
@@ -606,26 +824,37 @@ namespace svm {
 		}
 
 		const Type rhsType = *rhsTypePtr;
-		if (rhsType == IntType) {
+		switch (rhsType.GetTag()) {
+		case TypeTag::Int: {
 			IntObject* lhs = nullptr;
 			const IntObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value <<= rhs->Value;
-		} else if (rhsType == LongType || rhsType == DoubleType) {
+			break;
+		}
+		case TypeTag::Long:
+		case TypeTag::Double: {
 			LongObject* lhs = nullptr;
 			const LongObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value <<= rhs->Value;
-		} else if (rhsType == PointerType || rhsType == GCPointerType) {
+			break;
+		}
+		case TypeTag::Pointer:
+		case TypeTag::GCPointer:
 			OccurException(SVM_IEC_POINTER_INVALIDFORPOINTER);
-		} else if (rhsType.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (rhsType.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretSal() noexcept {
@@ -639,26 +868,37 @@ namespace svm {
 		}
 
 		const Type rhsType = *rhsTypePtr;
-		if (rhsType == IntType) {
+		switch (rhsType.GetTag()) {
+		case TypeTag::Int: {
 			IntObject* lhs = nullptr;
 			const IntObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value >>= rhs->Value;
-		} else if (rhsType == LongType || rhsType == DoubleType) {
+			break;
+		}
+		case TypeTag::Long:
+		case TypeTag::Double: {
 			LongObject* lhs = nullptr;
 			const LongObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value >>= rhs->Value;
-		} else if (rhsType == PointerType || rhsType == GCPointerType) {
+			break;
+		}
+		case TypeTag::Pointer:
+		case TypeTag::GCPointer:
 			OccurException(SVM_IEC_POINTER_INVALIDFORPOINTER);
-		} else if (rhsType.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (rhsType.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretSar() noexcept {
@@ -669,26 +909,37 @@ namespace svm {
 		}
 
 		const Type rhsType = *rhsTypePtr;
-		if (rhsType == IntType) {
+		switch (rhsType.GetTag()) {
+		case TypeTag::Int: {
 			IntObject* lhs = nullptr;
 			const IntObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value = static_cast<std::int32_t>(lhs->Value) >> static_cast<std::int32_t>(rhs->Value);
-		} else if (rhsType == LongType || rhsType == DoubleType) {
+			break;
+		}
+		case TypeTag::Long:
+		case TypeTag::Double: {
 			LongObject* lhs = nullptr;
 			const LongObject* rhs = nullptr;
 			if (!PopTwoSameTypeAndPushOne(rhsTypePtr, lhs, rhs)) return;
 
 			lhs->Value = static_cast<std::int64_t>(lhs->Value) >> static_cast<std::int64_t>(rhs->Value);
-		} else if (rhsType == PointerType || rhsType == GCPointerType) {
+			break;
+		}
+		case TypeTag::Pointer:
+		case TypeTag::GCPointer:
 			OccurException(SVM_IEC_POINTER_INVALIDFORPOINTER);
-		} else if (rhsType.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (rhsType.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 }
@@ -702,28 +953,41 @@ namespace svm {
 		}
 
 		const Type rhsType = *rhsTypePtr;
-		if (rhsType == IntType) {
+		switch (rhsType.GetTag()) {
+		case TypeTag::Int: {
 			IntObject lhs, rhs;
 			if (!PopTwoSameType(rhsTypePtr, lhs, rhs)) return;
 			m_Stack.Push(CompareTwoSameType(lhs.Value, rhs.Value));
-		} else if (rhsType == LongType) {
+			break;
+		}
+		case TypeTag::Long: {
 			LongObject lhs, rhs;
 			if (!PopTwoSameType(rhsTypePtr, lhs, rhs)) return;
 			m_Stack.Push(CompareTwoSameType(lhs.Value, rhs.Value));
-		} else if (rhsType == DoubleType) {
+			break;
+		}
+		case TypeTag::Double: {
 			DoubleObject lhs, rhs;
 			if (!PopTwoSameType(rhsTypePtr, lhs, rhs)) return;
 			m_Stack.Push(CompareTwoSameType(lhs.Value, rhs.Value));
-		} else if (rhsType == PointerType || rhsType == GCPointerType) {
+			break;
+		}
+		case TypeTag::Pointer:
+		case TypeTag::GCPointer: {
 			PointerObject lhs, rhs;
 			if (!PopTwoSameType(rhsTypePtr, lhs, rhs)) return;
 			m_Stack.Push(CompareTwoSameType(lhs.Value, rhs.Value));
-		} else if (rhsType.IsStructure()) {
+			break;
+		}
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (rhsType.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretICmp() noexcept {
@@ -734,28 +998,266 @@ namespace svm {
 		}
 
 		const Type rhsType = *rhsTypePtr;
-		if (rhsType == IntType) {
+		switch (rhsType.GetTag()) {
+		case TypeTag::Int: {
 			IntObject lhs, rhs;
 			if (!PopTwoSameType(rhsTypePtr, lhs, rhs)) return;
 			m_Stack.Push(CompareTwoSameType<std::int32_t>(lhs.Value, rhs.Value));
-		} else if (rhsType == LongType) {
+			break;
+		}
+		case TypeTag::Long: {
 			LongObject lhs, rhs;
 			if (!PopTwoSameType(rhsTypePtr, lhs, rhs)) return;
 			m_Stack.Push(CompareTwoSameType<std::int64_t>(lhs.Value, rhs.Value));
-		} else if (rhsType == DoubleType) {
+			break;
+		}
+		case TypeTag::Double: {
 			DoubleObject lhs, rhs;
 			if (!PopTwoSameType(rhsTypePtr, lhs, rhs)) return;
 			m_Stack.Push(CompareTwoSameType(lhs.Value, rhs.Value));
-		} else if (rhsType == PointerType || rhsType == GCPointerType) {
+			break;
+		}
+		case TypeTag::Pointer:
+		case TypeTag::GCPointer: {
 			PointerObject lhs, rhs;
 			if (!PopTwoSameType(rhsTypePtr, lhs, rhs)) return;
 			m_Stack.Push(CompareTwoSameType(lhs.Value, rhs.Value));
-		} else if (rhsType.IsStructure()) {
+			break;
+		}
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (rhsType.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
+		}
+	}
+}
+
+namespace svm {
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretAddInt() noexcept {
+		IntObject* lhs = nullptr;
+		IntObject* rhs = nullptr;
+		if (!GuardTwoSameType(IntType, lhs, rhs)) {
+			InterpretAdd();
+			return;
+		}
+
+		lhs->Value += rhs->Value;
+		m_Stack.Reduce(sizeof(IntObject));
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretAddLong() noexcept {
+		LongObject* lhs = nullptr;
+		LongObject* rhs = nullptr;
+		if (!GuardTwoSameType(LongType, lhs, rhs)) {
+			InterpretAdd();
+			return;
+		}
+
+		lhs->Value += rhs->Value;
+		m_Stack.Reduce(sizeof(LongObject));
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretAddDouble() noexcept {
+		DoubleObject* lhs = nullptr;
+		DoubleObject* rhs = nullptr;
+		if (!GuardTwoSameType(DoubleType, lhs, rhs)) {
+			InterpretAdd();
+			return;
+		}
+
+		lhs->Value += rhs->Value;
+		m_Stack.Reduce(sizeof(DoubleObject));
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretSubInt() noexcept {
+		IntObject* lhs = nullptr;
+		IntObject* rhs = nullptr;
+		if (!GuardTwoSameType(IntType, lhs, rhs)) {
+			InterpretSub();
+			return;
+		}
+
+		lhs->Value -= rhs->Value;
+		m_Stack.Reduce(sizeof(IntObject));
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretSubLong() noexcept {
+		LongObject* lhs = nullptr;
+		LongObject* rhs = nullptr;
+		if (!GuardTwoSameType(LongType, lhs, rhs)) {
+			InterpretSub();
+			return;
+		}
+
+		lhs->Value -= rhs->Value;
+		m_Stack.Reduce(sizeof(LongObject));
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretSubDouble() noexcept {
+		DoubleObject* lhs = nullptr;
+		DoubleObject* rhs = nullptr;
+		if (!GuardTwoSameType(DoubleType, lhs, rhs)) {
+			InterpretSub();
+			return;
+		}
+
+		lhs->Value -= rhs->Value;
+		m_Stack.Reduce(sizeof(DoubleObject));
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretMulInt() noexcept {
+		IntObject* lhs = nullptr;
+		IntObject* rhs = nullptr;
+		if (!GuardTwoSameType(IntType, lhs, rhs)) {
+			InterpretMul();
+			return;
+		}
+
+		lhs->Value *= rhs->Value;
+		m_Stack.Reduce(sizeof(IntObject));
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretMulLong() noexcept {
+		LongObject* lhs = nullptr;
+		LongObject* rhs = nullptr;
+		if (!GuardTwoSameType(LongType, lhs, rhs)) {
+			InterpretMul();
+			return;
+		}
+
+		lhs->Value *= rhs->Value;
+		m_Stack.Reduce(sizeof(LongObject));
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretMulDouble() noexcept {
+		DoubleObject* lhs = nullptr;
+		DoubleObject* rhs = nullptr;
+		if (!GuardTwoSameType(DoubleType, lhs, rhs)) {
+			InterpretMul();
+			return;
+		}
+
+		lhs->Value *= rhs->Value;
+		m_Stack.Reduce(sizeof(DoubleObject));
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretDivInt() noexcept {
+		IntObject* lhs = nullptr;
+		IntObject* rhs = nullptr;
+		if (!GuardTwoSameType(IntType, lhs, rhs) || rhs->Value == 0) {
+			InterpretDiv();
+			return;
 		}
+
+		lhs->Value /= rhs->Value;
+		m_Stack.Reduce(sizeof(IntObject));
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretDivLong() noexcept {
+		LongObject* lhs = nullptr;
+		LongObject* rhs = nullptr;
+		if (!GuardTwoSameType(LongType, lhs, rhs) || rhs->Value == 0) {
+			InterpretDiv();
+			return;
+		}
+
+		lhs->Value /= rhs->Value;
+		m_Stack.Reduce(sizeof(LongObject));
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretDivDouble() noexcept {
+		DoubleObject* lhs = nullptr;
+		DoubleObject* rhs = nullptr;
+		if (!GuardTwoSameType(DoubleType, lhs, rhs) || rhs->Value == 0) {
+			InterpretDiv();
+			return;
+		}
+
+		lhs->Value /= rhs->Value;
+		m_Stack.Reduce(sizeof(DoubleObject));
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretCmpInt() noexcept {
+		IntObject* lhs = nullptr;
+		IntObject* rhs = nullptr;
+		if (!GuardTwoSameType(IntType, lhs, rhs)) {
+			InterpretCmp();
+			return;
+		}
+
+		const IntObject result = CompareTwoSameType(lhs->Value, rhs->Value);
+		m_Stack.Reduce(sizeof(IntObject) * 2);
+		m_Stack.Push(result);
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretCmpLong() noexcept {
+		LongObject* lhs = nullptr;
+		LongObject* rhs = nullptr;
+		if (!GuardTwoSameType(LongType, lhs, rhs)) {
+			InterpretCmp();
+			return;
+		}
+
+		const IntObject result = CompareTwoSameType(lhs->Value, rhs->Value);
+		m_Stack.Reduce(sizeof(LongObject) * 2);
+		m_Stack.Push(result);
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretCmpDouble() noexcept {
+		DoubleObject* lhs = nullptr;
+		DoubleObject* rhs = nullptr;
+		if (!GuardTwoSameType(DoubleType, lhs, rhs)) {
+			InterpretCmp();
+			return;
+		}
+
+		const IntObject result = CompareTwoSameType(lhs->Value, rhs->Value);
+		m_Stack.Reduce(sizeof(DoubleObject) * 2);
+		m_Stack.Push(result);
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretICmpInt() noexcept {
+		IntObject* lhs = nullptr;
+		IntObject* rhs = nullptr;
+		if (!GuardTwoSameType(IntType, lhs, rhs)) {
+			InterpretICmp();
+			return;
+		}
+
+		const IntObject result = CompareTwoSameType<std::int32_t>(lhs->Value, rhs->Value);
+		m_Stack.Reduce(sizeof(IntObject) * 2);
+		m_Stack.Push(result);
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretICmpLong() noexcept {
+		LongObject* lhs = nullptr;
+		LongObject* rhs = nullptr;
+		if (!GuardTwoSameType(LongType, lhs, rhs)) {
+			InterpretICmp();
+			return;
+		}
+
+		const IntObject result = CompareTwoSameType<std::int64_t>(lhs->Value, rhs->Value);
+		m_Stack.Reduce(sizeof(LongObject) * 2);
+		m_Stack.Push(result);
+	}
+}
+
+namespace svm {
+	SVM_NOINLINE_FOR_PROFILING bool Interpreter::InterpretLoadLoadAddStore(const DecodedInstruction* inst) noexcept {
+		return LoadLoadOperationStore(inst, [](auto lhs, auto rhs) {
+			return lhs + rhs;
+		});
+	}
+	SVM_NOINLINE_FOR_PROFILING bool Interpreter::InterpretLoadLoadSubStore(const DecodedInstruction* inst) noexcept {
+		return LoadLoadOperationStore(inst, [](auto lhs, auto rhs) {
+			return lhs - rhs;
+		});
+	}
+	SVM_NOINLINE_FOR_PROFILING bool Interpreter::InterpretLeaIncDec(std::uint32_t operand, int delta) noexcept {
+		operand += m_StackFrame.VariableBegin;
+		if (operand >= m_LocalVariables.size() || m_Stack.GetFreeSize() < sizeof(PointerObject)) return false;
+
+		Type* const typePtr = m_Stack.Get<Type>(m_LocalVariables[operand]);
+		const Type type = *typePtr;
+		if (type == IntType) {
+			reinterpret_cast<IntObject*>(typePtr)->Value += delta;
+		} else if (type == LongType) {
+			reinterpret_cast<LongObject*>(typePtr)->Value += delta;
+		} else if (type == DoubleType) {
+			reinterpret_cast<DoubleObject*>(typePtr)->Value += delta;
+		} else return false;
+
+		m_StackFrame.Caller += 1;
+		return true;
 	}
 }
\ No newline at end of file
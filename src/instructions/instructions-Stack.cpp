@@ -20,6 +20,8 @@ namespace svm {
 			return;
 		}
 
+		// Fields start from zero, the same as objects on the heap
+		std::memset(m_Stack.GetTopType(), 0, structure->Type.Size);
 		InitStructure(structures, structure, m_Stack.GetTopType());
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InitStructure(const Structures& structures, Structure structure, Type* type) noexcept {
@@ -88,18 +90,37 @@ namespace svm {
 
 		const Type constType = constantPool.GetConstantType(operand);
 		bool isSuccess = false;
-		if (constType == IntType) {
+		switch (constType.GetTag()) {
+		case TypeTag::Int:
 			isSuccess = m_Stack.Push(constantPool.GetConstant<IntObject>(operand));
-		} else if (constType == LongType) {
+			break;
+		case TypeTag::Long:
 			isSuccess = m_Stack.Push(constantPool.GetConstant<LongObject>(operand));
-		} else if (constType == DoubleType) {
+			break;
+		case TypeTag::Double:
 			isSuccess = m_Stack.Push(constantPool.GetConstant<DoubleObject>(operand));
+			break;
 		}
 
 		if (!isSuccess) {
 			OccurException(SVM_IEC_STACK_OVERFLOW);
 		}
 	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretPushInt(const IntObject* constant) noexcept {
+		if (!m_Stack.Push(*constant)) {
+			OccurException(SVM_IEC_STACK_OVERFLOW);
+		}
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretPushLong(const LongObject* constant) noexcept {
+		if (!m_Stack.Push(*constant)) {
+			OccurException(SVM_IEC_STACK_OVERFLOW);
+		}
+	}
+	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretPushDouble(const DoubleObject* constant) noexcept {
+		if (!m_Stack.Push(*constant)) {
+			OccurException(SVM_IEC_STACK_OVERFLOW);
+		}
+	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretPop() noexcept {
 		if (IsLocalVariable()) {
 			m_LocalVariables.erase(m_LocalVariables.end() - 1);
@@ -187,19 +208,26 @@ namespace svm {
 			return;
 		}
 
-		if (type == IntType) {
+		switch (type.GetTag()) {
+		case TypeTag::Int:
 			reinterpret_cast<IntObject&>(varType) = reinterpret_cast<const IntObject&>(*typePtr);
-		} else if (type == LongType) {
+			break;
+		case TypeTag::Long:
 			reinterpret_cast<LongObject&>(varType) = reinterpret_cast<const LongObject&>(*typePtr);
-		} else if (type == DoubleType) {
+			break;
+		case TypeTag::Double:
 			reinterpret_cast<DoubleObject&>(varType) = reinterpret_cast<const DoubleObject&>(*typePtr);
-		} else if (type == PointerType) {
+			break;
+		case TypeTag::Pointer:
 			reinterpret_cast<PointerObject&>(varType) = reinterpret_cast<const PointerObject&>(*typePtr);
-		} else if (type == GCPointerType) {
+			break;
+		case TypeTag::GCPointer:
 			reinterpret_cast<GCPointerObject&>(varType) = reinterpret_cast<const GCPointerObject&>(*typePtr);
-		} else if (type.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			CopyStructure(*typePtr, varType);
-		} else if (type.IsArray()) {
+			break;
+		case TypeTag::Array: {
 			const std::size_t size = CalcArraySize(reinterpret_cast<const ArrayObject*>(typePtr));
 
 			if (reinterpret_cast<ArrayObject&>(varType).Count != reinterpret_cast<const ArrayObject*>(typePtr)->Count) {
@@ -209,7 +237,8 @@ namespace svm {
 
 			std::memcpy(&varType, typePtr, size);
 			return;
-		} else {
+		}
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
 			return;
 		}
@@ -241,27 +270,37 @@ namespace svm {
 
 		const Type type = *typePtr;
 		bool isSuccess = false;
-		if (type == IntType) {
+		switch (type.GetTag()) {
+		case TypeTag::Int:
 			isSuccess = m_Stack.Push(reinterpret_cast<const IntObject&>(*typePtr));
-		} else if (type == LongType) {
+			break;
+		case TypeTag::Long:
 			isSuccess = m_Stack.Push(reinterpret_cast<const LongObject&>(*typePtr));
-		} else if (type == DoubleType) {
+			break;
+		case TypeTag::Double:
 			isSuccess = m_Stack.Push(reinterpret_cast<const DoubleObject&>(*typePtr));
-		} else if (type == PointerType) {
+			break;
+		case TypeTag::Pointer:
 			isSuccess = m_Stack.Push(reinterpret_cast<const PointerObject&>(*typePtr));
-		} else if (type == GCPointerType) {
+			break;
+		case TypeTag::GCPointer:
 			isSuccess = m_Stack.Push(reinterpret_cast<const GCPointerObject&>(*typePtr));
-		} else if (type.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			if (isSuccess = m_Stack.Expand(type->Size)) {
 				CopyStructure(type);
 			}
-		} else if (type.IsArray()) {
+			break;
+		case TypeTag::Array: {
 			const std::size_t size = CalcArraySize(reinterpret_cast<const ArrayObject*>(typePtr));
 			if (isSuccess = m_Stack.Expand(type->Size)) {
 				std::memcpy(m_Stack.GetTopType(), typePtr, size);
 			}
-		} else {
+			break;
+		}
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 
 		if (!isSuccess) {
@@ -276,27 +315,38 @@ namespace svm {
 		}
 
 		const Type firstType = *firstTypePtr;
-		if (firstType == IntType) {
+		switch (firstType.GetTag()) {
+		case TypeTag::Int: {
 			IntObject* second = nullptr;
 			if (!GetTwoSameType(firstType, second)) return;
 			std::iter_swap(reinterpret_cast<IntObject*>(firstTypePtr), second);
-		} else if (firstType == LongType) {
+			break;
+		}
+		case TypeTag::Long: {
 			LongObject* second = nullptr;
 			if (!GetTwoSameType(firstType, second)) return;
 			std::iter_swap(reinterpret_cast<LongObject*>(firstTypePtr), second);
-		} else if (firstType == DoubleType) {
+			break;
+		}
+		case TypeTag::Double: {
 			DoubleObject* second = nullptr;
 			if (!GetTwoSameType(firstType, second)) return;
 			std::iter_swap(reinterpret_cast<DoubleObject*>(firstTypePtr), second);
-		} else if (firstType == PointerType) {
+			break;
+		}
+		case TypeTag::Pointer: {
 			PointerObject* second = nullptr;
 			if (!GetTwoSameType(firstType, second)) return;
 			std::iter_swap(reinterpret_cast<PointerObject*>(firstTypePtr), second);
-		} else if (firstType == GCPointerType) {
+			break;
+		}
+		case TypeTag::GCPointer: {
 			GCPointerObject* second = nullptr;
 			if (!GetTwoSameType(firstType, second)) return;
 			std::iter_swap(reinterpret_cast<GCPointerObject*>(firstTypePtr), second);
-		} else if (firstType.IsStructure()) {
+			break;
+		}
+		case TypeTag::Structure:
 			if (IsLocalVariable() || IsLocalVariable(firstType->Size)) {
 				OccurException(SVM_IEC_STACK_EMPTY);
 				return;
@@ -308,7 +358,8 @@ namespace svm {
 			for (std::size_t i = sizeof(Type); i < firstType->Size; i += sizeof(void*)) {
 				std::iter_swap(m_Stack.Get<void*>(m_Stack.GetUsedSize() - i), m_Stack.Get<void*>(m_Stack.GetUsedSize() - firstType->Size - i));
 			}
-		} else if (firstType.IsArray()) {
+			break;
+		case TypeTag::Array: {
 			const std::size_t size = CalcArraySize(reinterpret_cast<ArrayObject*>(firstTypePtr));
 
 			if (IsLocalVariable() || IsLocalVariable(size)) {
@@ -325,8 +376,11 @@ namespace svm {
 			for (std::size_t i = sizeof(ArrayObject); i < size; i += sizeof(void*)) {
 				std::iter_swap(m_Stack.Get<void*>(m_Stack.GetUsedSize() - i), m_Stack.Get<void*>(m_Stack.GetUsedSize() - size - i));
 			}
-		} else {
+			break;
+		}
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 }
@@ -359,11 +413,14 @@ namespace svm {
 
 		const Type type = *typePtr;
 		info.CountSize = type->Size;
-		if (type == IntType) {
+		switch (type.GetTag()) {
+		case TypeTag::Int:
 			info.Count = reinterpret_cast<IntObject*>(typePtr)->Value;
-		} else if (type == LongType) {
+			break;
+		case TypeTag::Long:
 			info.Count = reinterpret_cast<LongObject*>(typePtr)->Value;
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_DIFFERENTTYPE);
 			return false;
 		}
@@ -19,22 +19,31 @@ namespace svm {
 		}
 
 		const Type type = *typePtr;
-		if (type == IntType) {
+		switch (type.GetTag()) {
+		case TypeTag::Int:
 			TypeCast<IntObject, IntObject>(typePtr);
-		} else if (type == LongType) {
+			break;
+		case TypeTag::Long:
 			TypeCast<IntObject, LongObject>(typePtr);
-		} else if (type == DoubleType) {
+			break;
+		case TypeTag::Double:
 			TypeCast<IntObject, DoubleObject>(typePtr);
-		} else if (type == PointerType) {
+			break;
+		case TypeTag::Pointer:
 			TypeCast<IntObject, PointerObject>(typePtr);
-		} else if (type == GCPointerType) {
+			break;
+		case TypeTag::GCPointer:
 			OccurException(SVM_IEC_POINTER_INVALIDFORPOINTER);
-		} else if (type.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (type.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretToL() noexcept {
@@ -50,22 +59,31 @@ namespace svm {
 		}
 
 		const Type type = *typePtr;
-		if (type == IntType) {
+		switch (type.GetTag()) {
+		case TypeTag::Int:
 			TypeCast<LongObject, IntObject>(typePtr);
-		} else if (type == LongType) {
+			break;
+		case TypeTag::Long:
 			TypeCast<LongObject, LongObject>(typePtr);
-		} else if (type == DoubleType) {
+			break;
+		case TypeTag::Double:
 			TypeCast<LongObject, DoubleObject>(typePtr);
-		} else if (type == PointerType) {
+			break;
+		case TypeTag::Pointer:
 			TypeCast<LongObject, PointerObject>(typePtr);
-		} else if (type == GCPointerType) {
+			break;
+		case TypeTag::GCPointer:
 			OccurException(SVM_IEC_POINTER_INVALIDFORPOINTER);
-		} else if (type.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (type.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretToD() noexcept {
@@ -81,22 +99,31 @@ namespace svm {
 		}
 
 		const Type type = *typePtr;
-		if (type == IntType) {
+		switch (type.GetTag()) {
+		case TypeTag::Int:
 			TypeCast<DoubleObject, IntObject>(typePtr);
-		} else if (type == LongType) {
+			break;
+		case TypeTag::Long:
 			TypeCast<DoubleObject, LongObject>(typePtr);
-		} else if (type == DoubleType) {
+			break;
+		case TypeTag::Double:
 			TypeCast<DoubleObject, DoubleObject>(typePtr);
-		} else if (type == PointerType) {
+			break;
+		case TypeTag::Pointer:
 			TypeCast<DoubleObject, PointerObject>(typePtr);
-		} else if (type == GCPointerType) {
+			break;
+		case TypeTag::GCPointer:
 			OccurException(SVM_IEC_POINTER_INVALIDFORPOINTER);
-		} else if (type.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (type.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 	SVM_NOINLINE_FOR_PROFILING void Interpreter::InterpretToP() noexcept {
@@ -112,22 +139,31 @@ namespace svm {
 		}
 
 		const Type type = *typePtr;
-		if (type == IntType) {
+		switch (type.GetTag()) {
+		case TypeTag::Int:
 			TypeCast<PointerObject, IntObject>(typePtr);
-		} else if (type == LongType) {
+			break;
+		case TypeTag::Long:
 			TypeCast<PointerObject, LongObject>(typePtr);
-		} else if (type == DoubleType) {
+			break;
+		case TypeTag::Double:
 			TypeCast<PointerObject, DoubleObject>(typePtr);
-		} else if (type == PointerType) {
+			break;
+		case TypeTag::Pointer:
 			TypeCast<PointerObject, PointerObject>(typePtr);
-		} else if (type == GCPointerType) {
+			break;
+		case TypeTag::GCPointer:
 			OccurException(SVM_IEC_POINTER_INVALIDFORPOINTER);
-		} else if (type.IsStructure()) {
+			break;
+		case TypeTag::Structure:
 			OccurException(SVM_IEC_STRUCTURE_INVALIDFORSTRUCTURE);
-		} else if (type.IsArray()) {
+			break;
+		case TypeTag::Array:
 			OccurException(SVM_IEC_ARRAY_INVALIDFORARRAY);
-		} else {
+			break;
+		default:
 			OccurException(SVM_IEC_STACK_EMPTY);
+			break;
 		}
 	}
 }
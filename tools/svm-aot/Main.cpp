@@ -0,0 +1,47 @@
+#include <svm/AotCompiler.hpp>
+#include <svm/Parser.hpp>
+#include <svm/Version.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+
+int main(int argc, char* argv[]) {
+	if (argc == 2 && std::string_view(argv[1]) == "--version") {
+		std::cout << "svm-aot (ShitVM " << SVM_VER_STRING << ")\n"
+				  << "(C) 2020. kmc7468 All rights reserved.\n";
+		return EXIT_SUCCESS;
+	} else if (argc != 3) {
+		std::cout << "Usage: ./svm-aot <Input> <Output>\n";
+		return EXIT_FAILURE;
+	}
+
+	const auto start = std::chrono::system_clock::now();
+
+	try {
+		svm::Parser parser;
+		parser.Load(argv[1]);
+		parser.Parse();
+
+		std::ofstream stream(argv[2]);
+		if (!stream) throw std::runtime_error("Failed to open the file.");
+
+		svm::CompileAot(parser.GetResult(), stream);
+		if (!stream.flush()) throw std::runtime_error("Failed to write the file.");
+	} catch (const std::exception& e) {
+		std::cout << "Occured exception!\n"
+				  << "Message: \"" << e.what() << "\"\n";
+		return EXIT_FAILURE;
+	}
+
+	const auto end = std::chrono::system_clock::now();
+	const std::chrono::duration<double> compiling = end - start;
+
+	std::cout << "Compiled in " << std::fixed << std::setprecision(6) << compiling.count() << "s!\n";
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include <svm/Optimizer.hpp>
+#include <svm/Parser.hpp>
+#include <svm/Version.hpp>
+#include <svm/Writer.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+
+int main(int argc, char* argv[]) {
+	if (argc == 2 && std::string_view(argv[1]) == "--version") {
+		std::cout << "svm-opt (ShitVM " << SVM_VER_STRING << ")\n"
+				  << "(C) 2020. kmc7468 All rights reserved.\n";
+		return EXIT_SUCCESS;
+	} else if (argc != 3) {
+		std::cout << "Usage: ./svm-opt <Input> <Output>\n";
+		return EXIT_FAILURE;
+	}
+
+	const auto start = std::chrono::system_clock::now();
+
+	try {
+		svm::Parser parser;
+		parser.Load(argv[1]);
+		parser.Parse();
+
+		svm::ByteFile byteFile = parser.GetResult();
+		svm::OptimizeByteFile(byteFile);
+
+		svm::Writer writer;
+		writer.Write(byteFile);
+		writer.Save(argv[2]);
+	} catch (const std::exception& e) {
+		std::cout << "Occured exception!\n"
+				  << "Message: \"" << e.what() << "\"\n";
+		return EXIT_FAILURE;
+	}
+
+	const auto end = std::chrono::system_clock::now();
+	const std::chrono::duration<double> optimizing = end - start;
+
+	std::cout << "Optimized in " << std::fixed << std::setprecision(6) << optimizing.count() << "s!\n";
+	return EXIT_SUCCESS;
+}
\ No newline at end of file